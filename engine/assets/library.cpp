@@ -1,5 +1,6 @@
 #include "engine/assets/library.h"
 
+#include "engine/engine.h"
 #include "engine/engine_utils.h"
 #include "engine/fileio/file.h"
 #include "engine/graphics/vulkan.h"
@@ -8,6 +9,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <utility>
 
@@ -26,30 +28,27 @@ auto ENGINE_NS::asset::BytecodeShader::compile(VulkanDevice& device) -> std::opt
 }
 
 auto ENGINE_NS::asset::BytecodeShader::load_from_file(const std::filesystem::path& path) -> BytecodeShader {
-    auto file_result = fileio::File::open(path, fileio::OpenMode::BINARY, fileio::IoMode::READ);
+    auto file_result = Engine::instance().files.open(path);
     if (!file_result) {
         crash(ErrorCode::CANNOT_READ_FILE, __LINE__, __func__, __FILE__, file_result.error().reason);
     }
-    auto file            = std::move(file_result.value());
-    std::uint64_t length = 0;
-    if (auto err = file.length(); !err) {
-        crash(ErrorCode::CANNOT_READ_FILE, __LINE__, __func__, __FILE__, file_result.error().reason);
-    } else {
-        length = err.value();
-    }
-    std::vector<std::uint32_t> spirv(length / sizeof(std::uint32_t));
-    if (auto err = file.read_into(spirv); !err) {
-        crash(ErrorCode::CANNOT_READ_FILE, __LINE__, __func__, __FILE__, file_result.error().reason);
+    auto file = std::make_shared<const fileio::VirtualFile>(std::move(file_result.value()));
+    if (file->size() % sizeof(std::uint32_t) != 0) {
+        crash(ErrorCode::CANNOT_READ_FILE, __LINE__, __func__, __FILE__, "SPIR-V length is not a whole number of words");
     }
 
     ShaderMetadata metadata{};
-    metadata.file_info = file.metadata;
+    metadata.file_info = file->metadata;
+    if (!file->from_archive()) {
+        // Failing to watch only costs hot reload for this shader, so the load goes ahead regardless
+        [[maybe_unused]] auto watched = Engine::instance().file_watcher.track(*metadata.file_info);
+    }
 
-    return BytecodeShader(std::move(spirv), metadata);
+    return BytecodeShader(std::move(file), metadata);
 }
 
-ENGINE_NS::asset::BytecodeShader::BytecodeShader(std::vector<std::uint32_t>&& spirv, ShaderMetadata metadata) :
-    metadata_(std::move(metadata)), spirv_(std::move(spirv)) {
+ENGINE_NS::asset::BytecodeShader::BytecodeShader(std::shared_ptr<const fileio::VirtualFile> file, ShaderMetadata metadata) :
+    metadata_(std::move(metadata)), file_(std::move(file)), spirv_(file_->view<std::uint32_t>()) {
 }
 
 ENGINE_NS::asset::CompiledShader::CompiledShader(const CompiledShader& other) : metadata_(other.metadata_), shader_(other.shader_) {
@@ -1,10 +1,64 @@
 #include "engine/bitset.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
 using namespace ::ENGINE_NS;
 
-Bitset::Bitset(size_t bitcount) : m_set(Bitset::bits_to_representation_count(bitcount)), m_bitcount(bitcount) {
+Bitset::Bitset(size_t bitcount) : m_word_count(Bitset::bits_to_representation_count(bitcount)), m_bitcount(bitcount) {
+    if (!this->is_inline()) {
+        m_heap.resize(m_word_count);
+    }
+}
+
+Bitset::Bitset(const Bitset& other) :
+    m_inline(other.m_inline),
+    m_heap(other.m_heap),
+    m_word_count(other.m_word_count),
+    m_bitcount(other.m_bitcount),
+    hash_(other.hash_.load(std::memory_order_relaxed)) {
+}
+
+Bitset::Bitset(Bitset&& other) noexcept :
+    m_inline(other.m_inline),
+    m_heap(std::move(other.m_heap)),
+    m_word_count(other.m_word_count),
+    m_bitcount(other.m_bitcount),
+    hash_(other.hash_.load(std::memory_order_relaxed)) {
+    other.m_inline.fill(0);
+    other.m_heap.clear();
+    other.m_word_count = 0;
+    other.m_bitcount   = 0;
+    other._invalidate_hash();
+}
+
+auto Bitset::operator=(const Bitset& rhs) -> Bitset& {
+    if (&rhs != this) {
+        m_inline     = rhs.m_inline;
+        m_heap       = rhs.m_heap;
+        m_word_count = rhs.m_word_count;
+        m_bitcount   = rhs.m_bitcount;
+        hash_        = rhs.hash_.load(std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+auto Bitset::operator=(Bitset&& rhs) noexcept -> Bitset& {
+    if (&rhs != this) {
+        m_inline     = rhs.m_inline;
+        m_heap       = std::move(rhs.m_heap);
+        m_word_count = rhs.m_word_count;
+        m_bitcount   = rhs.m_bitcount;
+        hash_        = rhs.hash_.load(std::memory_order_relaxed);
+
+        rhs.m_inline.fill(0);
+        rhs.m_heap.clear();
+        rhs.m_word_count = 0;
+        rhs.m_bitcount   = 0;
+        rhs._invalidate_hash();
+    }
+    return *this;
 }
 
 auto Bitset::operator|(const Bitset& rhs) const -> Bitset {
@@ -52,13 +106,18 @@ auto Bitset::bit_or(const Bitset& rhs) const -> Bitset {
     auto& smaller = (this->size() <= rhs.size()) ? *this : rhs;
     auto& bigger  = (this->size() > rhs.size()) ? *this : rhs;
 
-    auto combined = bigger;
-    for (std::size_t idx = 0; idx < smaller.m_set.size(); idx++) {
-        assert(combined.m_set.size() > idx);
-        assert(smaller.m_set.size() > idx);
-        combined.m_set[idx] |= smaller.m_set[idx];
+    auto combined       = bigger;
+    auto combined_words = combined._words();
+    auto smaller_words  = smaller._words();
+    if (smaller_words.size() >= AVX2_MIN_WORDS && Bitset::_has_avx2()) {
+        Bitset::_or_avx2(combined_words, smaller_words);
+    } else {
+        for (std::size_t idx = 0; idx < smaller_words.size(); idx++) {
+            assert(combined_words.size() > idx);
+            combined_words[idx] |= smaller_words[idx];
+        }
     }
-    combined.hash_ = combined.hash_ ^ ~(combined.hash_ | ~smaller.hash_);
+    combined._invalidate_hash();
 
     return combined;
 }
@@ -67,17 +126,21 @@ auto Bitset::bit_and(const Bitset& rhs) const -> Bitset {
     auto& smaller = (this->size() <= rhs.size()) ? *this : rhs;
     auto& bigger  = (this->size() > rhs.size()) ? *this : rhs;
 
-    auto combined = bigger;
-    for (std::size_t idx = 0; idx < smaller.m_set.size(); idx++) {
-        assert(combined.m_set.size() > idx);
-        assert(smaller.m_set.size() > idx);
-        combined.m_set[idx] &= smaller.m_set[idx];
+    auto combined       = bigger;
+    auto combined_words = combined._words();
+    auto smaller_words  = smaller._words();
+    if (smaller_words.size() >= AVX2_MIN_WORDS && Bitset::_has_avx2()) {
+        Bitset::_and_avx2(combined_words, smaller_words);
+    } else {
+        for (std::size_t idx = 0; idx < smaller_words.size(); idx++) {
+            assert(combined_words.size() > idx);
+            combined_words[idx] &= smaller_words[idx];
+        }
     }
-    for (auto idx = smaller.m_set.size(); idx < combined.m_set.size(); idx++) {
-        assert(combined.m_set.size() > idx);
-        combined.m_set[idx] = 0;
+    for (auto idx = smaller_words.size(); idx < combined_words.size(); idx++) {
+        combined_words[idx] = 0;
     }
-    combined.hash_ = combined.hash_ ^ ~(combined.hash_ & ~smaller.hash_);
+    combined._invalidate_hash();
 
     return combined;
 }
@@ -86,13 +149,18 @@ auto Bitset::bit_xor(const Bitset& rhs) const -> Bitset {
     auto& smaller = (this->size() <= rhs.size()) ? *this : rhs;
     auto& bigger  = (this->size() > rhs.size()) ? *this : rhs;
 
-    auto combined = bigger;
-    for (std::size_t idx = 0; idx < smaller.m_set.size(); idx++) {
-        assert(combined.m_set.size() > idx);
-        assert(smaller.m_set.size() > idx);
-        combined.m_set[idx] ^= smaller.m_set[idx];
+    auto combined       = bigger;
+    auto combined_words = combined._words();
+    auto smaller_words  = smaller._words();
+    if (smaller_words.size() >= AVX2_MIN_WORDS && Bitset::_has_avx2()) {
+        Bitset::_xor_avx2(combined_words, smaller_words);
+    } else {
+        for (std::size_t idx = 0; idx < smaller_words.size(); idx++) {
+            assert(combined_words.size() > idx);
+            combined_words[idx] ^= smaller_words[idx];
+        }
     }
-    combined.hash_ = combined.hash_ ^ ~(combined.hash_ ^ ~smaller.hash_);
+    combined._invalidate_hash();
 
     return combined;
 }
@@ -102,17 +170,7 @@ auto Bitset::bit_equals(const Bitset& rhs) const -> bool {
         return false;
     }
 
-    for (std::size_t idx = 0; idx < this->m_set.size(); idx++) {
-        assert(this->m_set.size() > idx);
-        assert(rhs.m_set.size() > idx);
-
-        auto lhs_bits = this->m_set[idx];
-        auto rhs_bits = rhs.m_set[idx];
-        if (lhs_bits != rhs_bits) {
-            return false;
-        }
-    }
-    return true;
+    return std::ranges::equal(this->_words(), rhs._words());
 }
 
 auto Bitset::get(size_t idx) const -> std::uint8_t {
@@ -130,11 +188,10 @@ auto Bitset::flip(size_t idx) -> void {
     if (idx >= this->size()) {
         this->extend(idx - this->size() + 1);
     }
-    hash_ = hash_ ^ idx;
+    this->_invalidate_hash();
 
     auto& set = this->_get_bitset_at_index(idx);
     idx       = idx % (8 * sizeof(Bitset::UnderlyingBitRepresentation));
-    hash_     = hash_ ^ (static_cast<std::uint64_t>(hash_) << idx);
 
     set = set ^ (static_cast<std::uint64_t>(1) << idx);
 }
@@ -143,11 +200,10 @@ auto Bitset::set(size_t idx) -> void {
     if (idx >= this->size()) {
         this->extend(idx - this->size() + 1);
     }
-    hash_ = hash_ ^ idx;
+    this->_invalidate_hash();
 
     auto& set = this->_get_bitset_at_index(idx);
     idx       = idx % (8 * sizeof(Bitset::UnderlyingBitRepresentation));
-    hash_     = hash_ | (static_cast<std::uint64_t>(1) << idx);
 
     set = set | (static_cast<std::uint64_t>(1) << idx);
 }
@@ -156,13 +212,12 @@ auto Bitset::set_to(size_t idx, std::uint8_t bit) -> void {
     if (idx >= this->size()) {
         this->extend(idx - this->size() + 1);
     }
-    hash_ = hash_ ^ idx;
+    this->_invalidate_hash();
 
     auto& set = this->_get_bitset_at_index(idx);
     idx       = idx % (8 * sizeof(Bitset::UnderlyingBitRepresentation));
-    hash_     = hash_ ^ (static_cast<std::uint64_t>(1) << idx);
 
-    set = set & ~(1 << idx);
+    set = set & ~(static_cast<std::uint64_t>(1) << idx);
     set = set | (static_cast<std::uint64_t>(bit) << idx);
 }
 
@@ -170,11 +225,10 @@ auto Bitset::clear(size_t idx) -> void {
     if (idx >= this->size()) {
         this->extend(idx - this->size() + 1);
     }
-    hash_ = hash_ ^ idx;
+    this->_invalidate_hash();
 
     auto& set = this->_get_bitset_at_index(idx);
     idx       = idx % (8 * sizeof(Bitset::UnderlyingBitRepresentation));
-    hash_     = hash_ & (static_cast<std::uint64_t>(1) << idx);
 
     set = set & ~(static_cast<std::uint64_t>(1) << idx);
 }
@@ -184,31 +238,22 @@ auto Bitset::size() const -> size_t {
 }
 
 auto Bitset::is_subset_of(const Bitset& superset) const -> bool {
-    // If we are bigger than the superset, but all of the extra bits are 0, then we can say we are still a subset
-    if (this->size() > superset.size()) {
-        auto bits_in_chunk       = sizeof(Bitset::UnderlyingBitRepresentation) * 8;
-        auto extra_bits_in_chunk = bits_in_chunk - (superset.size() % bits_in_chunk);
-        for (auto idx = superset.size(); idx < extra_bits_in_chunk; idx++) {
-            if (superset[idx] != 0) {
-                return false;
-            }
-        }
-        for (auto idx = superset.m_set.size(); idx < this->m_set.size(); idx++) {
-            assert(this->m_set.size() > idx);
-            if (this->m_set[idx] != 0) {
-                return false;
-            }
+    auto words          = this->_words();
+    auto superset_words = superset._words();
+    auto common         = std::min(words.size(), superset_words.size());
+
+    // If we are bigger than the superset, but all of the extra words are 0, then we can say we are still a subset
+    for (auto idx = common; idx < words.size(); idx++) {
+        if (words[idx] != 0) {
+            return false;
         }
     }
 
-    for (std::size_t idx = 0; idx < std::min(this->m_set.size(), superset.m_set.size()); idx++) {
-        assert(this->m_set.size() > idx);
-        assert(superset.m_set.size() > idx);
-
-        auto lhs_bits      = this->m_set[idx];
-        auto superset_bits = superset.m_set[idx];
-
-        if (lhs_bits != (lhs_bits & superset_bits)) {
+    if (common >= AVX2_MIN_WORDS && Bitset::_has_avx2()) {
+        return Bitset::_is_subset_avx2(words.first(common), superset_words.first(common));
+    }
+    for (std::size_t idx = 0; idx < common; idx++) {
+        if ((words[idx] & ~superset_words[idx]) != 0) {
             return false;
         }
     }
@@ -217,42 +262,106 @@ auto Bitset::is_subset_of(const Bitset& superset) const -> bool {
 
 auto Bitset::extend(size_t bitcount) -> void {
     auto new_size_count = Bitset::bits_to_representation_count(this->m_bitcount + bitcount);
-    if (new_size_count > this->m_set.size()) {
-        this->m_set.reserve(new_size_count);
-
-        auto pushes_needed = new_size_count - this->m_set.size();
-        for (std::size_t idx = 0; idx < pushes_needed; idx++) {
-            this->m_set.emplace_back(0);
+    if (new_size_count > m_word_count) {
+        if (new_size_count > INLINE_WORDS) {
+            // Spill the inline words to the heap the first time we outgrow them
+            if (this->is_inline()) {
+                m_heap.reserve(new_size_count);
+                m_heap.assign(m_inline.begin(), m_inline.begin() + m_word_count);
+                m_inline.fill(0);
+            }
+            m_heap.resize(new_size_count, 0);
         }
+        m_word_count = new_size_count;
     }
     m_bitcount += bitcount;
 }
 
-ENGINE_API auto ENGINE_NS::Bitset::set_bits() const -> std::vector<size_t> {
-    auto bits  = std::vector<size_t>{};
-    size_t idx = 0;
-    for (auto bitset : this->m_set) {
-        for (size_t i = 0; i < sizeof(UnderlyingBitRepresentation) * 8; idx++, i++) {
-            if (((bitset >> i) & 1) == 1) {
-                bits.push_back(idx);
-            }
+auto Bitset::set_bits() const -> std::vector<size_t> {
+    auto bits = std::vector<size_t>{};
+    bits.reserve(this->count());
+    this->for_each_set_bit([&bits](size_t idx) { bits.push_back(idx); });
+    return bits;
+}
+
+auto Bitset::hash() const -> std::uint64_t {
+    auto cached = hash_.load(std::memory_order_relaxed);
+    if (cached != HASH_DIRTY) {
+        return cached;
+    }
+
+    // Trailing zero words are skipped so that the size of the set does not affect the hash
+    auto words = this->_words();
+    auto used  = words.size();
+    while (used > 0 && words[used - 1] == 0) {
+        used -= 1;
+    }
+
+    auto hash_mix = [](std::uint64_t value) -> std::uint64_t {
+        // Multiply-xorshift finaliser; every input bit affects every output bit
+        value ^= value >> 32;
+        value *= 0xd6e8feb86659fd93ull;
+        value ^= value >> 32;
+        value *= 0xd6e8feb86659fd93ull;
+        value ^= value >> 32;
+        return value;
+    };
+
+    std::uint64_t hash = 0x9e3779b97f4a7c15ull ^ used;
+    for (std::size_t idx = 0; idx < used; idx++) {
+        hash = hash_mix(hash ^ words[idx]) + idx;
+    }
+    hash = hash_mix(hash);
+    if (hash == HASH_DIRTY) {
+        hash = 1;
+    }
+
+    hash_.store(hash, std::memory_order_relaxed);
+    return hash;
+}
+
+auto Bitset::count() const -> size_t {
+    auto words = this->_words();
+    if (words.size() >= AVX2_MIN_WORDS && Bitset::_has_avx2()) {
+        return Bitset::_count_avx2(words);
+    }
+    size_t count = 0;
+    for (auto word : words) {
+        count += static_cast<size_t>(std::popcount(word));
+    }
+    return count;
+}
+
+auto Bitset::find_first() const -> std::optional<size_t> {
+    auto words = this->_words();
+    for (size_t idx = 0; idx < words.size(); idx++) {
+        if (words[idx] != 0) {
+            return idx * sizeof(UnderlyingBitRepresentation) * 8 + static_cast<size_t>(std::countr_zero(words[idx]));
         }
     }
-    return bits;
+    return std::nullopt;
+}
+
+auto Bitset::any() const -> bool {
+    return std::ranges::any_of(this->_words(), [](auto word) { return word != 0; });
+}
+
+auto Bitset::none() const -> bool {
+    return !this->any();
 }
 
 auto Bitset::_get_bitset_at_index(std::size_t idx) -> std::uint64_t& {
     auto idx_bytes = idx / 8;
     auto position  = idx_bytes / sizeof(Bitset::UnderlyingBitRepresentation);
 
-    assert(this->m_set.size() > position);
-    return this->m_set[position];
+    assert(m_word_count > position);
+    return this->_words()[position];
 }
 
 auto Bitset::_get_bitset_at_index(std::size_t idx) const -> std::uint64_t {
     auto idx_bytes = idx / 8;
     auto position  = idx_bytes / sizeof(Bitset::UnderlyingBitRepresentation);
 
-    assert(this->m_set.size() > position);
-    return this->m_set[position];
+    assert(m_word_count > position);
+    return this->_words()[position];
 }
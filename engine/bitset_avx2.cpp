@@ -0,0 +1,195 @@
+#include "engine/bitset.h"
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+/*
+    Only the kernels below are compiled for AVX2, through a per-function target attribute, never the whole file. A
+    file-wide -mavx2 would also build this file's copies of inline std templates (std::popcount, span accessors) for
+    AVX2, and the linker is free to keep those copies for the scalar paths in bitset.cpp too. MSVC needs no attribute to
+    emit AVX2 intrinsics. Callers must check Bitset::_has_avx2() first
+*/
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #ifdef _WIN32
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define AVX2_TARGET
+    #else
+        #define AVX2_TARGET __attribute__((target("avx2")))
+    #endif
+#endif
+
+using namespace ::ENGINE_NS;
+
+#if defined(__x86_64__) || defined(_M_X64)
+namespace {
+    auto xgetbv0() -> std::uint64_t {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+    #else
+        // Spelled out rather than _xgetbv, which GCC and Clang (clang-cl included) only allow with the xsave target
+        std::uint32_t eax = 0;
+        std::uint32_t edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<std::uint64_t>(edx) << 32) | eax;
+    #endif
+    }
+
+    auto detect_avx2() -> bool {
+        int info[4] = {};
+    #ifdef _WIN32
+        __cpuidex(info, 1, 0);
+    #else
+        __cpuid_count(1, 0, info[0], info[1], info[2], info[3]);
+    #endif
+        bool has_osxsave = (info[2] & (1 << 27)) != 0;
+        if (!has_osxsave) {
+            return false;
+        }
+        // The OS must save the upper halves of the YMM registers on context switch
+        if ((xgetbv0() & 0x6) != 0x6) {
+            return false;
+        }
+
+    #ifdef _WIN32
+        __cpuidex(info, 7, 0);
+    #else
+        __cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+    #endif
+        return (info[1] & (1 << 5)) != 0;
+    }
+
+    constexpr std::size_t WORDS_PER_VECTOR = sizeof(__m256i) / sizeof(Bitset::UnderlyingBitRepresentation);
+
+    AVX2_TARGET auto load(const Bitset::UnderlyingBitRepresentation* ptr) -> __m256i {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+
+    AVX2_TARGET auto store(Bitset::UnderlyingBitRepresentation* ptr, __m256i value) -> void {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), value);
+    }
+
+    // Named functions rather than lambdas, whose call operators would not inherit the target attribute
+    AVX2_TARGET auto or_vector(__m256i a, __m256i b) -> __m256i {
+        return _mm256_or_si256(a, b);
+    }
+
+    AVX2_TARGET auto and_vector(__m256i a, __m256i b) -> __m256i {
+        return _mm256_and_si256(a, b);
+    }
+
+    AVX2_TARGET auto xor_vector(__m256i a, __m256i b) -> __m256i {
+        return _mm256_xor_si256(a, b);
+    }
+
+    template <auto VectorOp, typename TScalarOp>
+    AVX2_TARGET auto apply(std::span<Bitset::UnderlyingBitRepresentation> lhs,
+                           std::span<const Bitset::UnderlyingBitRepresentation> rhs,
+                           TScalarOp scalar_op) -> void {
+        assert(lhs.size() >= rhs.size());
+        std::size_t idx = 0;
+        for (; idx + WORDS_PER_VECTOR <= rhs.size(); idx += WORDS_PER_VECTOR) {
+            store(lhs.data() + idx, VectorOp(load(lhs.data() + idx), load(rhs.data() + idx)));
+        }
+        for (; idx < rhs.size(); idx++) {
+            lhs[idx] = scalar_op(lhs[idx], rhs[idx]);
+        }
+    }
+
+    // Per-byte popcount via a nibble lookup table, summed with SAD (Mula et al.)
+    AVX2_TARGET auto popcount(__m256i value) -> __m256i {
+        const auto lookup =
+            _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const auto low_mask = _mm256_set1_epi8(0x0f);
+
+        auto low   = _mm256_and_si256(value, low_mask);
+        auto high  = _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask);
+        auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+    }
+} // namespace
+
+auto Bitset::_has_avx2() -> bool {
+    static const bool has_avx2 = detect_avx2();
+    return has_avx2;
+}
+
+AVX2_TARGET auto Bitset::_or_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs) -> void {
+    apply<or_vector>(lhs, rhs, [](auto a, auto b) { return a | b; });
+}
+
+AVX2_TARGET auto Bitset::_and_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs) -> void {
+    apply<and_vector>(lhs, rhs, [](auto a, auto b) { return a & b; });
+}
+
+AVX2_TARGET auto Bitset::_xor_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs) -> void {
+    apply<xor_vector>(lhs, rhs, [](auto a, auto b) { return a ^ b; });
+}
+
+AVX2_TARGET auto Bitset::_is_subset_avx2(std::span<const UnderlyingBitRepresentation> subset,
+                                         std::span<const UnderlyingBitRepresentation> superset) -> bool {
+    assert(subset.size() == superset.size());
+    std::size_t idx = 0;
+    for (; idx + WORDS_PER_VECTOR <= subset.size(); idx += WORDS_PER_VECTOR) {
+        // testc returns 1 when every bit of subset is also set in superset
+        if (!_mm256_testc_si256(load(superset.data() + idx), load(subset.data() + idx))) {
+            return false;
+        }
+    }
+    for (; idx < subset.size(); idx++) {
+        if ((subset[idx] & ~superset[idx]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AVX2_TARGET auto Bitset::_count_avx2(std::span<const UnderlyingBitRepresentation> words) -> size_t {
+    auto totals     = _mm256_setzero_si256();
+    std::size_t idx = 0;
+    for (; idx + WORDS_PER_VECTOR <= words.size(); idx += WORDS_PER_VECTOR) {
+        totals = _mm256_add_epi64(totals, popcount(load(words.data() + idx)));
+    }
+
+    alignas(32) std::uint64_t lanes[WORDS_PER_VECTOR];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), totals);
+    size_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; idx < words.size(); idx++) {
+        count += static_cast<size_t>(std::popcount(words[idx]));
+    }
+    return count;
+}
+#else
+// Not built for x86-64; the scalar paths in bitset.cpp are always taken
+auto Bitset::_has_avx2() -> bool {
+    return false;
+}
+
+auto Bitset::_or_avx2(std::span<UnderlyingBitRepresentation>, std::span<const UnderlyingBitRepresentation>) -> void {
+    assert(false);
+}
+
+auto Bitset::_and_avx2(std::span<UnderlyingBitRepresentation>, std::span<const UnderlyingBitRepresentation>) -> void {
+    assert(false);
+}
+
+auto Bitset::_xor_avx2(std::span<UnderlyingBitRepresentation>, std::span<const UnderlyingBitRepresentation>) -> void {
+    assert(false);
+}
+
+auto Bitset::_is_subset_avx2(std::span<const UnderlyingBitRepresentation>, std::span<const UnderlyingBitRepresentation>) -> bool {
+    assert(false);
+    return false;
+}
+
+auto Bitset::_count_avx2(std::span<const UnderlyingBitRepresentation>) -> size_t {
+    assert(false);
+    return 0;
+}
+#endif
@@ -0,0 +1,637 @@
+#include "engine/compressed_bitset.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+using namespace ::ENGINE_NS;
+using namespace ::ENGINE_NS::compressed;
+
+namespace {
+    constexpr std::uint64_t ALL_BITS = ~static_cast<std::uint64_t>(0);
+
+    auto bit_mask(std::uint32_t value) -> std::uint64_t {
+        return static_cast<std::uint64_t>(1) << (value % 64);
+    }
+
+    auto set_bitmap_range(std::vector<std::uint64_t>& words, std::uint32_t first, std::uint32_t last) -> void {
+        auto first_word = first / 64;
+        auto last_word  = last / 64;
+        auto first_mask = ALL_BITS << (first % 64);
+        auto last_mask  = ALL_BITS >> (63 - last % 64);
+        if (first_word == last_word) {
+            words[first_word] |= first_mask & last_mask;
+            return;
+        }
+        words[first_word] |= first_mask;
+        for (auto word = first_word + 1; word < last_word; word++) {
+            words[word] = ALL_BITS;
+        }
+        words[last_word] |= last_mask;
+    }
+
+    auto clear_bitmap_range(std::vector<std::uint64_t>& words, std::uint32_t first, std::uint32_t last) -> void {
+        auto first_word = first / 64;
+        auto last_word  = last / 64;
+        auto first_mask = ALL_BITS << (first % 64);
+        auto last_mask  = ALL_BITS >> (63 - last % 64);
+        if (first_word == last_word) {
+            words[first_word] &= ~(first_mask & last_mask);
+            return;
+        }
+        words[first_word] &= ~first_mask;
+        for (auto word = first_word + 1; word < last_word; word++) {
+            words[word] = 0;
+        }
+        words[last_word] &= ~last_mask;
+    }
+
+    auto bitmap_cardinality(const std::vector<std::uint64_t>& words) -> std::uint32_t {
+        std::uint32_t cardinality = 0;
+        for (auto word : words) {
+            cardinality += static_cast<std::uint32_t>(std::popcount(word));
+        }
+        return cardinality;
+    }
+
+    auto empty_bitmap() -> Container {
+        auto container   = Container{};
+        container.type   = ContainerType::BITMAP;
+        container.bitmap = std::vector<std::uint64_t>(BITMAP_WORDS);
+        return container;
+    }
+
+    auto to_bitmap(const Container& container) -> Container {
+        switch (container.type) {
+            case ContainerType::ARRAY:
+                {
+                    auto bitmap = empty_bitmap();
+                    for (auto value : container.array) {
+                        bitmap.bitmap[value / 64] |= bit_mask(value);
+                    }
+                    bitmap.cardinality = container.cardinality;
+                    return bitmap;
+                }
+            case ContainerType::BITMAP:
+                return container;
+            case ContainerType::RUN:
+                {
+                    auto bitmap = empty_bitmap();
+                    for (auto run : container.runs) {
+                        set_bitmap_range(bitmap.bitmap, run.first, run.last);
+                    }
+                    bitmap.cardinality = container.cardinality;
+                    return bitmap;
+                }
+        }
+        std::unreachable();
+    }
+
+    auto to_array(const Container& container) -> Container {
+        if (container.type == ContainerType::ARRAY) {
+            return container;
+        }
+
+        auto array        = Container{};
+        array.type        = ContainerType::ARRAY;
+        array.cardinality = container.cardinality;
+        array.array.reserve(container.cardinality);
+        if (container.type == ContainerType::BITMAP) {
+            for (std::uint32_t word_idx = 0; word_idx < BITMAP_WORDS; word_idx++) {
+                auto word = container.bitmap[word_idx];
+                while (word != 0) {
+                    array.array.push_back(static_cast<std::uint16_t>(word_idx * 64 + static_cast<std::uint32_t>(std::countr_zero(word))));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (auto run : container.runs) {
+                for (std::uint32_t value = run.first; value <= run.last; value++) {
+                    array.array.push_back(static_cast<std::uint16_t>(value));
+                }
+            }
+        }
+        return array;
+    }
+
+    // Pick between array and bitmap by cardinality. Runs are left as they are; only optimise() creates them
+    auto normalise(Container&& container) -> Container {
+        if (container.type == ContainerType::BITMAP && container.cardinality <= ARRAY_MAX) {
+            return to_array(container);
+        }
+        if (container.type == ContainerType::ARRAY && container.cardinality > ARRAY_MAX) {
+            return to_bitmap(container);
+        }
+        return std::move(container);
+    }
+
+    // Runs are immutable; mutation works on whichever of array or bitmap fits
+    auto expand_runs(Container& container) -> void {
+        if (container.type != ContainerType::RUN) {
+            return;
+        }
+        container = container.cardinality > ARRAY_MAX ? to_bitmap(container) : to_array(container);
+    }
+
+    auto run_cardinality(const std::vector<Run>& runs) -> std::uint32_t {
+        std::uint32_t cardinality = 0;
+        for (auto run : runs) {
+            cardinality += static_cast<std::uint32_t>(run.last - run.first) + 1;
+        }
+        return cardinality;
+    }
+
+    auto build_runs(const Container& container) -> std::vector<Run> {
+        if (container.type == ContainerType::RUN) {
+            return container.runs;
+        }
+
+        auto runs   = std::vector<Run>();
+        auto append = [&runs](std::uint32_t value) {
+            if (!runs.empty() && static_cast<std::uint32_t>(runs.back().last) + 1 == value) {
+                runs.back().last = static_cast<std::uint16_t>(value);
+            } else {
+                runs.push_back({static_cast<std::uint16_t>(value), static_cast<std::uint16_t>(value)});
+            }
+        };
+        if (container.type == ContainerType::ARRAY) {
+            for (auto value : container.array) {
+                append(value);
+            }
+        } else {
+            for (std::uint32_t word_idx = 0; word_idx < BITMAP_WORDS; word_idx++) {
+                auto word = container.bitmap[word_idx];
+                while (word != 0) {
+                    append(word_idx * 64 + static_cast<std::uint32_t>(std::countr_zero(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+        return runs;
+    }
+
+    auto contains(const Container& container, std::uint16_t value) -> bool {
+        switch (container.type) {
+            case ContainerType::ARRAY:
+                return std::ranges::binary_search(container.array, value);
+            case ContainerType::BITMAP:
+                return (container.bitmap[value / 64] & bit_mask(value)) != 0;
+            case ContainerType::RUN:
+                {
+                    auto after = std::ranges::upper_bound(container.runs, value, {}, &Run::first);
+                    if (after == container.runs.begin()) {
+                        return false;
+                    }
+                    return value <= std::prev(after)->last;
+                }
+        }
+        std::unreachable();
+    }
+
+    auto add(Container& container, std::uint16_t value) -> void {
+        expand_runs(container);
+        if (container.type == ContainerType::ARRAY) {
+            auto position = std::ranges::lower_bound(container.array, value);
+            if (position != container.array.end() && *position == value) {
+                return;
+            }
+            container.array.insert(position, value);
+            container.cardinality += 1;
+            container = normalise(std::move(container));
+        } else {
+            auto& word = container.bitmap[value / 64];
+            if ((word & bit_mask(value)) == 0) {
+                word |= bit_mask(value);
+                container.cardinality += 1;
+            }
+        }
+    }
+
+    auto remove(Container& container, std::uint16_t value) -> void {
+        expand_runs(container);
+        if (container.type == ContainerType::ARRAY) {
+            auto position = std::ranges::lower_bound(container.array, value);
+            if (position == container.array.end() || *position != value) {
+                return;
+            }
+            container.array.erase(position);
+            container.cardinality -= 1;
+        } else {
+            auto& word = container.bitmap[value / 64];
+            if ((word & bit_mask(value)) != 0) {
+                word &= ~bit_mask(value);
+                container.cardinality -= 1;
+                container = normalise(std::move(container));
+            }
+        }
+    }
+
+    auto container_or(const Container& lhs, const Container& rhs) -> Container {
+        if (lhs.type == ContainerType::RUN && rhs.type == ContainerType::RUN) {
+            auto merged = std::vector<Run>();
+            std::ranges::merge(lhs.runs, rhs.runs, std::back_inserter(merged), {}, &Run::first, &Run::first);
+
+            auto result = Container{};
+            result.type = ContainerType::RUN;
+            for (auto run : merged) {
+                if (!result.runs.empty() && static_cast<std::uint32_t>(result.runs.back().last) + 1 >= run.first) {
+                    result.runs.back().last = std::max(result.runs.back().last, run.last);
+                } else {
+                    result.runs.push_back(run);
+                }
+            }
+            result.cardinality = run_cardinality(result.runs);
+            return result;
+        }
+
+        if (lhs.type == ContainerType::ARRAY && rhs.type == ContainerType::ARRAY) {
+            auto result = Container{};
+            result.array.reserve(lhs.array.size() + rhs.array.size());
+            std::ranges::set_union(lhs.array, rhs.array, std::back_inserter(result.array));
+            result.cardinality = static_cast<std::uint32_t>(result.array.size());
+            return normalise(std::move(result));
+        }
+
+        auto result = to_bitmap(lhs);
+        switch (rhs.type) {
+            case ContainerType::ARRAY:
+                for (auto value : rhs.array) {
+                    result.bitmap[value / 64] |= bit_mask(value);
+                }
+                break;
+            case ContainerType::BITMAP:
+                for (std::uint32_t idx = 0; idx < BITMAP_WORDS; idx++) {
+                    result.bitmap[idx] |= rhs.bitmap[idx];
+                }
+                break;
+            case ContainerType::RUN:
+                for (auto run : rhs.runs) {
+                    set_bitmap_range(result.bitmap, run.first, run.last);
+                }
+                break;
+        }
+        result.cardinality = bitmap_cardinality(result.bitmap);
+        return normalise(std::move(result));
+    }
+
+    auto container_and(const Container& lhs, const Container& rhs) -> Container {
+        if (lhs.type == ContainerType::ARRAY || rhs.type == ContainerType::ARRAY) {
+            const auto& array = (lhs.type == ContainerType::ARRAY) ? lhs : rhs;
+            const auto& other = (lhs.type == ContainerType::ARRAY) ? rhs : lhs;
+
+            auto result = Container{};
+            if (other.type == ContainerType::ARRAY) {
+                std::ranges::set_intersection(array.array, other.array, std::back_inserter(result.array));
+            } else {
+                for (auto value : array.array) {
+                    if (contains(other, value)) {
+                        result.array.push_back(value);
+                    }
+                }
+            }
+            result.cardinality = static_cast<std::uint32_t>(result.array.size());
+            return result;
+        }
+
+        if (lhs.type == ContainerType::RUN && rhs.type == ContainerType::RUN) {
+            auto result = Container{};
+            result.type = ContainerType::RUN;
+
+            std::size_t lhs_idx = 0;
+            std::size_t rhs_idx = 0;
+            while (lhs_idx < lhs.runs.size() && rhs_idx < rhs.runs.size()) {
+                auto a     = lhs.runs[lhs_idx];
+                auto b     = rhs.runs[rhs_idx];
+                auto first = std::max(a.first, b.first);
+                auto last  = std::min(a.last, b.last);
+                if (first <= last) {
+                    result.runs.push_back({first, last});
+                }
+                if (a.last < b.last) {
+                    lhs_idx += 1;
+                } else {
+                    rhs_idx += 1;
+                }
+            }
+            result.cardinality = run_cardinality(result.runs);
+            return result;
+        }
+
+        auto result = to_bitmap(lhs);
+        auto other  = (rhs.type == ContainerType::BITMAP) ? Container{} : to_bitmap(rhs);
+        const auto& other_words = (rhs.type == ContainerType::BITMAP) ? rhs.bitmap : other.bitmap;
+        for (std::uint32_t idx = 0; idx < BITMAP_WORDS; idx++) {
+            result.bitmap[idx] &= other_words[idx];
+        }
+        result.cardinality = bitmap_cardinality(result.bitmap);
+        return normalise(std::move(result));
+    }
+
+    auto container_and_not(const Container& lhs, const Container& rhs) -> Container {
+        if (lhs.type == ContainerType::ARRAY) {
+            auto result = Container{};
+            if (rhs.type == ContainerType::ARRAY) {
+                std::ranges::set_difference(lhs.array, rhs.array, std::back_inserter(result.array));
+            } else {
+                for (auto value : lhs.array) {
+                    if (!contains(rhs, value)) {
+                        result.array.push_back(value);
+                    }
+                }
+            }
+            result.cardinality = static_cast<std::uint32_t>(result.array.size());
+            return result;
+        }
+
+        auto result = to_bitmap(lhs);
+        switch (rhs.type) {
+            case ContainerType::ARRAY:
+                for (auto value : rhs.array) {
+                    result.bitmap[value / 64] &= ~bit_mask(value);
+                }
+                break;
+            case ContainerType::BITMAP:
+                for (std::uint32_t idx = 0; idx < BITMAP_WORDS; idx++) {
+                    result.bitmap[idx] &= ~rhs.bitmap[idx];
+                }
+                break;
+            case ContainerType::RUN:
+                for (auto run : rhs.runs) {
+                    clear_bitmap_range(result.bitmap, run.first, run.last);
+                }
+                break;
+        }
+        result.cardinality = bitmap_cardinality(result.bitmap);
+        return normalise(std::move(result));
+    }
+
+    auto container_equals(const Container& lhs, const Container& rhs) -> bool {
+        if (lhs.cardinality != rhs.cardinality) {
+            return false;
+        }
+        if (lhs.type == rhs.type) {
+            switch (lhs.type) {
+                case ContainerType::ARRAY:
+                    return lhs.array == rhs.array;
+                case ContainerType::BITMAP:
+                    return lhs.bitmap == rhs.bitmap;
+                case ContainerType::RUN:
+                    return std::ranges::equal(lhs.runs, rhs.runs, [](Run a, Run b) { return a.first == b.first && a.last == b.last; });
+            }
+        }
+        return to_array(lhs).array == to_array(rhs).array;
+    }
+} // namespace
+
+auto CompressedBitset::from_bitset(const Bitset& bitset) -> CompressedBitset {
+    auto compressed = CompressedBitset();
+    bitset.for_each_set_bit([&compressed](size_t idx) {
+        assert(idx <= UINT32_MAX);
+        compressed.set(static_cast<std::uint32_t>(idx));
+    });
+    return compressed;
+}
+
+auto CompressedBitset::to_bitset() const -> Bitset {
+    if (m_blocks.empty()) {
+        return Bitset();
+    }
+
+    // Size the bitset once up front rather than letting every set() extend it
+    std::uint32_t last = 0;
+    this->for_each_set_bit([&last](std::uint32_t idx) { last = idx; });
+
+    auto bitset = Bitset(static_cast<size_t>(last) + 1);
+    this->for_each_set_bit([&bitset](std::uint32_t idx) { bitset.set(idx); });
+    return bitset;
+}
+
+auto CompressedBitset::operator|(const CompressedBitset& rhs) const -> CompressedBitset {
+    return this->bit_or(rhs);
+}
+
+auto CompressedBitset::operator&(const CompressedBitset& rhs) const -> CompressedBitset {
+    return this->bit_and(rhs);
+}
+
+auto CompressedBitset::operator==(const CompressedBitset& rhs) const -> bool {
+    return this->bit_equals(rhs);
+}
+
+auto CompressedBitset::operator|=(const CompressedBitset& rhs) -> CompressedBitset& {
+    if (&rhs != this) {
+        *this = this->bit_or(rhs);
+    }
+    return *this;
+}
+
+auto CompressedBitset::operator&=(const CompressedBitset& rhs) -> CompressedBitset& {
+    if (&rhs != this) {
+        *this = this->bit_and(rhs);
+    }
+    return *this;
+}
+
+auto CompressedBitset::operator[](std::uint32_t idx) const -> std::uint8_t {
+    return this->get(idx);
+}
+
+auto CompressedBitset::bit_or(const CompressedBitset& rhs) const -> CompressedBitset {
+    auto combined = CompressedBitset();
+    combined.m_blocks.reserve(m_blocks.size() + rhs.m_blocks.size());
+
+    std::size_t lhs_idx = 0;
+    std::size_t rhs_idx = 0;
+    while (lhs_idx < m_blocks.size() || rhs_idx < rhs.m_blocks.size()) {
+        if (rhs_idx == rhs.m_blocks.size() || (lhs_idx < m_blocks.size() && m_blocks[lhs_idx].key < rhs.m_blocks[rhs_idx].key)) {
+            combined.m_blocks.push_back(m_blocks[lhs_idx++]);
+        } else if (lhs_idx == m_blocks.size() || rhs.m_blocks[rhs_idx].key < m_blocks[lhs_idx].key) {
+            combined.m_blocks.push_back(rhs.m_blocks[rhs_idx++]);
+        } else {
+            auto key = m_blocks[lhs_idx].key;
+            combined.m_blocks.push_back({key, container_or(m_blocks[lhs_idx].container, rhs.m_blocks[rhs_idx].container)});
+            lhs_idx += 1;
+            rhs_idx += 1;
+        }
+    }
+    return combined;
+}
+
+auto CompressedBitset::bit_and(const CompressedBitset& rhs) const -> CompressedBitset {
+    auto combined = CompressedBitset();
+
+    std::size_t lhs_idx = 0;
+    std::size_t rhs_idx = 0;
+    while (lhs_idx < m_blocks.size() && rhs_idx < rhs.m_blocks.size()) {
+        auto lhs_key = m_blocks[lhs_idx].key;
+        auto rhs_key = rhs.m_blocks[rhs_idx].key;
+        if (lhs_key < rhs_key) {
+            lhs_idx += 1;
+        } else if (rhs_key < lhs_key) {
+            rhs_idx += 1;
+        } else {
+            auto container = container_and(m_blocks[lhs_idx].container, rhs.m_blocks[rhs_idx].container);
+            if (container.cardinality > 0) {
+                combined.m_blocks.push_back({lhs_key, std::move(container)});
+            }
+            lhs_idx += 1;
+            rhs_idx += 1;
+        }
+    }
+    return combined;
+}
+
+auto CompressedBitset::bit_and_not(const CompressedBitset& rhs) const -> CompressedBitset {
+    auto combined = CompressedBitset();
+    combined.m_blocks.reserve(m_blocks.size());
+
+    std::size_t rhs_idx = 0;
+    for (const auto& block : m_blocks) {
+        while (rhs_idx < rhs.m_blocks.size() && rhs.m_blocks[rhs_idx].key < block.key) {
+            rhs_idx += 1;
+        }
+        if (rhs_idx == rhs.m_blocks.size() || rhs.m_blocks[rhs_idx].key != block.key) {
+            combined.m_blocks.push_back(block);
+            continue;
+        }
+        auto container = container_and_not(block.container, rhs.m_blocks[rhs_idx].container);
+        if (container.cardinality > 0) {
+            combined.m_blocks.push_back({block.key, std::move(container)});
+        }
+    }
+    return combined;
+}
+
+auto CompressedBitset::bit_equals(const CompressedBitset& rhs) const -> bool {
+    if (m_blocks.size() != rhs.m_blocks.size()) {
+        return false;
+    }
+    for (std::size_t idx = 0; idx < m_blocks.size(); idx++) {
+        if (m_blocks[idx].key != rhs.m_blocks[idx].key) {
+            return false;
+        }
+        if (!container_equals(m_blocks[idx].container, rhs.m_blocks[idx].container)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto CompressedBitset::get(std::uint32_t idx) const -> std::uint8_t {
+    auto block = this->_find_block(static_cast<std::uint16_t>(idx >> 16));
+    if (block == nullptr) {
+        return 0;
+    }
+    return contains(block->container, static_cast<std::uint16_t>(idx & 0xffff)) ? 1 : 0;
+}
+
+auto CompressedBitset::set(std::uint32_t idx) -> void {
+    auto& block = this->_find_or_insert_block(static_cast<std::uint16_t>(idx >> 16));
+    add(block.container, static_cast<std::uint16_t>(idx & 0xffff));
+}
+
+auto CompressedBitset::set_range(std::uint32_t first, std::uint32_t last) -> void {
+    if (first > last) {
+        return;
+    }
+    for (std::uint32_t key = first >> 16; key <= (last >> 16); key++) {
+        auto low  = (key == (first >> 16)) ? (first & 0xffff) : 0;
+        auto high = (key == (last >> 16)) ? (last & 0xffff) : 0xffff;
+
+        auto& container = this->_find_or_insert_block(static_cast<std::uint16_t>(key)).container;
+        auto range      = Container{};
+        range.type      = ContainerType::RUN;
+        range.runs.push_back({static_cast<std::uint16_t>(low), static_cast<std::uint16_t>(high)});
+        range.cardinality = high - low + 1;
+
+        // A freshly inserted block has nothing to merge with, so keep the range as a run
+        container = (container.cardinality == 0) ? std::move(range) : container_or(container, range);
+    }
+}
+
+auto CompressedBitset::clear(std::uint32_t idx) -> void {
+    auto key      = static_cast<std::uint16_t>(idx >> 16);
+    auto position = std::ranges::lower_bound(m_blocks, key, {}, &compressed::Block::key);
+    if (position == m_blocks.end() || position->key != key) {
+        return;
+    }
+    remove(position->container, static_cast<std::uint16_t>(idx & 0xffff));
+    if (position->container.cardinality == 0) {
+        m_blocks.erase(position);
+    }
+}
+
+auto CompressedBitset::count() const -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& block : m_blocks) {
+        count += block.container.cardinality;
+    }
+    return count;
+}
+
+auto CompressedBitset::any() const -> bool {
+    // Empty blocks are always removed
+    return !m_blocks.empty();
+}
+
+auto CompressedBitset::none() const -> bool {
+    return m_blocks.empty();
+}
+
+auto CompressedBitset::optimise() -> void {
+    for (auto& block : m_blocks) {
+        auto& container = block.container;
+        auto runs       = build_runs(container);
+
+        auto run_bytes   = runs.size() * sizeof(Run);
+        auto array_bytes = (container.cardinality <= ARRAY_MAX) ? container.cardinality * sizeof(std::uint16_t) : SIZE_MAX;
+        auto other_bytes = std::min<std::size_t>(array_bytes, BITMAP_WORDS * sizeof(std::uint64_t));
+        if (run_bytes < other_bytes) {
+            if (container.type != ContainerType::RUN) {
+                auto cardinality = container.cardinality;
+                container        = Container{};
+                container.type   = ContainerType::RUN;
+                container.runs   = std::move(runs);
+                container.cardinality = cardinality;
+            }
+        } else {
+            expand_runs(container);
+            container = normalise(std::move(container));
+        }
+        container.array.shrink_to_fit();
+        container.runs.shrink_to_fit();
+    }
+    m_blocks.shrink_to_fit();
+}
+
+auto CompressedBitset::memory_usage() const -> std::size_t {
+    auto bytes = m_blocks.capacity() * sizeof(compressed::Block);
+    for (const auto& block : m_blocks) {
+        bytes += block.container.array.capacity() * sizeof(std::uint16_t);
+        bytes += block.container.bitmap.capacity() * sizeof(std::uint64_t);
+        bytes += block.container.runs.capacity() * sizeof(Run);
+    }
+    return bytes;
+}
+
+auto CompressedBitset::_find_block(std::uint16_t key) const -> const compressed::Block* {
+    auto position = std::ranges::lower_bound(m_blocks, key, {}, &compressed::Block::key);
+    if (position == m_blocks.end() || position->key != key) {
+        return nullptr;
+    }
+    return &*position;
+}
+
+auto CompressedBitset::_find_or_insert_block(std::uint16_t key) -> compressed::Block& {
+    // Members are usually added in ascending order, so check the last block before searching
+    if (!m_blocks.empty() && m_blocks.back().key == key) {
+        return m_blocks.back();
+    }
+    auto position = std::ranges::lower_bound(m_blocks, key, {}, &compressed::Block::key);
+    if (position == m_blocks.end() || position->key != key) {
+        position = m_blocks.insert(position, compressed::Block{key, Container{}});
+    }
+    return *position;
+}
@@ -9,6 +9,8 @@
 
 #include <tracy/Tracy.hpp>
 #include <chrono>
+#include <filesystem>
+#include <optional>
 #include <thread>
 
 
@@ -16,69 +18,131 @@ using namespace ::ENGINE_NS;
 
 LogLocator::LogLocator() :
     loggers_({
-      LoggerBuilder().with_identifier("ENGINE").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("GRAPHICS").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("VULKAN").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("VULKAN [PERFORMANCE]").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("VULKAN [VALIDATION]").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("GAMESTATE").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
-      LoggerBuilder().with_identifier("GAME").with_stream({stdout, logger::Level::DEBUG}).build(m_log_idx),
+      LoggerBuilder().with_identifier("ENGINE").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("GRAPHICS").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("VULKAN").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("VULKAN [PERFORMANCE]").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("VULKAN [VALIDATION]").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("GAMESTATE").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
+      LoggerBuilder().with_identifier("GAME").with_stream({stdout, logger::Level::DEBUG}).build(m_sink),
     }) {
+    for (auto& level : levels_) {
+        level.store(logger::Level::DEBUG, std::memory_order_relaxed);
+    }
 }
 
-auto LogLocator::get(LogNamespaces ns) -> RwDataMut<Logger> {
-    return loggers_[static_cast<std::uint8_t>(ns)].write();
+LogLocator::~LogLocator() {
+    // The sink refers back to the loggers, so it has to finish before they go
+    m_sink.stop();
 }
+
 auto LogLocator::get(LogNamespaces ns) const -> RwData<Logger> {
     return loggers_[static_cast<std::uint8_t>(ns)].read();
 }
 
+auto LogLocator::set_level(LogNamespaces ns, logger::Level level) -> void {
+    levels_[static_cast<std::size_t>(ns)].store(level, std::memory_order_relaxed);
+}
+
+auto LogLocator::flush() -> void {
+    m_sink.flush();
+}
+
+auto LogLocator::write_binary_to(std::FILE* file) -> void {
+    m_sink.write_binary_to(file);
+}
+
 auto ENGINE_NS::LogLocator::imgui() -> void {
     if (!is_log_open_) {
         return;
     }
     if (ImGui::Begin("Logs", &is_log_open_)) {
-        std::vector<const logger::Entry*> entries = {};
-        for (auto& logger : loggers_) {
-            auto lock         = logger.read();
-            auto& log         = lock.get();
-            auto last_entries = log.last_entries(128);
-            entries.insert(entries.end(), last_entries.begin(), last_entries.end());
+        ZoneScoped;
+        // Views keep each logger's history still while new entries are merged in and the visible lines are drawn
+        std::array<std::optional<logger::HistoryView>, static_cast<std::size_t>(LogNamespaces::COUNT)> views = {};
+        std::array<logger::HistoryView::Iterator, static_cast<std::size_t>(LogNamespaces::COUNT)> heads  = {};
+        for (std::size_t idx = 0; idx < loggers_.size(); idx++) {
+            views[idx].emplace(loggers_[idx].read().get().entries_since(console_seen_[idx]));
+            heads[idx] = views[idx]->begin();
         }
-        std::sort(entries.begin(), entries.end(), [](const logger::Entry* lhs, const logger::Entry* rhs) {
-            return lhs->index < rhs->index;
-        });
-
-        for (auto& entry : entries) {
-            ImVec4 level_colour = {1, 1, 1, 1};
-            switch (entry->level) {
-                case logger::Level::DEBUG:
-                    level_colour = {204.f, 255.f, 51.f, 255.f};
-                    break;
-                case logger::Level::ERROR:
-                    level_colour = {255.f, 51.f, 102.f, 255.f};
-                    break;
-                case logger::Level::WARNING:
-                    level_colour = {255.f, 204.f, 85.f, 255.f};
-                    break;
-                case logger::Level::INFO:
-                    level_colour = {68.f, 170.f, 238.f, 255.f};
-                    break;
+
+        // Only entries recorded since the last frame are merged. Each logger's are already in index order, so taking
+        // the lowest head each step keeps the console in call order
+        while (true) {
+            auto next   = loggers_.size();
+            auto lowest = UINT64_MAX;
+            for (std::size_t idx = 0; idx < loggers_.size(); idx++) {
+                if (heads[idx] != views[idx]->end() && (*heads[idx]).index < lowest) {
+                    next   = idx;
+                    lowest = (*heads[idx]).index;
+                }
+            }
+            if (next == loggers_.size()) {
+                break;
             }
-            level_colour.x /= 255.f;
-            level_colour.y /= 255.f;
-            level_colour.z /= 255.f;
-            level_colour.w /= 255.f;
-            ImGui::Text("[%s]", entry->owner.c_str());
-            ImGui::SameLine();
-            ImGui::TextColored(level_colour, "%s", logger::level_to_string(entry->level).data());
-            ImGui::SameLine();
-            ImGui::Text("%s", entry->message.c_str());
+            push_console_line_({static_cast<std::uint8_t>(next), heads[next].sequence()});
+            ++heads[next];
+        }
+        for (std::size_t idx = 0; idx < loggers_.size(); idx++) {
+            console_seen_[idx] = views[idx]->end_sequence();
+        }
+
+        auto following = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(console_.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const auto& line = console_[(console_start_ + static_cast<std::size_t>(row)) % console_.size()];
+                auto entry       = views[line.logger]->at(line.sequence);
+                if (!entry) {
+                    // Pushed out of its logger's history by longer messages
+                    ImGui::TextDisabled("...");
+                    continue;
+                }
+
+                ImVec4 level_colour = {1, 1, 1, 1};
+                switch (entry->level) {
+                    case logger::Level::DEBUG:
+                        level_colour = {204.f, 255.f, 51.f, 255.f};
+                        break;
+                    case logger::Level::ERROR:
+                        level_colour = {255.f, 51.f, 102.f, 255.f};
+                        break;
+                    case logger::Level::WARNING:
+                        level_colour = {255.f, 204.f, 85.f, 255.f};
+                        break;
+                    case logger::Level::INFO:
+                        level_colour = {68.f, 170.f, 238.f, 255.f};
+                        break;
+                }
+                level_colour.x /= 255.f;
+                level_colour.y /= 255.f;
+                level_colour.z /= 255.f;
+                level_colour.w /= 255.f;
+                ImGui::Text("[%.*s]", static_cast<int>(entry->owner.size()), entry->owner.data());
+                ImGui::SameLine();
+                ImGui::TextColored(level_colour, "%s", logger::level_to_string(entry->level).data());
+                ImGui::SameLine();
+                ImGui::TextUnformatted(entry->message.data(), entry->message.data() + entry->message.size());
+            }
+        }
+        clipper.End();
+        if (following) {
+            ImGui::SetScrollHereY(1.f);
         }
     }
     ImGui::End();
 }
 
+auto LogLocator::push_console_line_(ConsoleLine line) -> void {
+    if (console_.size() < CONSOLE_LINES) {
+        console_.push_back(line);
+        return;
+    }
+    console_[console_start_] = line;
+    console_start_           = (console_start_ + 1) % console_.size();
+}
+
 Engine::Engine() {
     if (!g_ENGINE) {
         g_ENGINE = this;
@@ -117,6 +181,13 @@ auto ENGINE_NS::Engine::main_loop() -> void {
     auto last_update   = std::chrono::high_resolution_clock::now();
     auto last_frame    = std::chrono::high_resolution_clock::now();
 
+    // Process CPU time against wall time, sampled once a second. An idle engine should sit near zero
+    const auto cpu_sample_rate = std::chrono::seconds(1);
+    const auto loop_start_wall = std::chrono::steady_clock::now();
+    const auto loop_start_cpu  = process_cpu_time();
+    auto cpu_sample_wall       = loop_start_wall;
+    auto cpu_sample_cpu        = loop_start_cpu;
+
     while (running_) {
         ++frame_count_;
         FrameMarkStart(StaticNames::EngineLoop);
@@ -186,6 +257,7 @@ auto ENGINE_NS::Engine::main_loop() -> void {
         }
         imgui.start_frame();
 
+        jobs.run_main_thread_jobs();
         this->state_manager.start_frame(this->graphics_);
 
         this->update();
@@ -210,8 +282,22 @@ auto ENGINE_NS::Engine::main_loop() -> void {
             std::this_thread::sleep_for(sleep);
         }
         last_frame = std::chrono::high_resolution_clock::now();
+
+        if (auto now = std::chrono::steady_clock::now(); now - cpu_sample_wall >= cpu_sample_rate) {
+            auto cpu   = process_cpu_time();
+            auto usage = 100.0 * std::chrono::duration<double>(cpu - cpu_sample_cpu).count() /
+                         std::chrono::duration<double>(now - cpu_sample_wall).count();
+            TracyPlot(StaticNames::ProcessCpuUsage, usage);
+            cpu_sample_wall = now;
+            cpu_sample_cpu  = cpu;
+        }
         FrameMark;
     }
+
+    auto wall      = std::chrono::duration<double>(std::chrono::steady_clock::now() - loop_start_wall).count();
+    auto cpu       = std::chrono::duration<double>(process_cpu_time() - loop_start_cpu).count();
+    auto my_logger = logger.get(LogNamespaces::CORE);
+    my_logger.get().info("Average CPU usage {:.1f}% of one core over {:.1f}s", wall > 0.0 ? 100.0 * cpu / wall : 0.0, wall);
 }
 
 auto Engine::startup() -> void {
@@ -222,6 +308,14 @@ auto Engine::startup() -> void {
     auto my_logger = logger.get(LogNamespaces::CORE);
     my_logger.get().info("Starting");
 
+    if (std::filesystem::exists(ASSET_ARCHIVE)) {
+        if (auto err = files.mount(ASSET_ARCHIVE); !err) {
+            my_logger.get().warning("Cannot mount {}, using loose assets: {}", ASSET_ARCHIVE, err.error().reason);
+        } else {
+            my_logger.get().info("Mounted asset archive {}", ASSET_ARCHIVE);
+        }
+    }
+
     linalg::load_library();
     linalg::load_vector_functions(linalg::g_VECTOR_LIBRARY->library);
     linalg::load_matrix_functions(linalg::g_VECTOR_LIBRARY->library);
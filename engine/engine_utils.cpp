@@ -6,8 +6,35 @@
 
 #include <fmt/format.h>
 
+#include <cstdint>
 #include <cstring>
 
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+auto ENGINE_NS::process_cpu_time() -> std::chrono::nanoseconds {
+#ifdef _WIN32
+    FILETIME creation, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user)) {
+        return std::chrono::nanoseconds(0);
+    }
+    auto to_ticks = [](FILETIME time) {
+        return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    // FILETIME counts 100ns ticks
+    return std::chrono::nanoseconds((to_ticks(kernel) + to_ticks(user)) * 100);
+#else
+    timespec time{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#endif
+}
+
 
 void ENGINE_NS::vulkan_crash(VkResult error, int line, const char* function, const char* file) {
     const char* error_message = "Could not find error message";
@@ -150,6 +177,8 @@ void ENGINE_NS::crash(ErrorCode reason, int line, const char* function, const ch
         }
         g_ENGINE->crashed_ = true;
         g_ENGINE->shutdown();
+        // Logging is written out in the background; make sure the crash report lands before exiting
+        g_ENGINE->logger.flush();
     }
     std::exit(static_cast<int>(reason));
 }
@@ -0,0 +1,344 @@
+#include "engine/fileio/archive.h"
+#include "engine/fileio/lz.h"
+#include "engine/jobs/job_system.h"
+
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    auto align_up(std::uint64_t value, std::uint64_t alignment) -> std::uint64_t {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // True if [offset, offset + size) lies within a file of file_size bytes, without overflowing
+    auto within(std::uint64_t offset, std::uint64_t size, std::uint64_t file_size) -> bool {
+        return offset <= file_size && size <= file_size - offset;
+    }
+
+    auto write_padding(fileio::File& file, std::uint64_t count) -> std::expected<void, fileio::error::Error> {
+        static constexpr std::array<std::byte, fileio::archive::BLOB_ALIGNMENT> ZEROES{};
+        while (count > 0) {
+            auto chunk = std::min<std::uint64_t>(count, ZEROES.size());
+            if (auto err = file.write(std::span(ZEROES.data(), chunk)); !err) {
+                return err;
+            }
+            count -= chunk;
+        }
+        return std::expected<void, fileio::error::Error>{};
+    }
+
+    auto block_count(std::uint64_t size) -> std::uint64_t {
+        return (size + fileio::archive::BLOCK_SIZE - 1) / fileio::archive::BLOCK_SIZE;
+    }
+
+    // Compress bytes block by block into the blob layout. False if the result is no smaller than the input
+    auto compress_blob(std::span<const std::byte> bytes, std::vector<std::byte>& blob) -> bool {
+        ZoneScoped;
+        auto blocks      = block_count(bytes.size());
+        auto table_bytes = blocks * sizeof(std::uint32_t);
+        auto scratch     = std::vector<std::byte>(fileio::lz::compress_bound(fileio::archive::BLOCK_SIZE));
+        blob.assign(table_bytes, std::byte{0});
+        for (std::uint64_t i = 0; i < blocks && blob.size() < bytes.size(); i++) {
+            auto first      = i * fileio::archive::BLOCK_SIZE;
+            auto block      = bytes.subspan(first, std::min<std::uint64_t>(bytes.size() - first, fileio::archive::BLOCK_SIZE));
+            auto compressed = fileio::lz::compress(block, scratch);
+            auto stored     = std::span<const std::byte>(scratch.data(), compressed);
+            auto size       = static_cast<std::uint32_t>(compressed);
+            if (compressed == 0 || compressed >= block.size()) {
+                stored = block;
+                size   = static_cast<std::uint32_t>(block.size()) | fileio::archive::STORED_RAW;
+            }
+            std::memcpy(blob.data() + i * sizeof(std::uint32_t), &size, sizeof(size));
+            blob.insert(blob.end(), stored.begin(), stored.end());
+        }
+        return blob.size() < bytes.size();
+    }
+} // namespace
+
+auto ENGINE_NS::fileio::archive::normalise(const std::filesystem::path& path) -> std::string {
+    auto normal = path.lexically_normal().generic_u8string();
+    return std::string(reinterpret_cast<const char*>(normal.data()), normal.size());
+}
+
+auto ENGINE_NS::fileio::archive::hash(std::string_view path) -> std::uint64_t {
+    std::uint64_t value = 0xcbf29ce484222325ull;
+    for (auto c : path) {
+        value ^= static_cast<std::uint8_t>(c);
+        value *= 0x100000001b3ull;
+    }
+    return value;
+}
+
+auto ENGINE_NS::fileio::archive::unpack(const Blob& blob, std::span<std::byte> destination, JobSystem* jobs) -> bool {
+    ZoneScoped;
+    if (destination.size() != blob.size) {
+        return false;
+    }
+    if (blob.compression == Compression::NONE) {
+        if (blob.stored.size() != blob.size) {
+            return false;
+        }
+        std::ranges::copy(blob.stored, destination.begin());
+        return true;
+    }
+    if (blob.compression != Compression::LZ) {
+        return false;
+    }
+
+    // Where each block starts, so every block can be decoded independently
+    auto blocks      = block_count(blob.size);
+    auto table_bytes = blocks * sizeof(std::uint32_t);
+    if (blob.stored.size() < table_bytes) {
+        return false;
+    }
+    auto starts = std::vector<std::uint64_t>(blocks + 1);
+    starts[0]   = table_bytes;
+    for (std::uint64_t i = 0; i < blocks; i++) {
+        std::uint32_t size = 0;
+        std::memcpy(&size, blob.stored.data() + i * sizeof(size), sizeof(size));
+        starts[i + 1] = starts[i] + (size & ~STORED_RAW);
+    }
+    if (starts[blocks] != blob.stored.size()) {
+        return false;
+    }
+
+    auto valid        = std::atomic<bool>(true);
+    auto decode_range = [&](std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; i++) {
+            std::uint32_t size = 0;
+            std::memcpy(&size, blob.stored.data() + i * sizeof(size), sizeof(size));
+            auto source = blob.stored.subspan(starts[i], starts[i + 1] - starts[i]);
+            auto target = destination.subspan(i * BLOCK_SIZE, std::min<std::uint64_t>(destination.size() - i * BLOCK_SIZE, BLOCK_SIZE));
+            if ((size & STORED_RAW) != 0) {
+                if (source.size() != target.size()) {
+                    valid.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                std::ranges::copy(source, target.begin());
+            } else if (lz::decompress(source, target) != target.size()) {
+                valid.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (jobs != nullptr && blocks > 1) {
+        jobs->parallel_for(0, blocks, 1, decode_range);
+    } else {
+        decode_range(0, blocks);
+    }
+    return valid.load(std::memory_order_relaxed);
+}
+
+auto ENGINE_NS::fileio::Archive::open(const std::filesystem::path& path) -> std::expected<Archive, error::Error> {
+    ZoneScoped;
+    auto mapped = File::map(path);
+    if (!mapped) {
+        return std::unexpected(mapped.error());
+    }
+    auto bytes = mapped->bytes();
+
+    auto header = archive::Header{};
+    if (bytes.size() < sizeof(header)) {
+        return std::unexpected(error::Error::invalid_archive());
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != archive::MAGIC || header.version != archive::VERSION || header.byte_order != archive::BYTE_ORDER_MARK) {
+        return std::unexpected(error::Error::invalid_archive());
+    }
+
+    auto size         = static_cast<std::uint64_t>(bytes.size());
+    auto slots_valid  = header.slot_count == 0 ? header.entry_count == 0
+                                               : std::has_single_bit(header.slot_count) && header.slot_count > header.entry_count;
+    auto tables_valid = slots_valid && header.entries_offset % alignof(archive::Entry) == 0 &&
+                        header.slots_offset % alignof(std::uint32_t) == 0 &&
+                        within(header.entries_offset, std::uint64_t{header.entry_count} * sizeof(archive::Entry), size) &&
+                        within(header.slots_offset, std::uint64_t{header.slot_count} * sizeof(std::uint32_t), size) &&
+                        within(header.names_offset, header.names_size, size);
+    if (!tables_valid) {
+        return std::unexpected(error::Error::invalid_archive());
+    }
+
+    auto result      = Archive(std::move(mapped.value()));
+    const auto* base = result.file_.bytes().data();
+    result.entries_  = {reinterpret_cast<const archive::Entry*>(base + header.entries_offset), header.entry_count};
+    result.slots_    = {reinterpret_cast<const std::uint32_t*>(base + header.slots_offset), header.slot_count};
+    result.names_    = {reinterpret_cast<const char*>(base + header.names_offset), static_cast<std::size_t>(header.names_size)};
+
+    // Checked once here so lookups can trust every offset they read
+    for (const auto& entry : result.entries_) {
+        auto compression_valid = entry.compression == archive::Compression::LZ ||
+                                 (entry.compression == archive::Compression::NONE && entry.stored_size == entry.size);
+        if (!compression_valid || !within(entry.name_offset, entry.name_size, header.names_size) ||
+            !within(entry.offset, entry.stored_size, size)) {
+            return std::unexpected(error::Error::invalid_archive());
+        }
+    }
+    for (auto slot : result.slots_) {
+        if (slot > header.entry_count) {
+            return std::unexpected(error::Error::invalid_archive());
+        }
+    }
+    return result;
+}
+
+auto ENGINE_NS::fileio::Archive::find(const std::filesystem::path& path) const -> std::optional<archive::Blob> {
+    return find_normalised(archive::normalise(path));
+}
+
+auto ENGINE_NS::fileio::Archive::find_normalised(std::string_view path) const -> std::optional<archive::Blob> {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    auto hash = archive::hash(path);
+    auto mask = slots_.size() - 1;
+    // Bounded so a corrupt table without an empty slot still terminates
+    for (std::size_t probe = 0, slot = hash & mask; probe < slots_.size(); probe++, slot = (slot + 1) & mask) {
+        auto index = slots_[slot];
+        if (index == 0) {
+            return std::nullopt;
+        }
+        const auto& entry = entries_[index - 1];
+        if (entry.hash == hash && names_.substr(entry.name_offset, entry.name_size) == path) {
+            return archive::Blob{
+                .stored      = file_.bytes().subspan(static_cast<std::size_t>(entry.offset), static_cast<std::size_t>(entry.stored_size)),
+                .size        = entry.size,
+                .compression = entry.compression,
+            };
+        }
+    }
+    return std::nullopt;
+}
+
+ENGINE_NS::fileio::Archive::Archive(MappedFile&& file) : file_(std::move(file)) {
+}
+
+auto ENGINE_NS::fileio::ArchiveWriter::add_file(const std::filesystem::path& archive_path, const std::filesystem::path& source) -> void {
+    sources_.insert_or_assign(archive::normalise(archive_path), source);
+}
+
+auto ENGINE_NS::fileio::ArchiveWriter::add_directory(const std::filesystem::path& directory) -> std::expected<void, error::Error> {
+    auto ec = std::error_code{};
+    auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            add_file(it->path(), it->path());
+        }
+    }
+    if (ec) {
+        return std::unexpected(error::Error::open(ec.value()));
+    }
+    return std::expected<void, error::Error>{};
+}
+
+auto ENGINE_NS::fileio::ArchiveWriter::write(const std::filesystem::path& output) const -> std::expected<void, error::Error> {
+    ZoneScoped;
+    auto header        = archive::Header{};
+    header.entry_count = static_cast<std::uint32_t>(sources_.size());
+    header.slot_count  = sources_.empty() ? 0 : std::bit_ceil(header.entry_count * 2);
+
+    auto entries = std::vector<archive::Entry>();
+    auto names   = std::string();
+    entries.reserve(sources_.size());
+    for (const auto& [name, source] : sources_) {
+        if (names.size() + name.size() > std::numeric_limits<std::uint32_t>::max()) {
+            return std::unexpected(error::Error::invalid_archive());
+        }
+        auto& entry       = entries.emplace_back();
+        entry.hash        = archive::hash(name);
+        entry.name_offset = static_cast<std::uint32_t>(names.size());
+        entry.name_size   = static_cast<std::uint32_t>(name.size());
+        names += name;
+    }
+
+    header.entries_offset = sizeof(archive::Header);
+    header.slots_offset   = header.entries_offset + entries.size() * sizeof(archive::Entry);
+    header.names_offset   = header.slots_offset + std::uint64_t{header.slot_count} * sizeof(std::uint32_t);
+    header.names_size     = names.size();
+
+    auto slots = std::vector<std::uint32_t>(header.slot_count, 0);
+    for (std::uint32_t i = 0; i < entries.size(); i++) {
+        auto slot = entries[i].hash & (slots.size() - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+        slots[slot] = i + 1;
+    }
+
+    /*
+        Written beside the output and renamed over it at the end, so nothing ever maps a half written archive. Stored
+        sizes are only known once each blob is compressed, so the entries are written as placeholders and filled in
+        after the blobs
+    */
+    auto partial = output;
+    partial += ".partial";
+    // Run in its own scope so the file is closed before a failed archive is removed
+    auto written_archive = [&]() -> std::expected<void, error::Error> {
+        auto file = File::open(partial, OpenMode::BINARY, IoMode::WRITE);
+        if (!file) {
+            return std::unexpected(file.error());
+        }
+        auto written = std::uint64_t{header.names_offset + header.names_size};
+        if (auto err = file->write(std::span(&header, 1)); !err) {
+            return err;
+        }
+        if (auto err = file->write(std::span(entries)); !err) {
+            return err;
+        }
+        if (auto err = file->write(std::span(slots)); !err) {
+            return err;
+        }
+        if (auto err = file->write(std::span(names)); !err) {
+            return err;
+        }
+
+        auto entry      = entries.begin();
+        auto compressed = std::vector<std::byte>();
+        for (const auto& [name, source] : sources_) {
+            entry->offset = align_up(written, archive::BLOB_ALIGNMENT);
+            if (auto err = write_padding(*file, entry->offset - written); !err) {
+                return err;
+            }
+            auto blob = File::map(source, AccessHint::SEQUENTIAL);
+            if (!blob) {
+                return std::unexpected(blob.error());
+            }
+            auto stored = blob->bytes();
+            if (compression_ == archive::Compression::LZ && compress_blob(stored, compressed)) {
+                entry->compression = archive::Compression::LZ;
+                stored             = compressed;
+            }
+            if (auto err = file->write(stored); !err) {
+                return err;
+            }
+            entry->size        = blob->size();
+            entry->stored_size = stored.size();
+            written            = entry->offset + entry->stored_size;
+            ++entry;
+        }
+        if (auto err = file->pwrite(header.entries_offset, std::span(entries)); !err) {
+            return err;
+        }
+        return file->close();
+    }();
+    auto ec = std::error_code{};
+    if (!written_archive) {
+        std::filesystem::remove(partial, ec);
+        return written_archive;
+    }
+
+    std::filesystem::rename(partial, output, ec);
+    if (ec) {
+        auto err = error::Error::write(ec.value());
+        std::filesystem::remove(partial, ec);
+        return std::unexpected(err);
+    }
+    return std::expected<void, error::Error>{};
+}
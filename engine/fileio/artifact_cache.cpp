@@ -0,0 +1,97 @@
+#include "engine/fileio/artifact_cache.h"
+#include "engine/fileio/content_hash.h"
+
+#include <tracy/Tracy.hpp>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    auto append_hex(std::string& out, std::uint64_t value) -> void {
+        static constexpr std::array<char, 16> DIGITS = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            out.push_back(DIGITS[(value >> shift) & 0xf]);
+        }
+    }
+} // namespace
+
+auto ENGINE_NS::fileio::ArtifactKey::file_name() const -> std::string {
+    auto name = std::string();
+    name.reserve(processor.size() + 3 * 17);
+    // Anything that could escape the directory or upset a file system is flattened; the processor is also part of
+    // parameters_hash, so flattened names still differ
+    for (auto c : processor) {
+        auto safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        name.push_back(safe ? c : '_');
+    }
+    for (auto value : {source_hash, parameters_hash, source_size}) {
+        name.push_back('-');
+        append_hex(name, value);
+    }
+    return name;
+}
+
+ENGINE_NS::fileio::ArtifactCache::ArtifactCache(std::filesystem::path directory) : directory_(std::move(directory)) {
+}
+
+auto ENGINE_NS::fileio::ArtifactCache::key(std::string_view processor,
+                                           std::span<const std::byte> source,
+                                           std::span<const std::byte> parameters) -> ArtifactKey {
+    ZoneScoped;
+    auto result            = ArtifactKey{};
+    result.processor       = std::string(processor);
+    result.source_hash     = content_hash(source);
+    result.parameters_hash = content_hash(parameters, content_hash(processor));
+    result.source_size     = source.size();
+    return result;
+}
+
+auto ENGINE_NS::fileio::ArtifactCache::find(const ArtifactKey& key) const -> std::optional<MappedFile> {
+    ZoneScoped;
+    auto mapped = File::map(directory_ / key.file_name(), AccessHint::SEQUENTIAL);
+    if (!mapped) {
+        return std::nullopt;
+    }
+    return std::move(mapped.value());
+}
+
+auto ENGINE_NS::fileio::ArtifactCache::store(const ArtifactKey& key, std::span<const std::byte> artifact) const
+    -> std::expected<void, error::Error> {
+    ZoneScoped;
+    auto ec = std::error_code{};
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        return std::unexpected(error::Error::write(ec.value()));
+    }
+
+    // Unique per thread and call, so concurrent stores of the same key never write the same temporary file
+    static auto stores = std::atomic<std::uint64_t>(0);
+    auto target        = directory_ / key.file_name();
+    auto partial       = target;
+    partial += ".partial-" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "-" +
+               std::to_string(stores.fetch_add(1, std::memory_order_relaxed));
+    {
+        auto file = File::open(partial, OpenMode::BINARY, IoMode::WRITE);
+        if (!file) {
+            return std::unexpected(file.error());
+        }
+        auto written = file->write(artifact);
+        auto closed  = file->close();
+        if (!written || !closed) {
+            std::filesystem::remove(partial, ec);
+            return !written ? written : closed;
+        }
+    }
+
+    std::filesystem::rename(partial, target, ec);
+    if (ec) {
+        auto err = error::Error::write(ec.value());
+        std::filesystem::remove(partial, ec);
+        return std::unexpected(err);
+    }
+    return std::expected<void, error::Error>{};
+}
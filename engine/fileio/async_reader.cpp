@@ -0,0 +1,461 @@
+#include "engine/fileio/async_reader.h"
+
+#include <common/TracySystem.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif __linux__
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#else
+    #error "Unsupported OS"
+#endif
+
+using namespace ::ENGINE_NS;
+
+namespace {
+#ifdef _WIN32
+    using NativeHandle                = HANDLE;
+    const NativeHandle INVALID_HANDLE = INVALID_HANDLE_VALUE;
+#else
+    using NativeHandle                    = int;
+    constexpr NativeHandle INVALID_HANDLE = -1;
+#endif
+
+    auto open_native(const std::filesystem::path& path) -> std::expected<NativeHandle, fileio::error::Error> {
+#ifdef _WIN32
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+        int handle = ::open(reinterpret_cast<const char*>(path.u8string().c_str()), O_RDONLY | O_CLOEXEC);
+#endif
+        if (handle == INVALID_HANDLE) {
+            return std::unexpected(fileio::error::Error::open());
+        }
+        return handle;
+    }
+
+    auto close_native(NativeHandle handle) -> void {
+#ifdef _WIN32
+        CloseHandle(handle);
+#else
+        ::close(handle);
+#endif
+    }
+
+    // Blocking positional read of the whole destination, stopping early only at the end of the file
+    auto read_native(NativeHandle handle, std::uint64_t offset, std::span<std::byte> destination) -> fileio::ReadResult {
+        std::size_t done = 0;
+        while (done < destination.size()) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset     = static_cast<DWORD>(offset + done);
+            overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+            DWORD read            = 0;
+            auto chunk            = static_cast<DWORD>(std::min<std::size_t>(destination.size() - done, 1u << 30));
+            if (!ReadFile(handle, destination.data() + done, chunk, &read, &overlapped)) {
+                if (GetLastError() == ERROR_HANDLE_EOF) {
+                    break;
+                }
+                return std::unexpected(fileio::error::Error::read());
+            }
+#else
+            auto read = ::pread(handle, destination.data() + done, destination.size() - done, static_cast<off_t>(offset + done));
+            if (read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return std::unexpected(fileio::error::Error::read(errno));
+            }
+#endif
+            if (read == 0) {
+                break;
+            }
+            done += static_cast<std::size_t>(read);
+        }
+        return done;
+    }
+} // namespace
+
+struct ENGINE_NS::fileio::AsyncReader::Batch {
+        struct OpenFile {
+                std::filesystem::path path;
+                std::once_flag once;
+                NativeHandle handle = INVALID_HANDLE;
+                std::optional<error::Error> error;
+        };
+        struct Op {
+                Batch* batch      = nullptr;
+                std::size_t index = 0;
+                std::size_t done  = 0;
+#ifdef __linux__
+                iovec vector{};
+#endif
+        };
+
+        std::vector<ReadRequest> requests;
+        std::vector<ReadResult> results;
+        // Which of files each request reads from
+        std::vector<std::size_t> file_of;
+        std::vector<OpenFile> files;
+        std::vector<Op> ops;
+        std::promise<std::vector<ReadResult>> promise;
+        std::atomic<std::size_t> remaining = 0;
+        // Next request a pool thread should take; guarded by the reader's mutex
+        std::size_t next = 0;
+
+        explicit Batch(std::vector<ReadRequest>&& batch) :
+            requests(std::move(batch)), results(requests.size()), file_of(requests.size()), ops(requests.size()),
+            remaining(requests.size()) {
+            auto unique = std::unordered_map<std::filesystem::path::string_type, std::size_t>();
+            for (std::size_t i = 0; i < requests.size(); i++) {
+                auto [it, added] = unique.try_emplace(requests[i].path.native(), unique.size());
+                file_of[i]       = it->second;
+                ops[i].batch     = this;
+                ops[i].index     = i;
+            }
+            files = std::vector<OpenFile>(unique.size());
+            for (std::size_t i = 0; i < requests.size(); i++) {
+                files[file_of[i]].path = requests[i].path;
+            }
+        }
+
+        auto open(std::size_t index) -> OpenFile& {
+            auto& file = files[file_of[index]];
+            std::call_once(file.once, [&file] {
+                if (auto handle = open_native(file.path); handle) {
+                    file.handle = *handle;
+                } else {
+                    file.error = handle.error();
+                }
+            });
+            return file;
+        }
+
+        // True once the last request of the batch has completed
+        auto complete(std::size_t index, ReadResult result) -> bool {
+            if (requests[index].on_complete) {
+                requests[index].on_complete(result);
+            }
+            results[index] = std::move(result);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return false;
+            }
+            for (auto& file : files) {
+                if (file.handle != INVALID_HANDLE) {
+                    close_native(file.handle);
+                }
+            }
+            promise.set_value(std::move(results));
+            return true;
+        }
+};
+
+#ifdef __linux__
+// A raw io_uring. Only the reader's ring thread touches it once it is set up
+struct ENGINE_NS::fileio::AsyncReader::Ring {
+        int fd                   = -1;
+        void* sq_ring            = nullptr;
+        std::size_t sq_ring_size = 0;
+        void* cq_ring            = nullptr;
+        std::size_t cq_ring_size = 0;
+        io_uring_sqe* sqes       = nullptr;
+        std::size_t sqes_size    = 0;
+
+        std::uint32_t* sq_head  = nullptr;
+        std::uint32_t* sq_tail  = nullptr;
+        std::uint32_t sq_mask   = 0;
+        std::uint32_t* sq_array = nullptr;
+        std::uint32_t* cq_head  = nullptr;
+        std::uint32_t* cq_tail  = nullptr;
+        std::uint32_t cq_mask   = 0;
+        io_uring_cqe* cqes      = nullptr;
+        std::uint32_t entries   = 0;
+
+        static auto create(std::uint32_t entries) -> std::unique_ptr<Ring> {
+            auto params = io_uring_params{};
+            auto fd     = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) {
+                return nullptr;
+            }
+            auto ring     = std::make_unique<Ring>();
+            ring->fd      = fd;
+            ring->entries = params.sq_entries;
+
+            ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+            ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            auto single        = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) {
+                ring->sq_ring_size = ring->cq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+            }
+            ring->sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (ring->sq_ring == MAP_FAILED) {
+                ring->sq_ring = nullptr;
+                return nullptr;
+            }
+            if (single) {
+                ring->cq_ring = ring->sq_ring;
+            } else {
+                ring->cq_ring =
+                    mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+                if (ring->cq_ring == MAP_FAILED) {
+                    ring->cq_ring = nullptr;
+                    return nullptr;
+                }
+            }
+            ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            auto* sqes      = mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) {
+                return nullptr;
+            }
+            ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+            auto* sq       = static_cast<std::byte*>(ring->sq_ring);
+            auto* cq       = static_cast<std::byte*>(ring->cq_ring);
+            ring->sq_head  = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.head);
+            ring->sq_tail  = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+            ring->sq_mask  = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+            ring->sq_array = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+            ring->cq_head  = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+            ring->cq_tail  = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+            ring->cq_mask  = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+            ring->cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return ring;
+        }
+
+        ~Ring() {
+            if (sqes) {
+                munmap(sqes, sqes_size);
+            }
+            if (cq_ring && cq_ring != sq_ring) {
+                munmap(cq_ring, cq_ring_size);
+            }
+            if (sq_ring) {
+                munmap(sq_ring, sq_ring_size);
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+        auto queue_read(int file, Batch::Op& op, std::span<std::byte> destination, std::uint64_t offset) -> void {
+            auto tail = *sq_tail;
+            auto slot = tail & sq_mask;
+            // READV rather than READ so kernels back to 5.1 work; the iovec lives in the op until it completes
+            op.vector = iovec{destination.data(), destination.size()};
+
+            auto& sqe      = sqes[slot];
+            sqe            = io_uring_sqe{};
+            sqe.opcode     = IORING_OP_READV;
+            sqe.fd         = file;
+            sqe.off        = offset;
+            sqe.addr       = reinterpret_cast<std::uint64_t>(&op.vector);
+            sqe.len        = 1;
+            sqe.user_data  = reinterpret_cast<std::uint64_t>(&op);
+            sq_array[slot] = slot;
+            std::atomic_ref(*sq_tail).store(tail + 1, std::memory_order_release);
+        }
+
+        // Submit everything queued and, if wait is set, block until at least one read completes
+        auto enter(bool wait) -> void {
+            auto unsubmitted = *sq_tail - std::atomic_ref(*sq_head).load(std::memory_order_acquire);
+            if (unsubmitted == 0 && !wait) {
+                return;
+            }
+            auto flags = wait ? IORING_ENTER_GETEVENTS : 0u;
+            while (syscall(__NR_io_uring_enter, fd, unsubmitted, wait ? 1 : 0, flags, nullptr, 0) < 0 && errno == EINTR) {
+            }
+        }
+
+        template <typename TFunc>
+        auto reap(TFunc&& func) -> void {
+            auto head = *cq_head;
+            auto tail = std::atomic_ref(*cq_tail).load(std::memory_order_acquire);
+            for (; head != tail; head++) {
+                const auto& cqe = cqes[head & cq_mask];
+                func(*reinterpret_cast<Batch::Op*>(cqe.user_data), cqe.res);
+            }
+            std::atomic_ref(*cq_head).store(head, std::memory_order_release);
+        }
+};
+#else
+struct ENGINE_NS::fileio::AsyncReader::Ring {
+        static auto create(std::uint32_t) -> std::unique_ptr<Ring> {
+            return nullptr;
+        }
+};
+#endif
+
+ENGINE_NS::fileio::AsyncReader::AsyncReader(Backend backend, std::uint32_t queue_depth, std::size_t threads) :
+    backend_(backend), queue_depth_(std::max(queue_depth, 1u)) {
+    if (backend_ != Backend::THREAD_POOL) {
+        // Sandboxes and older kernels refuse io_uring outright, which is what the pool is for
+        ring_ = Ring::create(queue_depth_);
+    }
+    if (ring_) {
+        backend_ = Backend::IO_URING;
+        threads_.emplace_back([this] { ring_loop_(); });
+    } else {
+        backend_ = Backend::THREAD_POOL;
+        for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); i++) {
+            threads_.emplace_back([this, i] {
+                auto name = std::string(StaticNames::FileReaderThreadName) + " " + std::to_string(i);
+                tracy::SetThreadName(name.c_str());
+                pool_loop_();
+            });
+        }
+    }
+}
+
+ENGINE_NS::fileio::AsyncReader::~AsyncReader() {
+    {
+        auto lock = std::scoped_lock(mutex_);
+        running_  = false;
+    }
+    condition_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+auto ENGINE_NS::fileio::AsyncReader::submit(std::vector<ReadRequest> requests) -> std::future<std::vector<ReadResult>> {
+    ZoneScoped;
+    auto batch  = std::make_shared<Batch>(std::move(requests));
+    auto future = batch->promise.get_future();
+    if (batch->requests.empty()) {
+        batch->promise.set_value({});
+        return future;
+    }
+    {
+        auto lock = std::scoped_lock(mutex_);
+        queue_.push_back(std::move(batch));
+    }
+    if (backend_ == Backend::THREAD_POOL) {
+        condition_.notify_all();
+    } else {
+        condition_.notify_one();
+    }
+    return future;
+}
+
+auto ENGINE_NS::fileio::AsyncReader::backend() const -> Backend {
+    return backend_;
+}
+
+auto ENGINE_NS::fileio::AsyncReader::pool_loop_() -> void {
+    while (true) {
+        auto batch        = std::shared_ptr<Batch>();
+        std::size_t index = 0;
+        {
+            auto lock = std::unique_lock(mutex_);
+            condition_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            batch = queue_.front();
+            index = batch->next++;
+            if (batch->next == batch->requests.size()) {
+                queue_.pop_front();
+            }
+        }
+
+        ZoneScoped;
+        auto& file    = batch->open(index);
+        auto& request = batch->requests[index];
+        if (file.error) {
+            batch->complete(index, std::unexpected(*file.error));
+        } else {
+            batch->complete(index, read_native(file.handle, request.offset, request.destination));
+        }
+    }
+}
+
+auto ENGINE_NS::fileio::AsyncReader::ring_loop_() -> void {
+#ifdef __linux__
+    tracy::SetThreadName(StaticNames::FileReaderThreadName);
+    // Batches with reads outstanding, kept alive until their last read completes
+    auto active             = std::vector<std::shared_ptr<Batch>>();
+    auto ready              = std::deque<Batch::Op*>();
+    auto incoming           = std::vector<std::shared_ptr<Batch>>();
+    std::uint32_t in_flight = 0;
+
+    auto finish = [&active](Batch* batch, std::size_t index, ReadResult result) {
+        if (batch->complete(index, std::move(result))) {
+            std::erase_if(active, [batch](const auto& held) { return held.get() == batch; });
+        }
+    };
+
+    while (true) {
+        {
+            auto lock = std::unique_lock(mutex_);
+            if (ready.empty() && in_flight == 0) {
+                condition_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+            }
+            incoming.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.end()));
+            queue_.clear();
+        }
+
+        for (auto& batch : incoming) {
+            ZoneScopedN("Open batch");
+            active.push_back(batch);
+            auto* held = batch.get();
+            for (std::size_t i = 0; i < held->requests.size(); i++) {
+                auto& file = held->open(i);
+                if (file.error) {
+                    finish(held, i, std::unexpected(*file.error));
+                } else if (held->requests[i].destination.empty()) {
+                    finish(held, i, 0);
+                } else {
+                    ready.push_back(&held->ops[i]);
+                }
+            }
+        }
+        incoming.clear();
+
+        while (!ready.empty() && in_flight < ring_->entries) {
+            auto* op      = ready.front();
+            auto& request = op->batch->requests[op->index];
+            auto& file    = op->batch->files[op->batch->file_of[op->index]];
+            ring_->queue_read(file.handle, *op, request.destination.subspan(op->done), request.offset + op->done);
+            ready.pop_front();
+            in_flight++;
+        }
+        TracyPlot(StaticNames::FileReadsInFlight, static_cast<std::int64_t>(in_flight));
+        ring_->enter(in_flight > 0);
+
+        ring_->reap([&](Batch::Op& op, std::int32_t result) {
+            in_flight--;
+            auto* batch   = op.batch;
+            auto& request = batch->requests[op.index];
+            if (result == -EINTR || result == -EAGAIN) {
+                ready.push_front(&op);
+            } else if (result < 0) {
+                finish(batch, op.index, std::unexpected(error::Error::read(-result)));
+            } else if (result == 0 || op.done + static_cast<std::size_t>(result) == request.destination.size()) {
+                op.done += static_cast<std::size_t>(result);
+                finish(batch, op.index, op.done);
+            } else {
+                // Short read before the end of the file; queue the rest
+                op.done += static_cast<std::size_t>(result);
+                ready.push_front(&op);
+            }
+        });
+    }
+#endif
+}
@@ -0,0 +1,105 @@
+#include "engine/fileio/content_hash.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    constexpr std::array<std::uint64_t, 4> SECRET = {
+        0x2d358dccaa6c78a5ull,
+        0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull,
+        0x4d5a2da51de1aa47ull,
+    };
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ using Uint128 = unsigned __int128;
+#endif
+
+    // Full 64x64 -> 128 bit multiply, low half into a and high half into b
+    auto multiply(std::uint64_t& a, std::uint64_t& b) -> void {
+#if defined(__SIZEOF_INT128__)
+        auto product = static_cast<Uint128>(a) * b;
+        a            = static_cast<std::uint64_t>(product);
+        b            = static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        auto low      = (a & 0xffff'ffffull) * (b & 0xffff'ffffull);
+        auto middle_0 = (a >> 32) * (b & 0xffff'ffffull);
+        auto middle_1 = (a & 0xffff'ffffull) * (b >> 32);
+        auto high     = (a >> 32) * (b >> 32);
+        auto carry    = ((low >> 32) + (middle_0 & 0xffff'ffffull) + (middle_1 & 0xffff'ffffull)) >> 32;
+        a             = low + (middle_0 << 32) + (middle_1 << 32);
+        b             = high + (middle_0 >> 32) + (middle_1 >> 32) + carry;
+#endif
+    }
+
+    auto mix(std::uint64_t a, std::uint64_t b) -> std::uint64_t {
+        multiply(a, b);
+        return a ^ b;
+    }
+
+    template <typename T>
+    auto read(const std::byte* data) -> std::uint64_t {
+        T value{};
+        std::memcpy(&value, data, sizeof(value));
+        if constexpr (std::endian::native == std::endian::big) {
+            value = std::byteswap(value);
+        }
+        return value;
+    }
+} // namespace
+
+auto ENGINE_NS::fileio::content_hash(std::span<const std::byte> bytes, std::uint64_t seed) -> std::uint64_t {
+    const auto* data = bytes.data();
+    auto size        = bytes.size();
+    seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    if (size <= 16) {
+        if (size >= 4) {
+            // Two overlapping pairs of 4 byte reads cover every length from 4 to 16
+            auto step = (size >> 3) << 2;
+            a         = read<std::uint32_t>(data) << 32 | read<std::uint32_t>(data + step);
+            b         = read<std::uint32_t>(data + size - 4) << 32 | read<std::uint32_t>(data + size - 4 - step);
+        } else if (size > 0) {
+            a = std::uint64_t{static_cast<std::uint8_t>(data[0])} << 16 | std::uint64_t{static_cast<std::uint8_t>(data[size >> 1])} << 8 |
+                std::uint64_t{static_cast<std::uint8_t>(data[size - 1])};
+        }
+    } else {
+        auto remaining = size;
+        if (remaining > 48) {
+            auto lane_1 = seed;
+            auto lane_2 = seed;
+            do {
+                seed   = mix(read<std::uint64_t>(data) ^ SECRET[1], read<std::uint64_t>(data + 8) ^ seed);
+                lane_1 = mix(read<std::uint64_t>(data + 16) ^ SECRET[2], read<std::uint64_t>(data + 24) ^ lane_1);
+                lane_2 = mix(read<std::uint64_t>(data + 32) ^ SECRET[3], read<std::uint64_t>(data + 40) ^ lane_2);
+                data += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane_1 ^ lane_2;
+        }
+        while (remaining > 16) {
+            seed = mix(read<std::uint64_t>(data) ^ SECRET[1], read<std::uint64_t>(data + 8) ^ seed);
+            data += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes, overlapping what came before when the tail is short
+        a = read<std::uint64_t>(data + remaining - 16);
+        b = read<std::uint64_t>(data + remaining - 8);
+    }
+
+    a ^= SECRET[1];
+    b ^= seed;
+    multiply(a, b);
+    return mix(a ^ SECRET[0] ^ size, b ^ SECRET[1]);
+}
@@ -7,6 +7,10 @@
 #include <filesystem>
 #include <type_traits>
 
+#ifdef __linux__
+    #include <unistd.h>
+#endif
+
 auto ENGINE_NS::fileio::File::open(const std::filesystem::path& path, OpenMode open_mode, IoMode io_mode)
     -> std::expected<File, error::Error> {
     char mode[] = "\0\0\0";
@@ -184,6 +188,171 @@ auto ENGINE_NS::fileio::File::move_to_offset(Offset offset) -> std::expected<voi
     return std::expected<void, error::Error>{};
 }
 
+auto ENGINE_NS::fileio::File::readv(std::span<const std::span<std::byte>> buffers) -> std::expected<std::size_t, error::Error> {
+    std::size_t total = 0;
+    for (auto buffer : buffers) {
+        auto read = read_(buffer.data(), 1, buffer.size());
+        if (!read) {
+            return std::unexpected(read.error());
+        }
+        total += *read;
+        if (*read != buffer.size()) {
+            break;
+        }
+    }
+    return total;
+}
+
+auto ENGINE_NS::fileio::File::writev(std::span<const std::span<const std::byte>> buffers) -> std::expected<void, error::Error> {
+    // The stream coalesces small buffers into one write and passes large ones straight through
+    for (auto buffer : buffers) {
+        if (auto err = write_(buffer.data(), 1, buffer.size()); !err) {
+            return err;
+        }
+    }
+    return std::expected<void, error::Error>{};
+}
+
+auto ENGINE_NS::fileio::File::read_(void* data, std::size_t size, std::size_t count) -> std::expected<std::size_t, error::Error> {
+    if (!handle_ || moved_) {
+        return 0;
+    }
+    if (!is_readable()) {
+        return std::unexpected(error::Error::not_readable());
+    }
+    if (count == 0) {
+        return 0;
+    }
+    auto read = std::fread(data, size, count, handle_);
+    if (std::ferror(handle_)) {
+        return std::unexpected(error::Error::indicator());
+    }
+    return read;
+}
+
+auto ENGINE_NS::fileio::File::write_(const void* data, std::size_t size, std::size_t count) -> std::expected<void, error::Error> {
+    if (!handle_ || moved_) {
+        return std::expected<void, error::Error>{};
+    }
+    if (!is_writable()) {
+        return std::unexpected(error::Error::not_writable());
+    }
+    if (count == 0) {
+        return std::expected<void, error::Error>{};
+    }
+    if (std::fwrite(data, size, count, handle_) != count) {
+        if (errno < 0) {
+            return std::unexpected(error::Error::write(errno));
+        } else {
+            return std::unexpected(error::Error::write());
+        }
+    }
+    return std::expected<void, error::Error>{};
+}
+
+auto ENGINE_NS::fileio::File::pread_(std::uint64_t offset, std::span<std::byte> buffer) -> std::expected<std::size_t, error::Error> {
+    if (!handle_ || moved_) {
+        return 0;
+    }
+    if (!is_readable()) {
+        return std::unexpected(error::Error::not_readable());
+    }
+    if (buffer.empty()) {
+        return 0;
+    }
+    if (is_writable()) {
+        if (auto err = flush(); !err) {
+            return std::unexpected(err.error());
+        }
+    }
+#ifdef _WIN32
+    // No positional read on a CRT stream, so seek there and back
+    auto start = position();
+    if (!start) {
+        return std::unexpected(start.error());
+    }
+    if (auto err = move_to(Position{offset}); !err) {
+        return std::unexpected(err.error());
+    }
+    auto read   = std::fread(buffer.data(), 1, buffer.size(), handle_);
+    auto failed = std::ferror(handle_);
+    if (auto err = move_to(start.value()); !err) {
+        return std::unexpected(err.error());
+    }
+    if (failed) {
+        return std::unexpected(error::Error::indicator());
+    }
+    return read;
+#elif __linux__
+    auto descriptor  = fileno(handle_);
+    std::size_t done = 0;
+    while (done < buffer.size()) {
+        auto read = ::pread(descriptor, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+        if (read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::unexpected(error::Error::read(errno));
+        }
+        if (read == 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(read);
+    }
+    return done;
+#else
+    #error "Unsupported OS"
+#endif
+}
+
+auto ENGINE_NS::fileio::File::pwrite_(std::uint64_t offset, std::span<const std::byte> buffer) -> std::expected<void, error::Error> {
+    if (!handle_ || moved_) {
+        return std::expected<void, error::Error>{};
+    }
+    if (!is_writable()) {
+        return std::unexpected(error::Error::not_writable());
+    }
+    if (buffer.empty()) {
+        return std::expected<void, error::Error>{};
+    }
+    if (auto err = flush(); !err) {
+        return err;
+    }
+#ifdef _WIN32
+    auto start = position();
+    if (!start) {
+        return std::unexpected(start.error());
+    }
+    if (auto err = move_to(Position{offset}); !err) {
+        return err;
+    }
+    auto written = std::fwrite(buffer.data(), 1, buffer.size(), handle_);
+    if (auto err = move_to(start.value()); !err) {
+        return err;
+    }
+    if (written != buffer.size()) {
+        return std::unexpected(error::Error::write());
+    }
+    return std::expected<void, error::Error>{};
+#elif __linux__
+    auto descriptor  = fileno(handle_);
+    std::size_t done = 0;
+    while (done < buffer.size()) {
+        auto written = ::pwrite(descriptor, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::unexpected(error::Error::write(errno));
+        }
+        done += static_cast<std::size_t>(written);
+    }
+    return std::expected<void, error::Error>{};
+#else
+    #error "Unsupported OS"
+#endif
+}
+
 auto ENGINE_NS::fileio::File::is_writable() const -> bool {
     using underlying = std::underlying_type_t<decltype(io_metadata_.io_mode)>;
     if (IoMode(static_cast<underlying>(io_metadata_.io_mode) & static_cast<underlying>(IoMode::WRITE)) == IoMode::WRITE) {
@@ -208,5 +377,5 @@ ENGINE_NS::fileio::File::File(IoMetadata io_metadata, FileMetadata file_metadata
 }
 
 auto ENGINE_NS::fileio::FileMetadata::dirty() const -> bool {
-    return false;
+    return changed && changed->load(std::memory_order_relaxed);
 }
@@ -0,0 +1,225 @@
+#include "engine/fileio/file_watcher.h"
+
+#include <common/TracySystem.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <optional>
+#include <system_error>
+
+#ifdef _WIN32
+#elif __linux__
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#else
+    #error "Unsupported OS"
+#endif
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    auto key_of(const std::filesystem::path& path) -> std::optional<std::string> {
+        auto ec       = std::error_code{};
+        auto absolute = std::filesystem::absolute(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        return absolute.lexically_normal().string();
+    }
+} // namespace
+
+ENGINE_NS::fileio::FileWatcher::FileWatcher(std::chrono::milliseconds batch_window) : batch_window_(batch_window) {
+#ifdef __linux__
+    inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_ < 0 || wake_ < 0) {
+        // Too many instances or a sandbox without inotify; files are simply never reported
+        if (inotify_ >= 0) {
+            ::close(inotify_);
+        }
+        if (wake_ >= 0) {
+            ::close(wake_);
+        }
+        inotify_ = -1;
+        wake_    = -1;
+        return;
+    }
+    thread_ = std::thread([this] {
+        tracy::SetThreadName(StaticNames::FileWatcherThreadName);
+        run_();
+    });
+#endif
+}
+
+ENGINE_NS::fileio::FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (thread_.joinable()) {
+        std::uint64_t one             = 1;
+        [[maybe_unused]] auto written = ::write(wake_, &one, sizeof(one));
+        thread_.join();
+    }
+    if (inotify_ >= 0) {
+        ::close(inotify_);
+        ::close(wake_);
+    }
+#endif
+}
+
+auto ENGINE_NS::fileio::FileWatcher::track(FileMetadata& metadata) -> std::expected<void, error::Error> {
+    auto key = key_of(metadata.path);
+    if (!key) {
+        return std::unexpected(error::Error::open());
+    }
+    auto flag        = std::make_shared<std::atomic<bool>>(false);
+    metadata.changed = flag;
+
+    auto lock = std::scoped_lock(mutex_);
+#ifdef __linux__
+    if (inotify_ >= 0) {
+        auto directory = std::filesystem::path(*key).parent_path();
+        auto dir_key   = directory.string();
+        if (!watches_.contains(dir_key)) {
+            auto mask  = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR;
+            auto watch = inotify_add_watch(inotify_, dir_key.c_str(), mask);
+            if (watch < 0) {
+                return std::unexpected(error::Error::open(errno));
+            }
+            watches_.emplace(dir_key, watch);
+            directories_.insert_or_assign(watch, std::move(directory));
+        }
+    }
+#endif
+    auto& tracked = tracked_[*key];
+    if (tracked.path.empty()) {
+        tracked.path = metadata.path;
+    }
+    std::erase_if(tracked.flags, [](const auto& tracked_flag) { return tracked_flag.expired(); });
+    tracked.flags.push_back(flag);
+    return std::expected<void, error::Error>{};
+}
+
+auto ENGINE_NS::fileio::FileWatcher::subscribe(Subscriber subscriber) -> SubscriptionId {
+    auto lock = std::scoped_lock(subscribers_mutex_);
+    auto id   = next_subscription_++;
+    subscribers_.emplace_back(id, std::move(subscriber));
+    return id;
+}
+
+auto ENGINE_NS::fileio::FileWatcher::unsubscribe(SubscriptionId id) -> void {
+    auto lock = std::scoped_lock(subscribers_mutex_);
+    std::erase_if(subscribers_, [id](const auto& subscriber) { return subscriber.first == id; });
+}
+
+auto ENGINE_NS::fileio::FileWatcher::available() const -> bool {
+    return inotify_ >= 0;
+}
+
+auto ENGINE_NS::fileio::FileWatcher::run_() -> void {
+#ifdef __linux__
+    auto pending  = std::vector<std::string>();
+    auto deadline = std::chrono::steady_clock::time_point{};
+    // Large enough for many events with names up to NAME_MAX per read
+    alignas(inotify_event) std::byte buffer[16 * 1024];
+    while (true) {
+        auto timeout = -1;
+        if (!pending.empty()) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            timeout        = static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+        }
+        pollfd fds[2]{};
+        fds[0].fd     = inotify_;
+        fds[0].events = POLLIN;
+        fds[1].fd     = wake_;
+        fds[1].events = POLLIN;
+        auto ready = ::poll(fds, 2, timeout);
+        if (ready < 0 && errno != EINTR) {
+            return;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            return;
+        }
+
+        if ((fds[0].revents & POLLIN) != 0) {
+            ZoneScopedN("Read file events");
+            if (pending.empty()) {
+                deadline = std::chrono::steady_clock::now() + batch_window_;
+            }
+            auto lock = std::scoped_lock(mutex_);
+            while (true) {
+                auto length = ::read(inotify_, buffer, sizeof(buffer));
+                if (length <= 0) {
+                    break;
+                }
+                for (auto offset = std::size_t{0}; offset < static_cast<std::size_t>(length);) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+                    if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                        // Events were dropped, so anything could have changed
+                        for (const auto& [key, tracked] : tracked_) {
+                            pending.push_back(key);
+                        }
+                        continue;
+                    }
+                    auto directory = directories_.find(event->wd);
+                    if (event->len == 0 || directory == directories_.end()) {
+                        continue;
+                    }
+                    pending.push_back((directory->second / event->name).string());
+                }
+            }
+        }
+
+        // Flushed by the clock rather than on a quiet poll, so a steady stream of events in a watched directory cannot
+        // hold a batch back
+        if (!pending.empty() && std::chrono::steady_clock::now() >= deadline) {
+            flush_(pending);
+        }
+    }
+#endif
+}
+
+auto ENGINE_NS::fileio::FileWatcher::flush_(std::vector<std::string>& changed) -> void {
+    ZoneScoped;
+    std::ranges::sort(changed);
+    auto duplicates = std::ranges::unique(changed);
+    changed.erase(duplicates.begin(), duplicates.end());
+
+    auto paths = std::vector<std::filesystem::path>();
+    {
+        auto lock = std::scoped_lock(mutex_);
+        for (const auto& key : changed) {
+            auto tracked = tracked_.find(key);
+            if (tracked == tracked_.end()) {
+                // Some other file in a watched directory
+                continue;
+            }
+            auto live = false;
+            for (const auto& weak_flag : tracked->second.flags) {
+                if (auto flag = weak_flag.lock()) {
+                    flag->store(true, std::memory_order_relaxed);
+                    live = true;
+                }
+            }
+            if (live) {
+                paths.push_back(tracked->second.path);
+            }
+            // Changed flags stay set, so nothing needs to keep them any more
+            tracked_.erase(tracked);
+        }
+    }
+    changed.clear();
+    if (paths.empty()) {
+        return;
+    }
+
+    auto subscribers = [&] {
+        auto lock = std::scoped_lock(subscribers_mutex_);
+        return subscribers_;
+    }();
+    for (const auto& [id, subscriber] : subscribers) {
+        subscriber(paths);
+    }
+}
@@ -0,0 +1,178 @@
+#include "engine/fileio/lz.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    constexpr std::size_t MIN_MATCH     = 4;
+    // The format requires the last bytes of a block to be literals, which keeps the decoder's match copy in bounds
+    constexpr std::size_t LAST_LITERALS = 5;
+    constexpr std::size_t MATCH_LIMIT   = 12;
+    constexpr std::size_t MAX_OFFSET    = 65'535;
+    constexpr std::size_t HASH_BITS     = 12;
+
+    auto read32(const std::byte* data) -> std::uint32_t {
+        std::uint32_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    auto hash(std::uint32_t sequence) -> std::uint32_t {
+        return (sequence * 2'654'435'761u) >> (32 - HASH_BITS);
+    }
+
+    // Writes into a fixed buffer, remembering if anything did not fit rather than checking after every byte
+    class Output {
+        public:
+            explicit Output(std::span<std::byte> buffer) : buffer_(buffer) {
+            }
+
+            auto put(std::uint8_t value) -> void {
+                if (size_ < buffer_.size()) {
+                    buffer_[size_] = std::byte{value};
+                }
+                size_++;
+            }
+            auto put(const std::byte* data, std::size_t count) -> void {
+                if (count > 0 && count <= buffer_.size() && size_ <= buffer_.size() - count) {
+                    std::memcpy(buffer_.data() + size_, data, count);
+                }
+                size_ += count;
+            }
+            // The low nibble part of a length has already gone in the token
+            auto put_length(std::size_t length) -> void {
+                for (; length >= 255; length -= 255) {
+                    put(255);
+                }
+                put(static_cast<std::uint8_t>(length));
+            }
+
+            auto size() const -> std::size_t {
+                return size_ <= buffer_.size() ? size_ : 0;
+            }
+
+        private:
+            std::span<std::byte> buffer_;
+            std::size_t size_ = 0;
+    };
+
+    auto put_sequence(Output& out, const std::byte* literals, std::size_t literal_count, std::size_t offset, std::size_t match) -> void {
+        auto literal_nibble = literal_count < 15 ? literal_count : 15;
+        auto match_nibble   = match == 0 ? 0 : (match - MIN_MATCH < 15 ? match - MIN_MATCH : 15);
+        out.put(static_cast<std::uint8_t>(literal_nibble << 4 | match_nibble));
+        if (literal_nibble == 15) {
+            out.put_length(literal_count - 15);
+        }
+        out.put(literals, literal_count);
+        if (match == 0) {
+            return;
+        }
+        out.put(static_cast<std::uint8_t>(offset & 0xff));
+        out.put(static_cast<std::uint8_t>(offset >> 8));
+        if (match_nibble == 15) {
+            out.put_length(match - MIN_MATCH - 15);
+        }
+    }
+
+    // Reads a 255-run length extension, failing if it runs off the end
+    auto read_length(const std::byte*& in, const std::byte* end, std::size_t& length) -> bool {
+        while (true) {
+            if (in == end) {
+                return false;
+            }
+            auto value = static_cast<std::uint8_t>(*in++);
+            length += value;
+            if (value != 255) {
+                return true;
+            }
+        }
+    }
+} // namespace
+
+auto ENGINE_NS::fileio::lz::compress(std::span<const std::byte> source, std::span<std::byte> destination) -> std::size_t {
+    auto out          = Output(destination);
+    const auto* input = source.data();
+    auto size         = source.size();
+
+    std::size_t anchor = 0;
+    if (size > MATCH_LIMIT) {
+        auto table = std::array<std::uint32_t, std::size_t{1} << HASH_BITS>{};
+        auto limit = size - MATCH_LIMIT;
+        for (std::size_t position = 0; position < limit;) {
+            auto sequence  = read32(input + position);
+            auto& slot     = table[hash(sequence)];
+            auto candidate = std::size_t{slot};
+            slot           = static_cast<std::uint32_t>(position);
+            if (candidate >= position || position - candidate > MAX_OFFSET || read32(input + candidate) != sequence) {
+                position++;
+                continue;
+            }
+
+            auto match = MIN_MATCH;
+            while (position + match < size - LAST_LITERALS && input[candidate + match] == input[position + match]) {
+                match++;
+            }
+            put_sequence(out, input + anchor, position - anchor, position - candidate, match);
+            position += match;
+            anchor = position;
+        }
+    }
+    put_sequence(out, input + anchor, size - anchor, 0, 0);
+    return out.size();
+}
+
+auto ENGINE_NS::fileio::lz::decompress(std::span<const std::byte> source, std::span<std::byte> destination) -> std::optional<std::size_t> {
+    const auto* in     = source.data();
+    const auto* in_end = source.data() + source.size();
+    auto* out          = destination.data();
+    auto* out_end      = destination.data() + destination.size();
+
+    while (in != in_end) {
+        auto token    = std::size_t{static_cast<std::uint8_t>(*in++)};
+        auto literals = token >> 4;
+        if (literals == 15 && !read_length(in, in_end, literals)) {
+            return std::nullopt;
+        }
+        if (literals > static_cast<std::size_t>(in_end - in) || literals > static_cast<std::size_t>(out_end - out)) {
+            return std::nullopt;
+        }
+        if (literals > 0) {
+            std::memcpy(out, in, literals);
+        }
+        in += literals;
+        out += literals;
+        if (in == in_end) {
+            // Only the last sequence may end without a match
+            break;
+        }
+
+        if (in_end - in < 2) {
+            return std::nullopt;
+        }
+        auto offset = std::size_t{static_cast<std::uint8_t>(in[0])} | std::size_t{static_cast<std::uint8_t>(in[1])} << 8;
+        in += 2;
+        auto match = token & 15;
+        if (match == 15 && !read_length(in, in_end, match)) {
+            return std::nullopt;
+        }
+        match += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<std::size_t>(out - destination.data()) || match > static_cast<std::size_t>(out_end - out)) {
+            return std::nullopt;
+        }
+
+        const auto* from = out - offset;
+        if (offset >= match) {
+            std::memcpy(out, from, match);
+            out += match;
+        } else {
+            // Overlapping matches repeat the last offset bytes, so they must be copied forwards one at a time
+            for (std::size_t i = 0; i < match; i++) {
+                *out++ = from[i];
+            }
+        }
+    }
+    return static_cast<std::size_t>(out - destination.data());
+}
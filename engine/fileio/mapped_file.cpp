@@ -0,0 +1,189 @@
+#include "engine/fileio/error.h"
+#include "engine/fileio/file.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #error "Unsupported OS"
+#endif
+
+namespace {
+    auto page_size() -> std::size_t {
+#ifdef _WIN32
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+#endif
+    }
+} // namespace
+
+auto ENGINE_NS::fileio::File::map(const std::filesystem::path& path, AccessHint hint) -> std::expected<MappedFile, error::Error> {
+    FileMetadata file_metadata{};
+    file_metadata.path = path;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::unexpected(error::Error::open());
+    }
+    LARGE_INTEGER length{};
+    if (!GetFileSizeEx(file, &length)) {
+        CloseHandle(file);
+        return std::unexpected(error::Error::map());
+    }
+    // The file can be renamed or removed while open, so this must not throw with the handle still held
+    auto last_write_error    = std::error_code{};
+    file_metadata.last_write = std::filesystem::last_write_time(path, last_write_error);
+    if (last_write_error) {
+        CloseHandle(file);
+        return std::unexpected(error::Error::map());
+    }
+    if (length.QuadPart == 0) {
+        CloseHandle(file);
+        return MappedFile(std::move(file_metadata), nullptr, 0, nullptr);
+    }
+
+    // The mapping object keeps the file open, so the file handle can go straight away
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::unexpected(error::Error::map());
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        return std::unexpected(error::Error::map());
+    }
+    auto mapped =
+        MappedFile(std::move(file_metadata), static_cast<const std::byte*>(data), static_cast<std::size_t>(length.QuadPart), mapping);
+#else
+    int file = ::open(reinterpret_cast<const char*>(path.u8string().c_str()), O_RDONLY | O_CLOEXEC);
+    if (file == -1) {
+        return std::unexpected(error::Error::open());
+    }
+    struct stat status{};
+    if (fstat(file, &status) == -1) {
+        auto error_code = errno;
+        ::close(file);
+        return std::unexpected(error::Error::map(error_code));
+    }
+    // The file can be renamed or removed while open, so this must not throw with the descriptor still held
+    auto last_write_error    = std::error_code{};
+    file_metadata.last_write = std::filesystem::last_write_time(path, last_write_error);
+    if (last_write_error) {
+        ::close(file);
+        return std::unexpected(error::Error::map(last_write_error.value()));
+    }
+    if (status.st_size == 0) {
+        // Zero length mappings are an error, but an empty file is still a valid thing to load
+        ::close(file);
+        return MappedFile(std::move(file_metadata), nullptr, 0, nullptr);
+    }
+
+    auto size       = static_cast<std::size_t>(status.st_size);
+    void* data      = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    auto error_code = errno;
+    // The mapping holds its own reference to the file
+    ::close(file);
+    if (data == MAP_FAILED) {
+        return std::unexpected(error::Error::map(error_code));
+    }
+    auto mapped = MappedFile(std::move(file_metadata), static_cast<const std::byte*>(data), size, nullptr);
+#endif
+
+    if (hint != AccessHint::NORMAL) {
+        mapped.advise(hint);
+    }
+    return mapped;
+}
+
+ENGINE_NS::fileio::MappedFile::MappedFile(MappedFile&& rhs) noexcept :
+    metadata_(std::move(rhs.metadata_)), data_(std::exchange(rhs.data_, nullptr)), size_(std::exchange(rhs.size_, 0)),
+    mapping_(std::exchange(rhs.mapping_, nullptr)) {
+}
+
+auto ENGINE_NS::fileio::MappedFile::operator=(MappedFile&& rhs) noexcept -> MappedFile& {
+    if (&rhs != this) {
+        release_();
+        metadata_ = std::move(rhs.metadata_);
+        data_     = std::exchange(rhs.data_, nullptr);
+        size_     = std::exchange(rhs.size_, 0);
+        mapping_  = std::exchange(rhs.mapping_, nullptr);
+    }
+    return *this;
+}
+
+ENGINE_NS::fileio::MappedFile::~MappedFile() {
+    release_();
+}
+
+auto ENGINE_NS::fileio::MappedFile::advise(AccessHint hint, std::size_t offset, std::size_t length) const -> void {
+    if (data_ == nullptr || offset >= size_) {
+        return;
+    }
+    length     = std::min(length, size_ - offset);
+    auto start = offset & ~(page_size() - 1);
+    length += offset - start;
+
+#ifdef _WIN32
+    // Windows only takes prefetch requests; the other hints have no equivalent for a view
+    if (hint == AccessHint::WILL_NEED) {
+        WIN32_MEMORY_RANGE_ENTRY range{const_cast<std::byte*>(data_) + start, length};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    auto advice = MADV_NORMAL;
+    switch (hint) {
+        case AccessHint::NORMAL:
+            advice = MADV_NORMAL;
+            break;
+        case AccessHint::SEQUENTIAL:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessHint::RANDOM:
+            advice = MADV_RANDOM;
+            break;
+        case AccessHint::WILL_NEED:
+            advice = MADV_WILLNEED;
+            break;
+        case AccessHint::DONT_NEED:
+            advice = MADV_DONTNEED;
+            break;
+    }
+    (void)madvise(const_cast<std::byte*>(data_) + start, length, advice);
+#endif
+}
+
+ENGINE_NS::fileio::MappedFile::MappedFile(FileMetadata file_metadata, const std::byte* data, std::size_t size, void* mapping) :
+    metadata_(std::move(file_metadata)), data_(data), size_(size), mapping_(mapping) {
+}
+
+auto ENGINE_NS::fileio::MappedFile::release_() -> void {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+    munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    data_    = nullptr;
+    size_    = 0;
+    mapping_ = nullptr;
+}
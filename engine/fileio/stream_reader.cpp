@@ -0,0 +1,247 @@
+#include "engine/fileio/stream_reader.h"
+
+#include <common/TracySystem.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif __linux__
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #error "Unsupported OS"
+#endif
+
+using namespace ::ENGINE_NS;
+
+namespace {
+#ifdef _WIN32
+    using NativeHandle                = HANDLE;
+    const NativeHandle INVALID_HANDLE = INVALID_HANDLE_VALUE;
+#else
+    using NativeHandle                    = int;
+    constexpr NativeHandle INVALID_HANDLE = -1;
+#endif
+
+    // Reads until buffer is full or the file ends
+    auto read_chunk(NativeHandle handle, std::uint64_t offset, std::span<std::byte> buffer)
+        -> std::expected<std::size_t, fileio::error::Error> {
+        std::size_t done = 0;
+        while (done < buffer.size()) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset     = static_cast<DWORD>(offset + done);
+            overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+            DWORD read            = 0;
+            auto request          = static_cast<DWORD>(std::min<std::size_t>(buffer.size() - done, 1u << 30));
+            if (!ReadFile(handle, buffer.data() + done, request, &read, &overlapped)) {
+                if (GetLastError() == ERROR_HANDLE_EOF) {
+                    break;
+                }
+                return std::unexpected(fileio::error::Error::read());
+            }
+#else
+            auto read = ::pread(handle, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+            if (read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return std::unexpected(fileio::error::Error::read(errno));
+            }
+#endif
+            if (read == 0) {
+                break;
+            }
+            done += static_cast<std::size_t>(read);
+        }
+        return done;
+    }
+} // namespace
+
+struct ENGINE_NS::fileio::StreamReader::State {
+        enum class Slot : std::uint8_t {
+            // Waiting for the reader thread
+            EMPTY,
+            // Holds a chunk the caller has not taken yet
+            FILLED,
+            // Handed out by next() and not to be touched until the following call
+            IN_USE
+        };
+        struct Buffer {
+                std::vector<std::byte> bytes;
+                std::uint64_t offset = 0;
+                std::size_t size     = 0;
+                Slot slot            = Slot::EMPTY;
+                std::optional<error::Error> error;
+        };
+
+        NativeHandle handle = INVALID_HANDLE;
+        std::uint64_t size  = 0;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::array<Buffer, 2> buffers;
+        // Buffer the caller takes next
+        std::size_t next     = 0;
+        std::uint64_t offset = 0;
+        bool stopping        = false;
+        bool finished        = false;
+        std::thread thread;
+
+        // Fill the buffers in turn, each as soon as the caller hands it back, until the file or an error ends it
+        auto run() -> void {
+            tracy::SetThreadName(StaticNames::StreamReaderThreadName);
+            std::uint64_t position = 0;
+            for (std::size_t index = 0;; index ^= 1) {
+                auto& buffer = buffers[index];
+                {
+                    auto lock = std::unique_lock(mutex);
+                    condition.wait(lock, [&] { return stopping || buffer.slot == Slot::EMPTY; });
+                    if (stopping) {
+                        return;
+                    }
+                }
+
+                auto read = [&] {
+                    ZoneScopedN("Read chunk");
+                    return read_chunk(handle, position, buffer.bytes);
+                }();
+                auto lock     = std::scoped_lock(mutex);
+                buffer.offset = position;
+                buffer.size   = read.value_or(0);
+                buffer.error  = read ? std::nullopt : std::optional(read.error());
+                buffer.slot   = Slot::FILLED;
+                position += buffer.size;
+                condition.notify_all();
+                // The file might still be growing after a short chunk, so only an empty one ends the stream
+                if (!read || buffer.size == 0) {
+                    return;
+                }
+            }
+        }
+};
+
+auto ENGINE_NS::fileio::StreamReader::open(const std::filesystem::path& path, std::size_t chunk_size)
+    -> std::expected<StreamReader, error::Error> {
+    ZoneScoped;
+    auto state = std::make_unique<State>();
+#ifdef _WIN32
+    state->handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (state->handle == INVALID_HANDLE) {
+        return std::unexpected(error::Error::open());
+    }
+    LARGE_INTEGER length{};
+    if (!GetFileSizeEx(state->handle, &length)) {
+        CloseHandle(state->handle);
+        return std::unexpected(error::Error::open());
+    }
+    state->size = static_cast<std::uint64_t>(length.QuadPart);
+#else
+    state->handle = ::open(reinterpret_cast<const char*>(path.u8string().c_str()), O_RDONLY | O_CLOEXEC);
+    if (state->handle == INVALID_HANDLE) {
+        return std::unexpected(error::Error::open(errno));
+    }
+    struct stat info{};
+    if (::fstat(state->handle, &info) != 0) {
+        auto code = errno;
+        ::close(state->handle);
+        return std::unexpected(error::Error::open(code));
+    }
+    state->size = static_cast<std::uint64_t>(info.st_size);
+    // Advice only; a file system that ignores it still reads correctly
+    ::posix_fadvise(state->handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    for (auto& buffer : state->buffers) {
+        buffer.bytes.resize(chunk_size);
+    }
+    auto* raw     = state.get();
+    state->thread = std::thread([raw] { raw->run(); });
+    return StreamReader(std::move(state));
+}
+
+ENGINE_NS::fileio::StreamReader::StreamReader(std::unique_ptr<State> state) : state_(std::move(state)) {
+}
+
+ENGINE_NS::fileio::StreamReader::StreamReader(StreamReader&& rhs) noexcept : state_(std::move(rhs.state_)) {
+}
+
+auto ENGINE_NS::fileio::StreamReader::operator=(StreamReader&& rhs) noexcept -> StreamReader& {
+    if (&rhs != this) {
+        close_();
+        state_ = std::move(rhs.state_);
+    }
+    return *this;
+}
+
+ENGINE_NS::fileio::StreamReader::~StreamReader() {
+    close_();
+}
+
+auto ENGINE_NS::fileio::StreamReader::close_() -> void {
+    if (!state_) {
+        return;
+    }
+    {
+        auto lock        = std::scoped_lock(state_->mutex);
+        state_->stopping = true;
+    }
+    state_->condition.notify_all();
+    state_->thread.join();
+#ifdef _WIN32
+    CloseHandle(state_->handle);
+#else
+    ::close(state_->handle);
+#endif
+    state_.reset();
+}
+
+auto ENGINE_NS::fileio::StreamReader::next() -> std::expected<std::span<const std::byte>, error::Error> {
+    ZoneScoped;
+    if (!state_ || state_->finished) {
+        return std::span<const std::byte>{};
+    }
+    auto lock     = std::unique_lock(state_->mutex);
+    auto& current = state_->buffers[state_->next];
+    auto& other   = state_->buffers[state_->next ^ 1];
+    // The chunk handed out last time is done with, so the reader thread may refill it
+    if (other.slot == State::Slot::IN_USE) {
+        other.slot = State::Slot::EMPTY;
+        state_->condition.notify_all();
+    }
+    if (current.slot != State::Slot::FILLED) {
+        ZoneScopedN("Wait for chunk");
+        state_->condition.wait(lock, [&] { return current.slot == State::Slot::FILLED; });
+    }
+
+    current.slot   = State::Slot::IN_USE;
+    state_->offset = current.offset;
+    state_->next ^= 1;
+    if (current.error) {
+        state_->finished = true;
+        return std::unexpected(*current.error);
+    }
+    if (current.size == 0) {
+        state_->finished = true;
+    }
+    return std::span<const std::byte>(current.bytes.data(), current.size);
+}
+
+auto ENGINE_NS::fileio::StreamReader::size() const -> std::uint64_t {
+    return state_ ? state_->size : 0;
+}
+
+auto ENGINE_NS::fileio::StreamReader::offset() const -> std::uint64_t {
+    return state_ ? state_->offset : 0;
+}
@@ -0,0 +1,86 @@
+#include "engine/fileio/virtual_file_system.h"
+
+#include <tracy/Tracy.hpp>
+#include <string>
+#include <utility>
+
+auto ENGINE_NS::fileio::VirtualFileSystem::mount(const std::filesystem::path& archive_path) -> std::expected<void, error::Error> {
+    auto archive = Archive::open(archive_path);
+    if (!archive) {
+        return std::unexpected(archive.error());
+    }
+    mount(std::move(archive.value()));
+    return std::expected<void, error::Error>{};
+}
+
+auto ENGINE_NS::fileio::VirtualFileSystem::mount(Archive&& archive) -> void {
+    archives_.push_back(std::move(archive));
+}
+
+auto ENGINE_NS::fileio::VirtualFileSystem::open(const std::filesystem::path& path) const -> std::expected<VirtualFile, error::Error> {
+    ZoneScoped;
+    if (!archives_.empty()) {
+        auto normal = archive::normalise(path);
+        for (auto archive = archives_.rbegin(); archive != archives_.rend(); ++archive) {
+            if (auto blob = archive->find_normalised(normal)) {
+                FileMetadata file_metadata{};
+                file_metadata.path       = path;
+                file_metadata.last_write = archive->metadata().last_write;
+                if (blob->compression == archive::Compression::NONE) {
+                    return VirtualFile(std::move(file_metadata), blob->stored);
+                }
+                auto unpacked = std::vector<std::byte>(static_cast<std::size_t>(blob->size));
+                if (!archive::unpack(*blob, unpacked, jobs_)) {
+                    return std::unexpected(error::Error::invalid_archive());
+                }
+                return VirtualFile(std::move(file_metadata), std::move(unpacked));
+            }
+        }
+    }
+
+    auto mapped = File::map(path, AccessHint::SEQUENTIAL);
+    if (!mapped) {
+        return std::unexpected(mapped.error());
+    }
+    return VirtualFile(std::move(mapped.value()));
+}
+
+auto ENGINE_NS::fileio::VirtualFileSystem::exists(const std::filesystem::path& path) const -> bool {
+    if (!archives_.empty()) {
+        auto normal = archive::normalise(path);
+        for (const auto& archive : archives_) {
+            if (archive.find_normalised(normal)) {
+                return true;
+            }
+        }
+    }
+    auto ec = std::error_code{};
+    return std::filesystem::is_regular_file(path, ec);
+}
+
+ENGINE_NS::fileio::VirtualFile::VirtualFile(VirtualFile&& rhs) noexcept :
+    metadata_(std::move(rhs.metadata_)), loose_(std::move(rhs.loose_)), unpacked_(std::move(rhs.unpacked_)),
+    bytes_(std::exchange(rhs.bytes_, {})) {
+}
+
+auto ENGINE_NS::fileio::VirtualFile::operator=(VirtualFile&& rhs) noexcept -> VirtualFile& {
+    if (&rhs != this) {
+        metadata_ = std::move(rhs.metadata_);
+        loose_    = std::move(rhs.loose_);
+        unpacked_ = std::move(rhs.unpacked_);
+        bytes_    = std::exchange(rhs.bytes_, {});
+    }
+    return *this;
+}
+
+ENGINE_NS::fileio::VirtualFile::VirtualFile(FileMetadata file_metadata, std::span<const std::byte> bytes) :
+    metadata_(std::move(file_metadata)), bytes_(bytes) {
+}
+
+ENGINE_NS::fileio::VirtualFile::VirtualFile(FileMetadata file_metadata, std::vector<std::byte>&& unpacked) :
+    metadata_(std::move(file_metadata)), unpacked_(std::move(unpacked)), bytes_(unpacked_) {
+}
+
+ENGINE_NS::fileio::VirtualFile::VirtualFile(MappedFile&& file) :
+    metadata_(file.metadata), loose_(std::move(file)), bytes_(loose_->bytes()) {
+}
@@ -54,18 +54,24 @@ void ENGINE_NS::GraphicsEngine::initialise() {
     logger.get().info("Initialising Vulkan");
     init_vulkan_();
 
+    // Named so they can be told apart in the profiler's lock view
+    imgui.set_name("imgui");
+    new_pipelines_.set_name("new_pipelines_");
+    for (auto& frame : frames_) {
+        frame.set_name("frames_");
+    }
+
     logger.get().info("Initialising render thread");
     {
         ZoneScoped;
         running_.store(true, std::memory_order_release);
-        update_rate_   = std::chrono::milliseconds(8);
         render_thread_ = std::thread(&ENGINE_NS::GraphicsEngine::draw_, this);
     }
 
     logger.get().info("Initialising upload thread");
     {
         ZoneScoped;
-        upload_ready_.store(false, std::memory_order_release);
+        upload_ready_  = false;
         upload_thread_ = std::thread(&ENGINE_NS::GraphicsEngine::upload_, this);
     }
 
@@ -77,7 +83,8 @@ void ENGINE_NS::GraphicsEngine::initialise() {
 
     init_immediates_();
 
-    initialised_ = true;
+    initialised_.store(true, std::memory_order_release);
+    initialised_.notify_all();
 
     FrameMarkEnd(StaticNames::GraphicsInit);
 }
@@ -94,6 +101,8 @@ void ENGINE_NS::GraphicsEngine::draw() {
             lock.get().latest_draw = draw_data;
         }
     }
+    frame_requests_.fetch_add(1, std::memory_order_release);
+    frame_requests_.notify_one();
 
     FrameMarkEnd(StaticNames::GraphicsDraw);
 }
@@ -105,31 +114,40 @@ void ENGINE_NS::GraphicsEngine::cleanup() {
     if (g_ENGINE->crashed) {
         logger.get().warning("Opening all locked resources by force");
         imgui.unsafe_open_all_locks();
-        registered_pipelines_.unsafe_open_all_locks();
-        in_use_pipelines_.unsafe_open_all_locks();
-        to_delete_pipelines_.unsafe_open_all_locks();
-        mesh_uploads_.unsafe_open_all_locks();
         for (auto& frame : frames_) {
             frame.unsafe_open_all_locks();
         }
     }
 
+    // Threads still waiting on initialise see running_ cleared once released
+    this->running_.store(false, std::memory_order_release);
+    this->initialised_.store(true, std::memory_order_release);
+    this->initialised_.notify_all();
+
     logger.get().info("Stopping render thread");
     {
         ZoneScoped;
-        if (this->running_.load(std::memory_order_acquire)) {
-            this->running_.store(false, std::memory_order_release);
+        if (this->render_thread_.joinable()) {
+            this->frame_requests_.fetch_add(1, std::memory_order_release);
+            this->frame_requests_.notify_all();
             this->render_thread_.join();
         }
     }
     logger.get().info("Stopping upload thread");
     {
         ZoneScoped;
+        {
+            std::scoped_lock lock(this->upload_lock_);
+        }
+        this->upload_condition_.notify_all();
         this->upload_thread_.join();
     }
     logger.get().info("Stopping compile thread");
     {
         ZoneScoped;
+        {
+            std::scoped_lock lock(this->pipeline_compile_lock_);
+        }
         this->pipeline_compile_condition_.notify_all();
         this->pipeline_compile_thread_.join();
     }
@@ -139,15 +157,11 @@ void ENGINE_NS::GraphicsEngine::cleanup() {
         vkDeviceWaitIdle(device_.device);
         {
             ZoneScopedN(StaticNames::DeleteRegisteredPipelines);
-            auto to_delete_pipelines = to_delete_pipelines_.read();
-            for (const auto& to_delete : to_delete_pipelines.get()) {
-                to_delete->destroy(device_, allocator_);
-            }
-
-            auto registered_pipelines = registered_pipelines_.read();
-            for (const auto& [_, pipeline] : registered_pipelines.get()) {
-                pipeline->destroy(device_, allocator_);
+            // Dropping the last references runs each pipeline's destroy
+            for (auto& frame : frames_) {
+                frame.write().get().pipelines.reset();
             }
+            registered_pipelines_.publish({});
         }
 
         for (std::size_t idx = 0; idx < graphics::FRAME_OVERLAP; idx++) {
@@ -179,7 +193,7 @@ void ENGINE_NS::GraphicsEngine::cleanup() {
         SDL_DestroyWindow(window_);
     }
 
-    initialised_ = false;
+    initialised_.store(false, std::memory_order_release);
     FrameMarkEnd(StaticNames::GraphicsDeinit);
 }
 
@@ -253,12 +267,11 @@ auto ENGINE_NS::GraphicsEngine::upload_mesh(std::span<std::uint32_t> indices, st
     upload.indices  = std::vector<std::uint32_t>(indices.begin(), indices.end());
     upload.vertices = std::vector<Vertex>(vertices.begin(), vertices.end());
 
-    auto lock     = mesh_uploads_.write();
-    auto& uploads = lock.get();
-    uploads.push_back(std::move(upload));
-    auto future = uploads.back().promise.get_future();
+    auto future = upload.promise.get_future();
+    mesh_uploads_.push(std::move(upload));
+    TracyPlot(StaticNames::MeshUploadQueueDepth, static_cast<std::int64_t>(mesh_uploads_.size()));
 
-    upload_ready_.store(true, std::memory_order_release);
+    notify_upload_();
     return future;
 }
 
@@ -271,26 +284,25 @@ auto ENGINE_NS::GraphicsEngine::upload_image(void* data, VkExtent3D size, VkForm
     upload.texture_data = data;
     upload.usage        = usage;
 
-    auto lock     = texture_uploads_.write();
-    auto& uploads = lock.get();
-    uploads.push_back(std::move(upload));
-    auto future = uploads.back().promise.get_future();
+    auto future = upload.promise.get_future();
+    texture_uploads_.push(std::move(upload));
+    TracyPlot(StaticNames::TextureUploadQueueDepth, static_cast<std::int64_t>(texture_uploads_.size()));
 
-    upload_ready_.store(true, std::memory_order_release);
+    notify_upload_();
 
     return future;
 }
 
 auto ENGINE_NS::GraphicsEngine::pause_registered_pipelines() -> void {
-    auto registered_pipelines = registered_pipelines_.write();
-    for (const auto& [_, pipeline] : registered_pipelines.get()) {
+    auto registered_pipelines = registered_pipelines_.read();
+    for (const auto& [_, pipeline] : *registered_pipelines) {
         pipeline->paused_.fetch_add(1, std::memory_order_release);
     }
 }
 
 auto ENGINE_NS::GraphicsEngine::resume_registered_pipelines() -> void {
-    auto registered_pipelines = registered_pipelines_.write();
-    for (const auto& [_, pipeline] : registered_pipelines.get()) {
+    auto registered_pipelines = registered_pipelines_.read();
+    for (const auto& [_, pipeline] : *registered_pipelines) {
         pipeline->paused_.fetch_sub(1, std::memory_order_release);
     }
 }
@@ -302,16 +314,21 @@ auto ENGINE_NS::GraphicsEngine::register_pipelines(std::vector<std::unique_ptr<g
     for (auto& pipeline : pipelines) {
         std::uint64_t pipeline_uid = this->next_pipeline_uid_++;
         pipeline->id_              = pipeline_uid;
+        ids.push_back(pipeline_uid);
         new_pipelines.get().push_back(std::move(pipeline));
     }
+    new_pipelines.drop();
+    // The compile thread checks for work under this lock, so taking it orders the push before its next check
+    {
+        std::scoped_lock lock(pipeline_compile_lock_);
+    }
     pipeline_compile_condition_.notify_one();
     return graphics::RegisteredPipelineReceipt(*this, std::move(ids));
 }
 
 auto ENGINE_NS::GraphicsEngine::deregister_pipelines(std::vector<std::uint64_t>& ids) -> void {
+    auto ids_set = tsl::robin_set<std::uint64_t>{ids.begin(), ids.end()};
     {
-        auto ids_set = tsl::robin_set<std::uint64_t>{ids.begin(), ids.end()};
-
         auto new_pipelines_lock = new_pipelines_.write();
         auto& new_pipelines     = new_pipelines_lock.get();
         new_pipelines.erase(
@@ -320,15 +337,17 @@ auto ENGINE_NS::GraphicsEngine::deregister_pipelines(std::vector<std::uint64_t>&
                            [&ids_set](std::unique_ptr<graphics::RegisteredPipeline>& pipeline) { return ids_set.contains(pipeline->id_); }),
             new_pipelines.end());
     }
-
     {
-        auto to_delete_pipelines  = to_delete_pipelines_.write();
-        auto registered_pipelines = registered_pipelines_.write();
-        for (auto& pipeline : ids) {
-            to_delete_pipelines.get().emplace_back(std::move(registered_pipelines.get().at(pipeline)));
-            registered_pipelines.get().erase(pipeline);
-        }
+        std::scoped_lock lock(pipeline_compile_lock_);
+        std::erase_if(compiling_pipelines_, [&ids_set](std::uint64_t id) { return ids_set.contains(id); });
     }
+
+    // Frames still in flight keep their own references, so the pipelines are destroyed once those frames retire
+    registered_pipelines_.update([&ids_set](graphics::PipelineRegistry& registry) {
+        for (auto id : ids_set) {
+            registry.erase(id);
+        }
+    });
 }
 
 auto ENGINE_NS::GraphicsEngine::init_thread_(graphics::Thread thread) -> void {
@@ -641,8 +660,7 @@ auto ENGINE_NS::GraphicsEngine::draw_registered_(RwDataMut<graphics::FrameData>&
 
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-    auto registered_pipelines = registered_pipelines_.read();
-    for (const auto& [id, pipeline] : registered_pipelines.get()) {
+    for (const auto& [_, pipeline] : *frame.get().pipelines) {
         ZoneScoped;
         if (!pipeline->enabled) {
             continue;
@@ -681,8 +699,6 @@ auto ENGINE_NS::GraphicsEngine::draw_registered_(RwDataMut<graphics::FrameData>&
             }
             pipeline->record_compute(cmd);
         }
-
-        frame.get().in_use_pipelines.push_back(id);
     }
 
     vkCmdEndRendering(cmd);
@@ -693,12 +709,19 @@ auto ENGINE_NS::GraphicsEngine::draw_() -> void {
     init_thread_(graphics::Thread::DRAW);
     constexpr std::uint32_t TIMEOUT = 250'000'000;
 
-    while (!initialised_) {
-    }
+    initialised_.wait(false, std::memory_order_acquire);
 
+    std::uint64_t handled_request = 0;
     while (running_.load(std::memory_order_acquire)) {
+        // Sleep until the main loop asks for a frame. Requests made while drawing are folded into the next frame;
+        // presentation is FIFO so the swapchain paces the rest
+        frame_requests_.wait(handled_request, std::memory_order_acquire);
+        handled_request = frame_requests_.load(std::memory_order_acquire);
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+
         FrameMarkStart(StaticNames::RenderLoop);
-        auto frame_start = std::chrono::high_resolution_clock::now();
         {
             auto frame = current_frame().read();
             VK_CHECK(vkWaitForFences(device_.device, 1, &frame.get().render_fence_, true, TIMEOUT));
@@ -736,17 +759,9 @@ auto ENGINE_NS::GraphicsEngine::draw_() -> void {
 
                 transition_image(cmd, draw_image_.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-                {
-                    auto in_use_pipelines = in_use_pipelines_.write();
-                    for (auto& pipeline_id : frame.get().in_use_pipelines) {
-                        in_use_pipelines.get().at(pipeline_id) -= 1;
-                    }
-                    frame.get().in_use_pipelines.clear();
-                    draw_registered_(frame, cmd);
-                    for (auto& pipeline_id : frame.get().in_use_pipelines) {
-                        in_use_pipelines.get().at(pipeline_id) += 1;
-                    }
-                }
+                // The fence wait above retired this frame's previous snapshot, so pipelines only it referenced are freed here
+                frame.get().pipelines = registered_pipelines_.read();
+                draw_registered_(frame, cmd);
 
                 transition_image(cmd, draw_image_.image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
                 transition_image(cmd,
@@ -787,23 +802,6 @@ auto ENGINE_NS::GraphicsEngine::draw_() -> void {
 
             VK_CHECK(vkQueuePresentKHR(graphics_queue_, &present_info));
         }
-        {
-            ZoneScopedN(StaticNames::DeleteRegisteredPipelines);
-            auto to_delete_pipelines = to_delete_pipelines_.read();
-            auto in_use_pipelines    = in_use_pipelines_.write();
-            for (const auto& to_delete : to_delete_pipelines.get()) {
-                if (in_use_pipelines.get().at(to_delete->id_) != 0) {
-                    continue;
-                }
-                in_use_pipelines.get().erase(to_delete->id_);
-                to_delete->destroy(device_, allocator_);
-            }
-        }
-        auto frame_delta = std::chrono::high_resolution_clock::now() - frame_start;
-        if (frame_delta < this->update_rate_) {
-            auto sleep = this->update_rate_ - frame_delta;
-            std::this_thread::sleep_for(sleep);
-        }
         frame_number_.fetch_add(1, std::memory_order_release);
         FrameMarkEnd(StaticNames::RenderLoop);
     }
@@ -813,40 +811,35 @@ auto ENGINE_NS::GraphicsEngine::upload_() -> void {
     tracy::SetThreadName(StaticNames::UploadThreadName);
     init_thread_(graphics::Thread::UPLOAD);
 
-    while (!initialised_) {
-    }
+    initialised_.wait(false, std::memory_order_acquire);
 
     std::vector<graphics::StagingBuffer> staging_buffers;
     constexpr std::size_t MAX_CACHED_STAGING_BUFFER_SIZE = 1ull * 1'024 * 1'024 * 1'024;
 
     while (running_.load(std::memory_order_acquire)) {
-        FrameMarkStart(StaticNames::UploadLoop);
-        auto enter_time       = std::chrono::steady_clock::now();
-        bool has_time_elapsed = false;
-        while (running_.load(std::memory_order_acquire) && !upload_ready_.load(std::memory_order_acquire)) {
-            auto dt = std::chrono::steady_clock::now() - enter_time;
-            if (!has_time_elapsed && dt > std::chrono::minutes(1)) {
-                {
-                    auto logger = g_ENGINE->logger.get(LogNamespaces::GRAPHICS);
-                    logger.get().debug("Freeing cached staging buffers");
-                }
-                has_time_elapsed = true;
+        {
+            std::unique_lock lock(upload_lock_);
+            auto has_work = [&] { return !running_.load(std::memory_order_acquire) || upload_ready_; };
+            if (!upload_condition_.wait_for(lock, std::chrono::minutes(1), has_work)) {
+                // Idle for a while: give the cached staging memory back, then sleep until there is work again
+                lock.unlock();
+                g_ENGINE->logger.debug(LogNamespaces::GRAPHICS, "Freeing cached staging buffers");
                 for (auto& staging : staging_buffers) {
                     upload_deletion_queue_.push(staging.allocation);
                     vmaUnmapMemory(allocator_, staging.allocation.allocation);
                 }
                 upload_deletion_queue_.flush(device_, allocator_);
                 staging_buffers.clear();
+                lock.lock();
+                upload_condition_.wait(lock, has_work);
             }
-            if (dt > std::chrono::seconds(1)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            } else {
-                std::this_thread::yield();
-            }
+            // Cleared before draining so a request pushed while this batch uploads triggers another pass
+            upload_ready_ = false;
         }
-        if (!running_) {
+        if (!running_.load(std::memory_order_acquire)) {
             break;
         }
+        FrameMarkStart(StaticNames::UploadLoop);
 
         upload_meshes_(staging_buffers);
         upload_textures_(staging_buffers);
@@ -870,7 +863,6 @@ auto ENGINE_NS::GraphicsEngine::upload_() -> void {
             }
             upload_deletion_queue_.flush(device_, allocator_);
         }
-        upload_ready_ = false;
         FrameMarkEnd(StaticNames::UploadLoop);
     }
 
@@ -880,17 +872,22 @@ auto ENGINE_NS::GraphicsEngine::upload_() -> void {
     }
 }
 
-auto ENGINE_NS::GraphicsEngine::upload_meshes_(std::vector<graphics::StagingBuffer>& staging_buffers) -> void {
-    ZoneScoped;
-    auto lock     = mesh_uploads_.write();
-    auto& uploads = lock.get();
+auto ENGINE_NS::GraphicsEngine::notify_upload_() -> void {
     {
-        auto logger = g_ENGINE->logger.get(LogNamespaces::GRAPHICS);
-        logger.get().debug("Uploading {} meshes", uploads.size());
+        std::scoped_lock lock(upload_lock_);
+        upload_ready_ = true;
     }
-    while (!uploads.empty()) {
+    upload_condition_.notify_one();
+}
+
+auto ENGINE_NS::GraphicsEngine::upload_meshes_(std::vector<graphics::StagingBuffer>& staging_buffers) -> void {
+    ZoneScoped;
+    g_ENGINE->logger.debug(LogNamespaces::GRAPHICS, "Uploading {} meshes", mesh_uploads_.size());
+    // Producers keep pushing while this drains; nothing here blocks them
+    while (auto upload = mesh_uploads_.try_pop()) {
         ZoneScoped;
-        auto& mesh = uploads.back();
+        TracyPlot(StaticNames::MeshUploadQueueDepth, static_cast<std::int64_t>(mesh_uploads_.size()));
+        auto& mesh = *upload;
 
         const std::size_t vertex_buffer_size = mesh.vertices.size() * sizeof(Vertex);
         const std::size_t index_buffer_size  = mesh.indices.size() * sizeof(std::uint32_t);
@@ -948,22 +945,16 @@ auto ENGINE_NS::GraphicsEngine::upload_meshes_(std::vector<graphics::StagingBuff
         });
 
         mesh.promise.set_value(std::move(new_surface));
-
-        uploads.pop_back();
     }
 }
 
 auto ENGINE_NS::GraphicsEngine::upload_textures_(std::vector<graphics::StagingBuffer>& staging_buffers) -> void {
     ZoneScoped;
-    auto lock     = texture_uploads_.write();
-    auto& uploads = lock.get();
-    {
-        auto logger = g_ENGINE->logger.get(LogNamespaces::GRAPHICS);
-        logger.get().debug("Uploading {} textures", uploads.size());
-    }
-    while (!uploads.empty()) {
+    g_ENGINE->logger.debug(LogNamespaces::GRAPHICS, "Uploading {} textures", texture_uploads_.size());
+    while (auto upload = texture_uploads_.try_pop()) {
         ZoneScoped;
-        auto& texture = uploads.back();
+        TracyPlot(StaticNames::TextureUploadQueueDepth, static_cast<std::int64_t>(texture_uploads_.size()));
+        auto& texture = *upload;
 
         std::size_t data_size            = static_cast<std::size_t>(texture.size.width * texture.size.depth * texture.size.height * 4);
         graphics::StagingBuffer* staging = nullptr;
@@ -1010,7 +1001,6 @@ auto ENGINE_NS::GraphicsEngine::upload_textures_(std::vector<graphics::StagingBu
         });
 
         texture.promise.set_value(std::move(new_image));
-        uploads.pop_back();
     }
 }
 
@@ -1018,10 +1008,8 @@ auto ENGINE_NS::GraphicsEngine::compile_() -> void {
     tracy::SetThreadName(StaticNames::CompileThreadName);
     init_thread_(graphics::Thread::COMPILE);
 
-    while (!initialised_) {
-    }
+    initialised_.wait(false, std::memory_order_acquire);
 
-    auto logger = ENGINE_NS::g_ENGINE->logger.get(ENGINE_NS::LogNamespaces::GRAPHICS);
     while (running_.load(std::memory_order_acquire)) {
         std::unique_lock lock(pipeline_compile_lock_);
         pipeline_compile_condition_.wait(lock,
@@ -1031,25 +1019,54 @@ auto ENGINE_NS::GraphicsEngine::compile_() -> void {
         }
         ZoneScopedN(StaticNames::CompileRun);
 
+        auto pending = std::vector<std::unique_ptr<graphics::RegisteredPipeline>>();
         {
-            auto new_pipelines        = new_pipelines_.write();
-            auto in_use_pipelines     = in_use_pipelines_.write();
-            auto registered_pipelines = registered_pipelines_.write();
-            logger.get().debug("Compiling {} pipeline(s)", new_pipelines.get().size());
-            while (!new_pipelines.get().empty()) {
-                ZoneScoped;
-                std::unique_ptr<graphics::RegisteredPipeline> pipeline = std::move(new_pipelines.get().back());
-                new_pipelines.get().pop_back();
-
-                logger.get().debug(R"(Compiling pipeline "{}" with id "{}")", pipeline->name(), pipeline->id_);
+            auto new_pipelines = new_pipelines_.write();
+            pending            = std::move(new_pipelines.get());
+            new_pipelines.get().clear();
+        }
+        for (const auto& pipeline : pending) {
+            compiling_pipelines_.push_back(pipeline->id_);
+        }
+        // Waiting on parallel_for runs other queued jobs on this thread, and any of them may register pipelines, so
+        // nothing can stay locked while compiling
+        lock.unlock();
+        ENGINE_NS::g_ENGINE->logger.debug(ENGINE_NS::LogNamespaces::GRAPHICS, "Compiling {} pipeline(s)", pending.size());
 
-                auto pipeline_id = pipeline->id_;
+        // Pipelines are independent of each other so they are built across the job system. Job workers are not
+        // graphics threads: init_pipeline must not immediate_submit
+        ENGINE_NS::g_ENGINE->jobs.parallel_for(0, pending.size(), 1, [&](std::size_t first, std::size_t last) {
+            for (auto idx = first; idx < last; idx++) {
+                ZoneScoped;
+                auto& pipeline = pending[idx];
+                ENGINE_NS::g_ENGINE->logger.debug(
+                  ENGINE_NS::LogNamespaces::GRAPHICS, R"(Compiling pipeline "{}" with id "{}")", pipeline->name(), pipeline->id_);
                 pipeline->init_pipeline(*this, device_, allocator_);
-                registered_pipelines.get()[pipeline_id] = std::move(pipeline);
-                in_use_pipelines.get().insert({pipeline_id, 0});
             }
+        });
+
+        auto compiled = std::vector<std::shared_ptr<graphics::RegisteredPipeline>>();
+        compiled.reserve(pending.size());
+        for (auto& pipeline : pending) {
+            compiled.emplace_back(pipeline.release(), [this](graphics::RegisteredPipeline* retired) {
+                retired->destroy(device_, allocator_);
+                delete retired;
+            });
         }
 
+        // Published under the lock so a deregister either removed its ids from compiling_pipelines_ first, or runs
+        // after they are in the registry. Pipelines deregistered meanwhile are destroyed along with compiled
+        lock.lock();
+        registered_pipelines_.update([&](graphics::PipelineRegistry& registry) {
+            for (auto& pipeline : compiled) {
+                if (std::ranges::find(compiling_pipelines_, pipeline->id_) == compiling_pipelines_.end()) {
+                    continue;
+                }
+                auto pipeline_id      = pipeline->id_;
+                registry[pipeline_id] = std::move(pipeline);
+            }
+        });
+        compiling_pipelines_.clear();
         lock.unlock();
     }
 }
@@ -1131,8 +1148,7 @@ auto ENGINE_NS::graphics::RegisteredPipeline::build_compute_pipeline(ENGINE_NS::
 }
 
 auto ENGINE_NS::graphics::RegisteredPipeline::init_pipeline(GraphicsEngine& engine, VulkanDevice& device, VmaAllocator allocator) -> void {
-    auto logger = ENGINE_NS::g_ENGINE->logger.get(ENGINE_NS::LogNamespaces::GRAPHICS);
-    logger.get().debug("Creating registered pipeline \"{}\"", this->name());
+    ENGINE_NS::g_ENGINE->logger.debug(ENGINE_NS::LogNamespaces::GRAPHICS, "Creating registered pipeline \"{}\"", this->name());
 
     std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> frame_sizes = {
       {.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          .ratio = 3},
@@ -1161,8 +1177,7 @@ auto ENGINE_NS::graphics::RegisteredPipeline::init_pipeline(GraphicsEngine& engi
 }
 
 auto ENGINE_NS::graphics::RegisteredPipeline::destroy(VulkanDevice& device, VmaAllocator allocator) -> void {
-    auto logger = ENGINE_NS::g_ENGINE->logger.get(ENGINE_NS::LogNamespaces::GRAPHICS);
-    logger.get().debug("Destroying registered pipeline \"{}\"", this->name());
+    ENGINE_NS::g_ENGINE->logger.debug(ENGINE_NS::LogNamespaces::GRAPHICS, "Destroying registered pipeline \"{}\"", this->name());
     this->destroy_(device, allocator);
     this->deletion_queue_.flush(device, allocator);
 }
@@ -18,7 +18,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL validation_callback(VkDebugUtilsMessageSev
                                                           const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
                                                           void*) {
     ZoneScoped;
-    ENGINE_NS::RwDataMut<engine::Logger> logger;
+    ENGINE_NS::RwData<engine::Logger> logger;
     switch (messageType) {
         case VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT:
             logger = ENGINE_NS::g_ENGINE->logger.get(ENGINE_NS::LogNamespaces::VULKAN);
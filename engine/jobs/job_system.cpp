@@ -0,0 +1,287 @@
+#include "engine/jobs/job_system.h"
+
+#include <common/TracySystem.hpp>
+#include <cassert>
+#include <string>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    // Rounds a thread looks for work before parking
+    constexpr std::uint32_t SPIN_ROUNDS = 64;
+
+    struct ThreadContext {
+            const JobSystem* system = nullptr;
+            void* worker            = nullptr;
+            std::size_t index       = 0;
+    };
+    thread_local ThreadContext g_THREAD_CONTEXT{};
+
+    auto add_pending(std::atomic<std::uint32_t>& pending) -> void {
+        auto value = pending.load(std::memory_order_relaxed);
+        while (true) {
+            if (value == UINT32_MAX) {
+                // Counter::SETTLING: the last job is handing out continuations and the counter will read zero shortly
+                std::this_thread::yield();
+                value = pending.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (pending.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+} // namespace
+
+ENGINE_NS::JobSystem::JobSystem() : JobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1) {
+}
+
+ENGINE_NS::JobSystem::JobSystem(std::size_t worker_count) : main_thread_(std::this_thread::get_id()) {
+    workers_.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; i++) {
+        workers_.emplace_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < worker_count; i++) {
+        workers_[i]->thread = std::thread([this, i] { worker_loop_(*workers_[i], i); });
+    }
+}
+
+ENGINE_NS::JobSystem::~JobSystem() {
+    running_.store(false, std::memory_order_seq_cst);
+    work_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    work_epoch_.notify_all();
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+
+    // Anything still queued never ran; its counters are abandoned with it
+    for (auto& worker : workers_) {
+        while (auto* job = worker->deque.pop()) {
+            delete job;
+        }
+    }
+    for (auto* job : injection_) {
+        delete job;
+    }
+    for (auto* job : main_jobs_) {
+        delete job;
+    }
+}
+
+auto ENGINE_NS::JobSystem::schedule(std::function<void()> function, jobs::Counter* signal) -> void {
+    if (signal) {
+        add_pending(signal->pending_);
+    }
+    enqueue_(new jobs::Job{std::move(function), signal, jobs::Affinity::ANY});
+}
+
+auto ENGINE_NS::JobSystem::schedule_after(const jobs::Counter& dependency,
+                                          std::function<void()> function,
+                                          jobs::Counter* signal,
+                                          jobs::Affinity affinity) -> void {
+    if (signal) {
+        add_pending(signal->pending_);
+    }
+    auto* job = new jobs::Job{std::move(function), signal, affinity};
+
+    // Continuations are only mutated under the lock, and the final job takes them under the same lock, so a
+    // dependency either still has jobs outstanding and will queue this one or has already finished
+    auto& counter = const_cast<jobs::Counter&>(dependency);
+    {
+        std::scoped_lock lock(counter.continuations_mutex_);
+        auto pending = counter.pending_.load(std::memory_order_acquire);
+        if (pending != 0 && pending != jobs::Counter::SETTLING) {
+            counter.continuations_.push_back(job);
+            return;
+        }
+    }
+    while (!counter.done()) {
+        std::this_thread::yield();
+    }
+    enqueue_(job);
+}
+
+auto ENGINE_NS::JobSystem::schedule_main(std::function<void()> function, jobs::Counter* signal) -> void {
+    if (signal) {
+        add_pending(signal->pending_);
+    }
+    enqueue_(new jobs::Job{std::move(function), signal, jobs::Affinity::MAIN_THREAD});
+}
+
+auto ENGINE_NS::JobSystem::run_main_thread_jobs() -> void {
+    ZoneScoped;
+    assert(std::this_thread::get_id() == main_thread_ && "Main thread jobs must be run on the main thread");
+    std::vector<jobs::Job*> to_run;
+    {
+        std::scoped_lock lock(main_mutex_);
+        to_run.swap(main_jobs_);
+    }
+    for (auto* job : to_run) {
+        run_(job);
+    }
+}
+
+auto ENGINE_NS::JobSystem::wait(jobs::Counter& counter) -> void {
+    ZoneScoped;
+    auto* worker      = current_worker_();
+    auto victim       = g_THREAD_CONTEXT.system == this ? g_THREAD_CONTEXT.index + 1 : 0;
+    auto on_main      = std::this_thread::get_id() == main_thread_;
+    std::uint32_t idle = 0;
+
+    while (!counter.done()) {
+        auto epoch = work_epoch_.load(std::memory_order_seq_cst);
+
+        jobs::Job* job = nullptr;
+        if (on_main) {
+            std::scoped_lock lock(main_mutex_);
+            if (!main_jobs_.empty()) {
+                job = main_jobs_.back();
+                main_jobs_.pop_back();
+            }
+        }
+        if (!job) {
+            job = find_job_(worker, victim);
+        }
+        if (job) {
+            run_(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        if (!counter.done()) {
+            work_epoch_.wait(epoch, std::memory_order_seq_cst);
+        }
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+auto ENGINE_NS::JobSystem::worker_count() const -> std::size_t {
+    return workers_.size();
+}
+
+auto ENGINE_NS::JobSystem::worker_loop_(Worker& worker, std::size_t index) -> void {
+    auto name = std::string(StaticNames::JobWorkerThreadName) + " " + std::to_string(index);
+    tracy::SetThreadName(name.c_str());
+    g_THREAD_CONTEXT = ThreadContext{this, &worker, index};
+
+    auto victim        = index + 1;
+    std::uint32_t idle = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        auto epoch = work_epoch_.load(std::memory_order_seq_cst);
+        if (auto* job = find_job_(&worker, victim)) {
+            run_(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        if (running_.load(std::memory_order_seq_cst)) {
+            work_epoch_.wait(epoch, std::memory_order_seq_cst);
+        }
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+    g_THREAD_CONTEXT = ThreadContext{};
+}
+
+auto ENGINE_NS::JobSystem::current_worker_() -> Worker* {
+    if (g_THREAD_CONTEXT.system != this) {
+        return nullptr;
+    }
+    return static_cast<Worker*>(g_THREAD_CONTEXT.worker);
+}
+
+auto ENGINE_NS::JobSystem::enqueue_(jobs::Job* job) -> void {
+    if (job->affinity == jobs::Affinity::MAIN_THREAD) {
+        std::scoped_lock lock(main_mutex_);
+        main_jobs_.push_back(job);
+    } else if (auto* worker = current_worker_(); !worker || !worker->deque.push(job)) {
+        std::scoped_lock lock(injection_mutex_);
+        injection_.push_back(job);
+    }
+    wake_();
+}
+
+auto ENGINE_NS::JobSystem::find_job_(Worker* worker, std::size_t& victim) -> jobs::Job* {
+    if (worker) {
+        if (auto* job = worker->deque.pop()) {
+            return job;
+        }
+    }
+    {
+        std::scoped_lock lock(injection_mutex_);
+        if (!injection_.empty()) {
+            auto* job = injection_.front();
+            injection_.pop_front();
+            return job;
+        }
+    }
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+        auto& target = *workers_[(victim + i) % workers_.size()];
+        if (&target == worker) {
+            continue;
+        }
+        if (auto* job = target.deque.steal()) {
+            // Keep stealing from whoever last had work
+            victim = (victim + i) % workers_.size();
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+auto ENGINE_NS::JobSystem::run_(jobs::Job* job) -> void {
+    {
+        ZoneScopedN(StaticNames::RunJob);
+        job->function();
+    }
+    if (job->signal) {
+        signal_(*job->signal);
+    }
+    delete job;
+}
+
+auto ENGINE_NS::JobSystem::signal_(jobs::Counter& counter) -> void {
+    // Last job out moves the counter to SETTLING so nothing else is added while the continuations are taken, then
+    // releases it. The counter may be destroyed the moment it reads zero, so it is not touched after that store
+    auto value = counter.pending_.load(std::memory_order_relaxed);
+    while (true) {
+        assert(value != 0 && value != jobs::Counter::SETTLING && "Counter signalled more times than it was scheduled");
+        auto next = value == 1 ? jobs::Counter::SETTLING : value - 1;
+        if (counter.pending_.compare_exchange_weak(value, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            if (next != jobs::Counter::SETTLING) {
+                return;
+            }
+            break;
+        }
+    }
+
+    std::vector<jobs::Job*> continuations;
+    {
+        std::scoped_lock lock(counter.continuations_mutex_);
+        continuations.swap(counter.continuations_);
+    }
+    counter.pending_.store(0, std::memory_order_release);
+
+    for (auto* continuation : continuations) {
+        enqueue_(continuation);
+    }
+    wake_();
+}
+
+auto ENGINE_NS::JobSystem::wake_() -> void {
+    work_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+        work_epoch_.notify_all();
+    }
+}
@@ -0,0 +1,255 @@
+#include "engine/log_format.h"
+
+#include <fmt/args.h>
+#include <iterator>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    // Reads plain values out of a byte span, failing instead of reading past the end
+    class ByteReader {
+        public:
+            explicit ByteReader(std::span<const std::byte> bytes) : bytes_(bytes) {
+            }
+
+            template <typename T>
+            auto read(T& value) -> bool {
+                if (bytes_.size() - offset_ < sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(&value, bytes_.data() + offset_, sizeof(T));
+                offset_ += sizeof(T);
+                return true;
+            }
+
+            auto read_string(std::size_t size, std::string_view& text) -> bool {
+                if (bytes_.size() - offset_ < size) {
+                    return false;
+                }
+                text = std::string_view(reinterpret_cast<const char*>(bytes_.data() + offset_), size);
+                offset_ += size;
+                return true;
+            }
+
+            auto done() const -> bool {
+                return offset_ == bytes_.size();
+            }
+
+        private:
+            std::span<const std::byte> bytes_;
+            std::size_t offset_ = 0;
+    };
+
+    template <typename T>
+    auto read_file(std::FILE* file, T& value) -> bool {
+        return std::fread(&value, sizeof(T), 1, file) == 1;
+    }
+
+    auto read_file_string(std::FILE* file, std::string& text) -> bool {
+        std::uint32_t size = 0;
+        if (!read_file(file, size)) {
+            return false;
+        }
+        text.resize(size);
+        return size == 0 || std::fread(text.data(), 1, size, file) == size;
+    }
+} // namespace
+
+auto logger::format_args(std::string_view format, std::span<const std::byte> args, fmt::memory_buffer& out) -> bool {
+    // Reused so formatting only allocates while the argument list grows past anything seen before
+    thread_local auto store = fmt::dynamic_format_arg_store<fmt::format_context>();
+    store.clear();
+    auto reader = ByteReader(args);
+    while (!reader.done()) {
+        auto tag = ArgTag{};
+        if (!reader.read(tag)) {
+            return false;
+        }
+        auto ok = false;
+        switch (tag) {
+            case ArgTag::BOOL: {
+                std::uint8_t value = 0;
+                ok                 = reader.read(value);
+                store.push_back(value != 0);
+                break;
+            }
+            case ArgTag::CHAR: {
+                char value = 0;
+                ok         = reader.read(value);
+                store.push_back(value);
+                break;
+            }
+            case ArgTag::I64: {
+                std::int64_t value = 0;
+                ok                 = reader.read(value);
+                store.push_back(value);
+                break;
+            }
+            case ArgTag::U64: {
+                std::uint64_t value = 0;
+                ok                  = reader.read(value);
+                store.push_back(value);
+                break;
+            }
+            case ArgTag::F32: {
+                float value = 0;
+                ok          = reader.read(value);
+                store.push_back(value);
+                break;
+            }
+            case ArgTag::F64: {
+                double value = 0;
+                ok           = reader.read(value);
+                store.push_back(value);
+                break;
+            }
+            case ArgTag::STRING: {
+                std::uint32_t size = 0;
+                auto text          = std::string_view{};
+                ok                 = reader.read(size) && reader.read_string(size, text);
+                // Views into args, which outlives the store
+                store.push_back(text);
+                break;
+            }
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    try {
+        fmt::vformat_to(std::back_inserter(out), format, store);
+    } catch (const fmt::format_error&) {
+        return false;
+    }
+    return true;
+}
+
+logger::binary::Writer::Writer(std::FILE* file) : file_(file) {
+    put_(MAGIC.data(), MAGIC.size());
+    put_(&VERSION, sizeof(VERSION));
+    put_(&BYTE_ORDER_MARK, sizeof(BYTE_ORDER_MARK));
+}
+
+auto logger::binary::Writer::write(std::uint64_t index,
+                                   std::uint8_t level,
+                                   std::string_view owner,
+                                   std::chrono::nanoseconds time,
+                                   std::string_view format,
+                                   std::span<const std::byte> args) -> void {
+    auto [format_it, new_format] = formats_.try_emplace(format.data(), static_cast<std::uint32_t>(formats_.size()));
+    if (new_format) {
+        put_string_(RecordType::FORMAT, format_it->second, format);
+    }
+    auto owner_it = owners_.find(owner);
+    if (owner_it == owners_.end()) {
+        owner_it = owners_.emplace(std::string(owner), static_cast<std::uint32_t>(owners_.size())).first;
+        put_string_(RecordType::OWNER, owner_it->second, owner);
+    }
+
+    auto type       = RecordType::ENTRY;
+    std::int64_t ns = time.count();
+    auto args_size  = static_cast<std::uint32_t>(args.size());
+    put_(&type, sizeof(type));
+    put_(&index, sizeof(index));
+    put_(&level, sizeof(level));
+    put_(&owner_it->second, sizeof(owner_it->second));
+    put_(&ns, sizeof(ns));
+    put_(&format_it->second, sizeof(format_it->second));
+    put_(&args_size, sizeof(args_size));
+    put_(args.data(), args.size());
+}
+
+auto logger::binary::Writer::flush() -> void {
+    std::fflush(file_);
+}
+
+auto logger::binary::Writer::put_string_(RecordType type, std::uint32_t id, std::string_view text) -> void {
+    auto size = static_cast<std::uint32_t>(text.size());
+    put_(&type, sizeof(type));
+    put_(&id, sizeof(id));
+    put_(&size, sizeof(size));
+    put_(text.data(), text.size());
+}
+
+auto logger::binary::Writer::put_(const void* data, std::size_t size) -> void {
+    if (size > 0) {
+        std::fwrite(data, 1, size, file_);
+    }
+}
+
+auto logger::binary::decode(std::FILE* input, std::FILE* output) -> std::expected<std::uint64_t, std::string> {
+    auto magic               = decltype(MAGIC){};
+    std::uint32_t version    = 0;
+    std::uint32_t byte_order = 0;
+    if (std::fread(magic.data(), 1, magic.size(), input) != magic.size() || magic != MAGIC) {
+        return std::unexpected("Not a binary log");
+    }
+    if (!read_file(input, version) || version != VERSION) {
+        return std::unexpected(fmt::format("Unsupported binary log version {}", version));
+    }
+    if (!read_file(input, byte_order) || byte_order != BYTE_ORDER_MARK) {
+        return std::unexpected("Binary log was written with a different byte order");
+    }
+
+    auto formats          = std::vector<std::string>();
+    auto owners           = std::vector<std::string>();
+    auto args             = std::vector<std::byte>();
+    auto message          = fmt::memory_buffer();
+    auto line             = fmt::memory_buffer();
+    std::uint64_t entries = 0;
+
+    auto type = RecordType{};
+    while (read_file(input, type)) {
+        switch (type) {
+            case RecordType::FORMAT:
+            case RecordType::OWNER: {
+                auto& table      = type == RecordType::FORMAT ? formats : owners;
+                std::uint32_t id = 0;
+                if (!read_file(input, id) || id != table.size() || !read_file_string(input, table.emplace_back())) {
+                    return std::unexpected(fmt::format("Malformed string table record after {} entries", entries));
+                }
+                break;
+            }
+            case RecordType::ENTRY: {
+                std::uint64_t index     = 0;
+                std::uint8_t level      = 0;
+                std::uint32_t owner     = 0;
+                std::int64_t ns         = 0;
+                std::uint32_t format    = 0;
+                std::uint32_t args_size = 0;
+                if (!read_file(input, index) || !read_file(input, level) || !read_file(input, owner) || !read_file(input, ns) ||
+                    !read_file(input, format) || !read_file(input, args_size)) {
+                    return std::unexpected(fmt::format("Truncated entry after {} entries", entries));
+                }
+                args.resize(args_size);
+                if ((args_size > 0 && std::fread(args.data(), 1, args_size, input) != args_size) || owner >= owners.size() ||
+                    format >= formats.size()) {
+                    return std::unexpected(fmt::format("Malformed entry {}", index));
+                }
+
+                message.clear();
+                if (!format_args(formats[format], args, message)) {
+                    return std::unexpected(fmt::format("Cannot format entry {}", index));
+                }
+                line.clear();
+                format_line(std::back_inserter(line),
+                            std::chrono::duration<double>(std::chrono::nanoseconds(ns)),
+                            level_name(level),
+                            owners[owner],
+                            std::string_view(message.data(), message.size()));
+                line.push_back('\n');
+                std::fwrite(line.data(), 1, line.size(), output);
+                entries++;
+                break;
+            }
+            default:
+                return std::unexpected(fmt::format("Unknown record type {} after {} entries", static_cast<int>(type), entries));
+        }
+    }
+    if (!std::feof(input)) {
+        return std::unexpected("Failed reading binary log");
+    }
+    return entries;
+}
@@ -1,9 +1,14 @@
 #include "engine/logger.h"
 
 #include <tracy/Tracy.hpp>
+#include <common/TracySystem.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <chrono>
 #include <cstdio>
-#include <ranges>
+#include <cstring>
+#include <deque>
 
 using namespace ::ENGINE_NS;
 
@@ -30,34 +35,23 @@ bool logger::operator>=(logger::Level lhs, logger::Level rhs) {
 }
 
 auto logger::level_to_string(Level level) -> std::string_view {
-    switch (level) {
-        case Level::ERROR:
-            return "ERROR";
-        case Level::WARNING:
-            return "WARNING";
-        case Level::INFO:
-            return "INFO";
-        case Level::DEBUG:
-            return "DEBUG";
-        default:
-            return "UNKNOWN";
-    }
+    return level_name(static_cast<std::uint8_t>(level));
 }
 
+namespace {
+    // A deque so names already handed out as views never move
+    auto owners() -> std::deque<std::string>& {
+        static std::deque<std::string> names;
+        return names;
+    }
+    auto owners_mutex() -> std::mutex& {
+        static std::mutex mutex;
+        return mutex;
+    }
+} // namespace
+
 auto entry_to_context(fmt::format_context& ctx, const logger::Entry& entry) -> fmt::format_context::iterator {
-    auto hours        = static_cast<std::uint64_t>(std::floor(entry.log_time_.count() / 60 / 60));
-    auto minutes      = static_cast<std::uint64_t>(std::floor(entry.log_time_.count() / 60));
-    auto seconds      = static_cast<std::uint64_t>(std::floor(entry.log_time_.count()));
-    auto milliseconds = static_cast<std::uint64_t>(10'000.0 * (entry.log_time_.count() - std::floor(entry.log_time_.count())));
-    return fmt::format_to(ctx.out(),
-                          "{:0>2}:{:0>2}:{:0>2}.{:0>4} [{}] ({}) {}",
-                          hours,
-                          minutes,
-                          seconds,
-                          milliseconds,
-                          logger::level_to_string(entry.level),
-                          entry.owner,
-                          entry.message);
+    return logger::format_line(ctx.out(), entry.log_time_, logger::level_to_string(entry.level), entry.owner, entry.message);
 }
 
 auto fmt::formatter<logger::Entry>::format(logger::Entry entry, fmt::format_context& ctx) const -> fmt::format_context::iterator {
@@ -83,71 +77,517 @@ auto LoggerBuilder::with_stream(Stream stream) -> LoggerBuilder& {
     return *this;
 }
 
-auto LoggerBuilder::build(std::uint64_t& idx) -> Logger {
-    return Logger(m_identifier, std::move(m_streams), idx);
+auto LoggerBuilder::with_history(std::size_t entries, std::size_t bytes) -> LoggerBuilder& {
+    m_history_entries = entries;
+    m_history_bytes   = bytes;
+    return *this;
 }
 
-Logger::Logger(std::string_view identifier, std::vector<Stream>&& streams, std::uint64_t& idx) :
-    m_log_idx(idx), start_time_(logger::Clock::now()), m_streams(std::move(streams)), m_identifier(identifier) {
+auto LoggerBuilder::build(logger::Sink& sink) -> Logger {
+    return Logger(m_identifier, std::move(m_streams), sink, logger::History(m_history_entries, m_history_bytes));
 }
 
-auto Logger::last_entries(uint64_t count) const -> std::vector<const logger::Entry*> {
-    if (count == 0) {
-        return {};
+auto logger::intern_owner(std::string_view owner) -> OwnerId {
+    std::scoped_lock lock(owners_mutex());
+    auto& names = owners();
+    auto it     = std::find(names.begin(), names.end(), owner);
+    if (it != names.end()) {
+        return static_cast<OwnerId>(std::distance(names.begin(), it));
     }
-    std::size_t maxCount = std::min(m_entries.size(), size_t(count));
-    std::vector<const logger::Entry*> entries(maxCount);
-    uint64_t currentCount = 0;
-    for (const auto& entry : std::ranges::reverse_view{m_entries}) {
-        entries[maxCount - currentCount - 1] = &entry;
-        currentCount += 1;
-        if (currentCount >= count) {
+    names.emplace_back(owner);
+    return static_cast<OwnerId>(names.size() - 1);
+}
+
+auto logger::owner_name(OwnerId owner) -> std::string_view {
+    std::scoped_lock lock(owners_mutex());
+    return owners()[owner];
+}
+
+logger::History::History(std::size_t entries, std::size_t bytes) :
+    slots_(std::make_unique<Slot[]>(entries)), slot_capacity_(entries), arena_(std::make_unique<char[]>(bytes)), arena_capacity_(bytes) {
+    assert(entries > 0 && "History must hold at least one entry");
+}
+
+auto logger::History::push(std::uint64_t index, Level level, std::chrono::duration<double> time, std::string_view message) -> void {
+    message = message.substr(0, arena_capacity_);
+    if (end_ - first_ == slot_capacity_) {
+        evict_();
+    }
+
+    auto offset = arena_head_;
+    if (offset + message.size() > arena_capacity_) {
+        // Text is never split, so skip the tail of the arena. Whatever is stored there is older than anything at the
+        // front, and goes first
+        while (first_ != end_ && slot(first_).offset >= offset) {
+            evict_();
+        }
+        offset = 0;
+    }
+    // Live text runs on from the write offset in eviction order, so everything up to the first entry clear of the new
+    // text goes. Empty entries own no bytes: they say nothing about where that text is and are only evicted in passing
+    auto overwritten = first_;
+    for (auto sequence = first_; sequence != end_; sequence++) {
+        const auto& live = slot(sequence);
+        if (live.size == 0) {
+            continue;
+        }
+        if (live.offset >= offset + message.size() || live.offset + live.size <= offset) {
             break;
         }
+        overwritten = sequence + 1;
+    }
+    while (first_ != overwritten) {
+        evict_();
+    }
+
+    std::memcpy(arena_.get() + offset, message.data(), message.size());
+    arena_head_ = offset + message.size();
+    slots_[end_ % slot_capacity_] = Slot{
+      index,
+      time,
+      static_cast<std::uint32_t>(offset),
+      static_cast<std::uint32_t>(message.size()),
+      level,
+    };
+    end_++;
+}
+
+auto logger::History::evict_() -> void {
+    first_++;
+}
+
+logger::HistoryView::HistoryView(std::shared_lock<std::shared_mutex>&& lock,
+                                 const History& history,
+                                 OwnerId owner,
+                                 std::uint64_t count,
+                                 Level filter) :
+    lock_(std::move(lock)), history_(&history), owner_(owner_name(owner)), filter_(filter), end_(history.end()) {
+    // Walk back from the newest entry to find where the last count matching entries start
+    first_ = end_;
+    last_  = end_;
+    for (auto sequence = end_; sequence != history.first() && size_ < count; sequence--) {
+        if (history.slot(sequence - 1).level <= filter) {
+            first_ = sequence - 1;
+            last_  = size_ == 0 ? first_ : last_;
+            size_++;
+        }
     }
-    return entries;
 }
 
-auto Logger::last_entries_of(uint64_t count, logger::Level filter) const -> std::vector<const logger::Entry*> {
-    if (count == 0) {
-        return {};
+logger::HistoryView::HistoryView(std::shared_lock<std::shared_mutex>&& lock, const History& history, OwnerId owner, Since since) :
+    lock_(std::move(lock)), history_(&history), owner_(owner_name(owner)), filter_(Level::DEBUG), first_(std::max(since.sequence, history.first())),
+    end_(history.end()) {
+    first_ = std::min(first_, end_);
+    last_  = first_ == end_ ? end_ : end_ - 1;
+    size_  = static_cast<std::size_t>(end_ - first_);
+}
+
+auto logger::HistoryView::entry_(std::uint64_t sequence) const -> Entry {
+    const auto& slot = history_->slot(sequence);
+    return Entry{
+      slot.index,
+      slot.level,
+      owner_,
+      history_->message(slot),
+      slot.time,
+    };
+}
+
+auto logger::HistoryView::next_(std::uint64_t sequence) const -> std::uint64_t {
+    while (sequence != end_ && history_->slot(sequence).level > filter_) {
+        sequence++;
     }
-    count                 = std::min(uint64_t(m_entries.size()), count);
-    auto entries          = std::vector<const logger::Entry*>(std::size_t(count));
-    uint64_t currentCount = 0;
-    for (const auto& entry : std::ranges::reverse_view{m_entries}) {
-        if (entry.level <= filter) {
-            entries[std::size_t(count - currentCount - 1)] = &entry;
-            currentCount += 1;
-            if (currentCount >= count) {
-                break;
+    return sequence;
+}
+
+// Single-producer single-consumer ring owned by one logging thread
+struct logger::Sink::Ring {
+        static constexpr std::uint64_t NO_CLAIM = UINT64_MAX;
+
+        explicit Ring(std::size_t capacity) : mask(capacity - 1), slots(std::make_unique<Record[]>(capacity)) {
+            assert(std::has_single_bit(capacity) && "Ring capacity must be a power of two");
+        }
+
+        // Leaves record untouched when full
+        auto try_push(Record& record) -> bool {
+            auto tail_idx = tail.load(std::memory_order_relaxed);
+            if (tail_idx - head.load(std::memory_order_acquire) > mask) {
+                return false;
+            }
+            slots[tail_idx & mask] = std::move(record);
+            tail.store(tail_idx + 1, std::memory_order_release);
+            return true;
+        }
+
+        auto try_pop(Record& record) -> bool {
+            auto head_idx = head.load(std::memory_order_relaxed);
+            if (head_idx == tail.load(std::memory_order_acquire)) {
+                return false;
             }
+            record = std::move(slots[head_idx & mask]);
+            head.store(head_idx + 1, std::memory_order_release);
+            return true;
         }
+
+        auto empty() const -> bool {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        std::size_t mask;
+        std::unique_ptr<Record[]> slots;
+        alignas(64) std::atomic<std::size_t> head = 0;
+        alignas(64) std::atomic<std::size_t> tail = 0;
+        // Set when the owning thread exits; the sink frees the ring once it is empty
+        std::atomic<bool> closed = false;
+        // While the owning thread is in submit(), a lower bound of the index it is taking
+        std::atomic<std::uint64_t> claim = NO_CLAIM;
+};
+
+logger::Sink::Sink(OverflowPolicy policy, std::size_t ring_capacity) :
+    policy_(policy), ring_capacity_(std::bit_ceil(ring_capacity)) {
+    static std::atomic<std::uint64_t> next_id = 0;
+    id_                                       = next_id.fetch_add(1, std::memory_order_relaxed);
+    thread_                                   = std::thread(&Sink::run_, this);
+}
+
+logger::Sink::~Sink() {
+    stop();
+}
+
+auto logger::Sink::submit(Record&& record) -> void {
+    auto& ring = ring_();
+    // Claimed before the index is taken, so the sink holds back every record from here on until this one is in the ring
+    ring.claim.store(index_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+    record.index = index_.fetch_add(1, std::memory_order_seq_cst);
+    while (!ring.try_push(record)) {
+        if (policy_ == OverflowPolicy::DROP) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        wake_();
+        std::this_thread::yield();
     }
+    ring.claim.store(Ring::NO_CLAIM, std::memory_order_release);
 
-    if (currentCount < count) {
-        for (std::size_t idx = 0; idx < std::size_t(currentCount); idx += 1) {
-            entries[idx] = entries[std::size_t(count) - currentCount + idx];
+    // Pairs with the sink publishing that it is asleep or stopping before it last looks at the rings
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        wake_();
+    }
+    if (stopping_.load(std::memory_order_relaxed)) {
+        // The sink thread may already have made its final pass
+        std::scoped_lock lock(write_mutex_);
+        drain_(false);
+    }
+}
+
+auto logger::Sink::flush() -> void {
+    ZoneScoped;
+    auto ticket = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    wake_();
+    auto flushed = flushed_.load(std::memory_order_acquire);
+    while (flushed < ticket) {
+        if (!thread_.joinable()) {
+            std::scoped_lock lock(write_mutex_);
+            drain_(false);
+            return;
         }
-        entries.resize(currentCount);
+        flushed_.wait(flushed, std::memory_order_acquire);
+        flushed = flushed_.load(std::memory_order_acquire);
     }
-    return entries;
 }
 
-void Logger::append(logger::Level level, std::string&& message) {
-    logger::Entry entry{
-      m_log_idx,
-      level,
-      m_identifier,
-      std::move(message),
-      logger::Clock::now() - start_time_,
+auto logger::Sink::stop() -> void {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_seq_cst);
+    wake_();
+    thread_.join();
+
+    std::scoped_lock lock(write_mutex_);
+    drain_(false);
+    flushed_.store(flush_requests_.load(std::memory_order_acquire), std::memory_order_release);
+    flushed_.notify_all();
+}
+
+auto logger::Sink::dropped() const -> std::uint64_t {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+auto logger::Sink::write_binary_to(std::FILE* file) -> void {
+    // Written under the same lock as the streams so nothing submitted before the switch goes to the new file
+    std::scoped_lock lock(write_mutex_);
+    if (binary_) {
+        binary_->flush();
+    }
+    binary_ = file != nullptr ? std::make_unique<binary::Writer>(file) : nullptr;
+}
+
+auto logger::Sink::ring_() -> Ring& {
+    struct ThreadRing {
+            std::uint64_t sink_id = UINT64_MAX;
+            std::shared_ptr<Ring> ring;
+
+            ~ThreadRing() {
+                if (ring) {
+                    ring->closed.store(true, std::memory_order_release);
+                }
+            }
     };
-    for (auto stream : m_streams) {
-        if (stream.level >= level) {
-            fmt::print(stream.file, "{}\n", entry);
-            fflush(stream.file);
+    thread_local ThreadRing local;
+
+    if (local.sink_id != id_) {
+        if (local.ring) {
+            local.ring->closed.store(true, std::memory_order_release);
         }
+        local.sink_id = id_;
+        local.ring    = std::make_shared<Ring>(ring_capacity_);
+        std::scoped_lock lock(rings_mutex_);
+        rings_.push_back(local.ring);
     }
-    m_log_idx += 1;
-    m_entries.push_back(std::move(entry));
+    return *local.ring;
+}
+
+auto logger::Sink::run_() -> void {
+    tracy::SetThreadName(StaticNames::LogSinkThreadName);
+    constexpr std::uint32_t IDLE_POLLS = 64;
+    constexpr auto IDLE_POLL_INTERVAL  = std::chrono::milliseconds(1);
+
+    std::uint32_t idle_polls = 0;
+    while (true) {
+        auto stopping  = stopping_.load(std::memory_order_acquire);
+        auto requested = flush_requests_.load(std::memory_order_acquire);
+        // A flush must not wait on a thread stuck mid-submit, so it writes out held back records too
+        auto flushing = stopping || requested != flushed_.load(std::memory_order_relaxed);
+
+        std::size_t written = 0;
+        auto holding        = false;
+        {
+            std::scoped_lock lock(write_mutex_);
+            written = drain_(!flushing);
+            holding = !batch_.empty();
+        }
+        if (requested != flushed_.load(std::memory_order_relaxed)) {
+            flushed_.store(requested, std::memory_order_release);
+            flushed_.notify_all();
+        }
+        if (written > 0) {
+            idle_polls = 0;
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+        // Poll for a little while before parking: waking a parked sink costs the logging thread a syscall, and
+        // logging tends to come in bursts. A thread that dropped its record pushes nothing a parked sink would notice,
+        // so records held back on it keep the sink polling
+        if (idle_polls < IDLE_POLLS || holding) {
+            idle_polls++;
+            // A writer blocked on a full ring or a flush cuts the poll short
+            auto epoch = wake_epoch_.load(std::memory_order_acquire);
+            std::unique_lock lock(poll_mutex_);
+            poll_condition_.wait_for(lock, IDLE_POLL_INTERVAL, [this, epoch] { return wake_epoch_.load(std::memory_order_acquire) != epoch; });
+            continue;
+        }
+        idle_polls = 0;
+
+        auto epoch = wake_epoch_.load(std::memory_order_seq_cst);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        if (!pending_() && !stopping_.load(std::memory_order_seq_cst) &&
+            flush_requests_.load(std::memory_order_seq_cst) == requested) {
+            wake_epoch_.wait(epoch, std::memory_order_seq_cst);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+auto logger::Sink::drain_(bool hold_back) -> std::size_t {
+    ZoneScoped;
+    // Read before the rings are listed: a ring registered afterwards belongs to a thread that has not taken an index yet,
+    // so it only gets indices from here on
+    auto watermark = hold_back ? index_.load(std::memory_order_seq_cst) : Ring::NO_CLAIM;
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::scoped_lock lock(rings_mutex_);
+        rings = rings_;
+    }
+    // Read before popping. Every index below the watermark is then already in a ring, and anything from it on waits for
+    // the thread still submitting it
+    if (hold_back) {
+        for (const auto& ring : rings) {
+            watermark = std::min(watermark, ring->claim.load(std::memory_order_seq_cst));
+        }
+    }
+
+    // Still holds the records held back by the last drain
+    auto& batch     = batch_;
+    bool any_closed = false;
+    for (auto& ring : rings) {
+        // Read before popping: once closed is seen every push from the owning thread is visible
+        auto closed = ring->closed.load(std::memory_order_acquire);
+        auto record = Record{};
+        while (ring->try_pop(record)) {
+            batch.push_back(std::move(record));
+        }
+        any_closed = any_closed || closed;
+        if (!closed) {
+            // Whatever is left in rings afterwards is closed and empty
+            ring.reset();
+        }
+    }
+    if (any_closed) {
+        std::scoped_lock lock(rings_mutex_);
+        std::erase_if(rings_, [&rings](const std::shared_ptr<Ring>& ring) {
+            return std::find(rings.begin(), rings.end(), ring) != rings.end();
+        });
+    }
+
+    std::size_t written = 0;
+    if (!batch.empty()) {
+        // Rings are drained one after the other; put entries from different threads back in call order
+        // Records are large, so their order is sorted rather than the records themselves
+        order_.clear();
+        for (auto& record : batch) {
+            if (record.index < watermark) {
+                order_.push_back(&record);
+            }
+        }
+        std::sort(order_.begin(), order_.end(), [](const Record* lhs, const Record* rhs) { return lhs->index < rhs->index; });
+        write_(order_);
+        written = order_.size();
+        if (written == batch.size()) {
+            batch.clear();
+        } else {
+            std::erase_if(batch, [watermark](const Record& record) { return record.index < watermark; });
+        }
+    }
+
+    auto dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        fmt::print(stderr, "Logger dropped {} entries while its ring was full\n", dropped - reported_dropped_);
+        reported_dropped_ = dropped;
+    }
+    return written;
+}
+
+auto logger::Sink::pending_() -> bool {
+    std::scoped_lock lock(rings_mutex_);
+    return std::any_of(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) { return !ring->empty(); });
+}
+
+auto logger::Sink::write_(const std::vector<Record*>& batch) -> void {
+    struct Output {
+            std::FILE* file = nullptr;
+            fmt::memory_buffer buffer;
+    };
+    std::vector<Output> outputs;
+
+    for (auto* pending : batch) {
+        auto& record      = *pending;
+        const auto& owner = *record.logger;
+        auto message = std::string_view(record.message);
+        if (record.kind == RecordKind::DEFERRED) {
+            message_buffer_.clear();
+            if (!format_args(record.format, record.args.view(), message_buffer_)) {
+                message_buffer_.clear();
+                fmt::format_to(std::back_inserter(message_buffer_), "<could not format \"{}\">", record.format);
+            }
+            message = std::string_view(message_buffer_.data(), message_buffer_.size());
+        }
+        if (binary_) {
+            write_binary_(record, owner.m_identifier);
+        }
+
+        auto entry = Entry{
+          record.index,
+          record.level,
+          owner.m_identifier,
+          message,
+          record.time - owner.start_time_,
+        };
+        for (const auto& stream : owner.m_streams) {
+            if (stream.level < record.level) {
+                continue;
+            }
+            auto output = std::find_if(outputs.begin(), outputs.end(), [&stream](const Output& out) { return out.file == stream.file; });
+            if (output == outputs.end()) {
+                outputs.emplace_back().file = stream.file;
+                output                      = std::prev(outputs.end());
+            }
+            fmt::format_to(std::back_inserter(output->buffer), "{}\n", entry);
+        }
+
+        std::scoped_lock lock(owner.m_mutex);
+        owner.m_history.push(entry.index, entry.level, entry.log_time_, entry.message);
+    }
+
+    for (auto& output : outputs) {
+        std::fwrite(output.buffer.data(), 1, output.buffer.size(), output.file);
+        std::fflush(output.file);
+    }
+    if (binary_) {
+        binary_->flush();
+    }
+}
+
+auto logger::Sink::write_binary_(const Record& record, std::string_view owner) -> void {
+    auto time  = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time - record.logger->start_time_);
+    auto level = static_cast<std::uint8_t>(record.level);
+    if (record.kind == RecordKind::DEFERRED) {
+        binary_->write(record.index, level, owner, time, record.format, record.args.view());
+        return;
+    }
+
+    // Eagerly formatted messages can be longer than an ArgBuffer, so they are encoded here rather than through it
+    auto tag  = ArgTag::STRING;
+    auto size = static_cast<std::uint32_t>(record.message.size());
+    binary_args_.resize(sizeof(tag) + sizeof(size) + record.message.size());
+    std::memcpy(binary_args_.data(), &tag, sizeof(tag));
+    std::memcpy(binary_args_.data() + sizeof(tag), &size, sizeof(size));
+    std::memcpy(binary_args_.data() + sizeof(tag) + sizeof(size), record.message.data(), record.message.size());
+    binary_->write(record.index, level, owner, time, binary::PLAIN_FORMAT, binary_args_);
+}
+
+auto logger::Sink::wake_() -> void {
+    wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    wake_epoch_.notify_one();
+    // Not under poll_mutex_: a missed notify only costs one poll interval
+    poll_condition_.notify_one();
+}
+
+Logger::Logger(std::string_view identifier, std::vector<Stream>&& streams, logger::Sink& sink, logger::History&& history) :
+    m_sink(&sink), start_time_(logger::Clock::now()), m_streams(std::move(streams)), m_level(logger::Level::DEBUG),
+    m_history(std::move(history)), m_owner(logger::intern_owner(identifier)), m_identifier(identifier) {
+    if (!m_streams.empty()) {
+        auto most_verbose = std::max_element(m_streams.begin(), m_streams.end(), [](const Stream& lhs, const Stream& rhs) {
+            return lhs.level < rhs.level;
+        });
+        m_level.store(most_verbose->level, std::memory_order_relaxed);
+    }
+}
+
+auto Logger::last_entries(uint64_t count) const -> logger::HistoryView {
+    return last_entries_of(count, logger::Level::DEBUG);
+}
+
+auto Logger::last_entries_of(uint64_t count, logger::Level filter) const -> logger::HistoryView {
+    return logger::HistoryView(std::shared_lock(m_mutex), m_history, m_owner, count, filter);
+}
+
+auto Logger::entries_since(uint64_t sequence) const -> logger::HistoryView {
+    return logger::HistoryView(std::shared_lock(m_mutex), m_history, m_owner, logger::HistoryView::Since{sequence});
+}
+
+void Logger::append(logger::Level level, logger::Record&& record) const {
+    record.level  = level;
+    record.logger = this;
+    record.time   = logger::Clock::now();
+    m_sink->submit(std::move(record));
+}
+
+void Logger::append(logger::Level level, std::string&& message) const {
+    auto record    = logger::Record{};
+    record.message = std::move(message);
+    append(level, std::move(record));
 }
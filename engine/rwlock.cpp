@@ -0,0 +1,113 @@
+#include "engine/rwlock.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    // Spin rounds before parking. Each round pauses twice as long as the last, capped at 64 pauses
+    constexpr std::uint32_t SPIN_ROUNDS = 10;
+
+    auto cpu_relax() -> void {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    auto backoff(std::uint32_t round) -> void {
+        auto pauses = std::uint32_t{1} << std::min<std::uint32_t>(round, 6);
+        for (std::uint32_t i = 0; i < pauses; i++) {
+            cpu_relax();
+        }
+    }
+
+#ifdef TRACY_ENABLE
+    constexpr tracy::SourceLocationData SOURCE_LOCATION{nullptr, "RwMutex", __FILE__, __LINE__, 0};
+
+    auto source_location() -> const tracy::SourceLocationData* {
+        return &SOURCE_LOCATION;
+    }
+#else
+    auto source_location() -> const void* {
+        return nullptr;
+    }
+#endif
+} // namespace
+
+RwMutex::RwMutex() : profiler_(source_location()) {
+}
+
+auto RwMutex::add_shared() -> void {
+    [[maybe_unused]] auto previous = state_.fetch_add(1, std::memory_order_relaxed);
+    assert((previous & READER_MASK) != 0 && "add_shared requires an existing shared hold");
+    assert((previous & READER_MASK) != READER_MASK && "Too many readers");
+}
+
+auto RwMutex::set_name(std::string_view name) -> void {
+#ifdef TRACY_ENABLE
+    profiler_.CustomName(name.data(), name.size());
+#else
+    (void)name;
+#endif
+}
+
+auto RwMutex::unsafe_reset() -> void {
+    state_.store(0, std::memory_order_release);
+    state_.notify_all();
+}
+
+auto RwMutex::lock_slow_() -> void {
+    // Registering as a waiting writer first stops new readers getting in while we spin
+    state_.fetch_add(WAITING_WRITER, std::memory_order_relaxed);
+
+    std::uint32_t round = 0;
+    while (true) {
+        auto state = state_.load(std::memory_order_relaxed);
+        if ((state & (WRITER | READER_MASK)) == 0) {
+            if (state_.compare_exchange_weak(state, (state - WAITING_WRITER) | WRITER, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        if (round < SPIN_ROUNDS) {
+            backoff(round++);
+            continue;
+        }
+        // The last reader out and every writer unlock wake us while we are counted as waiting
+        state_.wait(state, std::memory_order_relaxed);
+    }
+}
+
+auto RwMutex::lock_shared_slow_() -> void {
+    std::uint32_t round = 0;
+    while (true) {
+        auto state = state_.load(std::memory_order_relaxed);
+        if ((state & (WRITER | WAITING_WRITER_MASK)) == 0) {
+            assert((state & READER_MASK) != READER_MASK && "Too many readers");
+            if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        if (round < SPIN_ROUNDS) {
+            backoff(round++);
+            continue;
+        }
+        // Flag that a reader is parked so the next writer unlock knows to wake us
+        if ((state & READERS_PARKED) == 0) {
+            if (!state_.compare_exchange_weak(state, state | READERS_PARKED, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                continue;
+            }
+            state |= READERS_PARKED;
+        }
+        state_.wait(state, std::memory_order_relaxed);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "engine/fileio/file.h"
+#include "engine/fileio/virtual_file_system.h"
 #include "engine/graphics/vulkan.h"
 #include "engine/meta_defines.h"
 
@@ -7,9 +8,10 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
-#include <vector>
 
 namespace ENGINE_NS {
     namespace asset {
@@ -48,9 +50,11 @@ namespace ENGINE_NS {
                 static auto load_from_file(const std::filesystem::path& path) -> BytecodeShader;
 
             private:
-                BytecodeShader(std::vector<std::uint32_t>&& spirv, ShaderMetadata metadata);
+                BytecodeShader(std::shared_ptr<const fileio::VirtualFile> file, ShaderMetadata metadata);
                 ShaderMetadata metadata_{};
-                std::vector<std::uint32_t> spirv_;
+                // SPIR-V is handed to Vulkan straight out of the archive or mapping, which copies share
+                std::shared_ptr<const fileio::VirtualFile> file_;
+                std::span<const std::uint32_t> spirv_;
         };
     } // namespace asset
 } // namespace ENGINE_NS
@@ -1,21 +1,32 @@
 #pragma once
 #include "engine/meta_defines.h"
 
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace ENGINE_NS {
+    /*
+        Bitsets up to INLINE_WORDS words long are stored inline and never touch the heap; anything larger spills to a
+        vector. Component masks are far below the inline limit, so queries and archetype maps are allocation-free
+    */
     class Bitset {
         public:
-            using UnderlyingBitRepresentation = std::uint64_t;
+            using UnderlyingBitRepresentation    = std::uint64_t;
+            static constexpr size_t INLINE_WORDS = 4;
+            static constexpr size_t INLINE_BITS  = INLINE_WORDS * sizeof(UnderlyingBitRepresentation) * 8;
 
             ENGINE_API Bitset() = default;
             ENGINE_API Bitset(size_t bitcount);
-            ENGINE_API Bitset(const Bitset& other) = default;
-            ENGINE_API Bitset(Bitset&& other)      = default;
+            ENGINE_API Bitset(const Bitset& other);
+            ENGINE_API Bitset(Bitset&& other) noexcept;
 
-            ENGINE_API auto operator=(const Bitset& rhs) -> Bitset& = default;
-            ENGINE_API auto operator=(Bitset&& rhs) -> Bitset&      = default;
+            ENGINE_API auto operator=(const Bitset& rhs) -> Bitset&;
+            ENGINE_API auto operator=(Bitset&& rhs) noexcept -> Bitset&;
 
             ENGINE_API auto operator|(const Bitset& rhs) const -> Bitset;
             ENGINE_API auto operator&(const Bitset& rhs) const -> Bitset;
@@ -47,22 +58,85 @@ namespace ENGINE_NS {
 
             ENGINE_API auto set_bits() const -> std::vector<size_t>;
 
+            // Derived only from the set bits, so equal sets hash equally regardless of their size. Cached until modified
+            ENGINE_API auto hash() const -> std::uint64_t;
+
+            ENGINE_API auto count() const -> size_t;
+            ENGINE_API auto find_first() const -> std::optional<size_t>;
+            ENGINE_API auto any() const -> bool;
+            ENGINE_API auto none() const -> bool;
+
+            // Calls func(idx) for every set bit in ascending order, skipping empty words entirely
+            template <typename TFunc>
+            auto for_each_set_bit(TFunc&& func) const -> void {
+                constexpr size_t bits_per_word = sizeof(UnderlyingBitRepresentation) * 8;
+
+                auto words = this->_words();
+                for (size_t word_idx = 0; word_idx < words.size(); word_idx++) {
+                    auto word = words[word_idx];
+                    while (word != 0) {
+                        func(word_idx * bits_per_word + static_cast<size_t>(std::countr_zero(word)));
+                        // Clear the lowest set bit
+                        word &= word - 1;
+                    }
+                }
+            }
+
+            // True while the bits fit in the inline buffer
+            auto is_inline() const -> bool {
+                return m_word_count <= INLINE_WORDS;
+            }
+
             static constexpr auto bits_to_representation_count(size_t bitcount) -> size_t {
                 auto bytes = (bitcount + 8 - 1) / 8;
                 return (bytes + sizeof(UnderlyingBitRepresentation) - 1) / sizeof(UnderlyingBitRepresentation);
             }
 
         private:
-            std::vector<UnderlyingBitRepresentation> m_set;
-            size_t m_bitcount = 0;
+            std::array<UnderlyingBitRepresentation, INLINE_WORDS> m_inline{};
+            std::vector<UnderlyingBitRepresentation> m_heap;
+            size_t m_word_count = 0;
+            size_t m_bitcount   = 0;
+
+            // Lazily computed; HASH_DIRTY means it must be recomputed. Atomic so concurrent readers may fill it in
+            static constexpr std::uint64_t HASH_DIRTY = 0;
+            mutable std::atomic<std::uint64_t> hash_  = HASH_DIRTY;
 
-            std::uint64_t hash_ = 0;
+            auto _invalidate_hash() -> void {
+                hash_.store(HASH_DIRTY, std::memory_order_relaxed);
+            }
 
             auto _get_bitset_at_index(std::size_t idx) -> std::uint64_t&;
             auto _get_bitset_at_index(std::size_t idx) const -> std::uint64_t;
 
-            template <typename T>
-            friend struct std::hash;
+            auto _words() -> std::span<UnderlyingBitRepresentation> {
+                if (this->is_inline()) {
+                    return {m_inline.data(), m_word_count};
+                }
+                return {m_heap.data(), m_word_count};
+            }
+            auto _words() const -> std::span<const UnderlyingBitRepresentation> {
+                if (this->is_inline()) {
+                    return {m_inline.data(), m_word_count};
+                }
+                return {m_heap.data(), m_word_count};
+            }
+
+            // Bulk word operations are only vectorised once there are enough words to amortise the dispatch
+            static constexpr size_t AVX2_MIN_WORDS = 16;
+
+            // Implemented in bitset_avx2.cpp. Only valid to call when _has_avx2() is true
+            ENGINE_API static auto _has_avx2() -> bool;
+            ENGINE_API static auto _or_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs)
+                -> void;
+            ENGINE_API static auto _and_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs)
+                -> void;
+            ENGINE_API static auto _xor_avx2(std::span<UnderlyingBitRepresentation> lhs, std::span<const UnderlyingBitRepresentation> rhs)
+                -> void;
+            ENGINE_API static auto _is_subset_avx2(std::span<const UnderlyingBitRepresentation> subset,
+                                                   std::span<const UnderlyingBitRepresentation> superset) -> bool;
+            ENGINE_API static auto _count_avx2(std::span<const UnderlyingBitRepresentation> words) -> size_t;
+
     };
 } // namespace ENGINE_NS
 
@@ -73,7 +147,7 @@ namespace std {
     template <>
     struct hash<ENGINE_NS::Bitset> {
             auto operator()(const ENGINE_NS::Bitset& bitset) const noexcept -> std::size_t {
-                return bitset.hash_;
+                return bitset.hash();
             }
     };
 } // namespace std
@@ -0,0 +1,132 @@
+#pragma once
+#include "engine/bitset.h"
+#include "engine/meta_defines.h"
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace ENGINE_NS {
+    namespace compressed {
+        // Each block covers 2^16 indices; a block's key is the upper 16 bits of the indices it holds
+        constexpr std::uint32_t BLOCK_BITS   = 1 << 16;
+        constexpr std::uint32_t ARRAY_MAX    = 4'096;
+        constexpr std::uint32_t BITMAP_WORDS = BLOCK_BITS / 64;
+
+        enum class ContainerType : std::uint8_t {
+            // Sorted low 16 bits of each member. Smallest while there are at most ARRAY_MAX members
+            ARRAY,
+            // One bit per possible member, a fixed 8KiB
+            BITMAP,
+            // Sorted, disjoint, non-adjacent inclusive ranges. Only produced by optimise()
+            RUN
+        };
+
+        struct Run {
+                std::uint16_t first;
+                std::uint16_t last;
+        };
+
+        struct Container {
+                ContainerType type        = ContainerType::ARRAY;
+                std::uint32_t cardinality = 0;
+
+                // Only the storage matching type is populated
+                std::vector<std::uint16_t> array;
+                std::vector<std::uint64_t> bitmap;
+                std::vector<Run> runs;
+        };
+
+        struct Block {
+                std::uint16_t key;
+                Container container;
+        };
+    } // namespace compressed
+
+    /*
+        A roaring-style compressed bitset for large, sparse or clustered sets of 32 bit indices such as entity ids.
+
+        Indices are split into 64k blocks, and each block picks whichever of an array, a bitmap or a list of runs is
+        smallest for its contents. Empty blocks are not stored at all, so a handful of ids scattered over millions
+        costs a few bytes each rather than a bit for every possible id.
+
+        Use Bitset for small dense sets like component masks; from_bitset/to_bitset convert between the two
+    */
+    class CompressedBitset {
+        public:
+            ENGINE_API CompressedBitset() = default;
+
+            ENGINE_API static auto from_bitset(const Bitset& bitset) -> CompressedBitset;
+            ENGINE_API auto to_bitset() const -> Bitset;
+
+            ENGINE_API auto operator|(const CompressedBitset& rhs) const -> CompressedBitset;
+            ENGINE_API auto operator&(const CompressedBitset& rhs) const -> CompressedBitset;
+            ENGINE_API auto operator==(const CompressedBitset& rhs) const -> bool;
+
+            ENGINE_API auto operator|=(const CompressedBitset& rhs) -> CompressedBitset&;
+            ENGINE_API auto operator&=(const CompressedBitset& rhs) -> CompressedBitset&;
+
+            ENGINE_API auto operator[](std::uint32_t idx) const -> std::uint8_t;
+
+            ENGINE_API auto bit_or(const CompressedBitset& rhs) const -> CompressedBitset;
+            ENGINE_API auto bit_and(const CompressedBitset& rhs) const -> CompressedBitset;
+            // Members of this which are not members of rhs
+            ENGINE_API auto bit_and_not(const CompressedBitset& rhs) const -> CompressedBitset;
+            ENGINE_API auto bit_equals(const CompressedBitset& rhs) const -> bool;
+
+            ENGINE_API auto get(std::uint32_t idx) const -> std::uint8_t;
+
+            ENGINE_API auto set(std::uint32_t idx) -> void;
+            // Sets every index in [first, last]
+            ENGINE_API auto set_range(std::uint32_t first, std::uint32_t last) -> void;
+            ENGINE_API auto clear(std::uint32_t idx) -> void;
+
+            ENGINE_API auto count() const -> std::size_t;
+            ENGINE_API auto any() const -> bool;
+            ENGINE_API auto none() const -> bool;
+
+            // Re-encode blocks as runs where that is smaller. Worth calling once a set has been built
+            ENGINE_API auto optimise() -> void;
+
+            // Approximate heap usage of the containers in bytes
+            ENGINE_API auto memory_usage() const -> std::size_t;
+
+            // Calls func(idx) for every member in ascending order
+            template <typename TFunc>
+            auto for_each_set_bit(TFunc&& func) const -> void {
+                for (const auto& block : m_blocks) {
+                    auto base = static_cast<std::uint32_t>(block.key) << 16;
+                    switch (block.container.type) {
+                        case compressed::ContainerType::ARRAY:
+                            for (auto value : block.container.array) {
+                                func(base | value);
+                            }
+                            break;
+                        case compressed::ContainerType::BITMAP:
+                            for (std::uint32_t word_idx = 0; word_idx < compressed::BITMAP_WORDS; word_idx++) {
+                                auto word = block.container.bitmap[word_idx];
+                                while (word != 0) {
+                                    func(base | (word_idx * 64 + static_cast<std::uint32_t>(std::countr_zero(word))));
+                                    word &= word - 1;
+                                }
+                            }
+                            break;
+                        case compressed::ContainerType::RUN:
+                            for (auto run : block.container.runs) {
+                                for (std::uint32_t value = run.first; value <= run.last; value++) {
+                                    func(base | value);
+                                }
+                            }
+                            break;
+                    }
+                }
+            }
+
+        private:
+            // Sorted by key
+            std::vector<compressed::Block> m_blocks;
+
+            auto _find_block(std::uint16_t key) const -> const compressed::Block*;
+            auto _find_or_insert_block(std::uint16_t key) -> compressed::Block&;
+    };
+} // namespace ENGINE_NS
@@ -25,7 +25,7 @@ namespace std {
     template <>
     struct hash<ENGINE_NS::ecs::Map> {
             auto operator()(const ENGINE_NS::ecs::Map& map) const noexcept -> size_t {
-                return map.assigned_components.hash_;
+                return map.assigned_components.hash();
             }
     };
 } // namespace std
@@ -1,12 +1,19 @@
 #pragma once
 #include "engine/engine_utils.h"
+#include "engine/fileio/artifact_cache.h"
+#include "engine/fileio/file_watcher.h"
+#include "engine/fileio/virtual_file_system.h"
 #include "engine/graphics/graphics.h"
+#include "engine/jobs/job_system.h"
 #include "engine/logger.h"
 #include "engine/meta_defines.h"
 #include "engine/rwlock.h"
 #include "engine/state/manager.h"
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 namespace ENGINE_NS {
     enum class LogNamespaces : std::uint8_t {
@@ -23,16 +30,80 @@ namespace ENGINE_NS {
     class LogLocator {
         public:
             ENGINE_API LogLocator();
-            ENGINE_API auto get(LogNamespaces ns) -> RwDataMut<Logger>;
+            ENGINE_API ~LogLocator();
             ENGINE_API auto get(LogNamespaces ns) const -> RwData<Logger>;
 
+            // Checked before the logger is locked or anything is formatted, so a filtered-out call is one load
+            auto enabled(LogNamespaces ns, logger::Level level) const -> bool {
+                return logger::compiled_in(level) &&
+                       logger::passes(level, levels_[static_cast<std::size_t>(ns)].load(std::memory_order_relaxed));
+            }
+            // The most verbose level logged for ns. Everything is logged until this is set
+            ENGINE_API auto set_level(LogNamespaces ns, logger::Level level) -> void;
+
+            template <typename... T>
+            auto debug(LogNamespaces ns, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::DEBUG)) {
+                    this->log(ns, logger::Level::DEBUG, fmt, std::forward<T>(args)...);
+                }
+            }
+
+            template <typename... T>
+            auto error(LogNamespaces ns, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::ERROR)) {
+                    this->log(ns, logger::Level::ERROR, fmt, std::forward<T>(args)...);
+                }
+            }
+
+            template <typename... T>
+            auto warning(LogNamespaces ns, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::WARNING)) {
+                    this->log(ns, logger::Level::WARNING, fmt, std::forward<T>(args)...);
+                }
+            }
+
+            template <typename... T>
+            auto info(LogNamespaces ns, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::INFO)) {
+                    this->log(ns, logger::Level::INFO, fmt, std::forward<T>(args)...);
+                }
+            }
+
+            template <typename... T>
+            auto log(LogNamespaces ns, logger::Level level, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if (enabled(ns, level)) {
+                    get(ns).get().log(level, fmt, std::forward<T>(args)...);
+                }
+            }
+
+            // Wait until everything logged so far has been written out
+            ENGINE_API auto flush() -> void;
+            // Mirror every later entry into file as a binary log, readable with tools/log_decoder. nullptr stops
+            ENGINE_API auto write_binary_to(std::FILE* file) -> void;
+
             auto imgui() -> void;
 
         private:
+            // A line of the log window: which logger it came from and where it sits in that logger's history
+            struct ConsoleLine {
+                    std::uint8_t logger    = 0;
+                    std::uint64_t sequence = 0;
+            };
+            static constexpr std::size_t CONSOLE_LINES = 4'096;
+
+            auto push_console_line_(ConsoleLine line) -> void;
+
             friend class Engine;
-            uint64_t m_log_idx{};
+            logger::Sink m_sink{};
             std::array<RwLock<Logger>, static_cast<std::size_t>(LogNamespaces::COUNT)> loggers_;
+            std::array<std::atomic<logger::Level>, static_cast<std::size_t>(LogNamespaces::COUNT)> levels_;
             bool is_log_open_ = false;
+
+            // Entries from every logger merged in call order as they arrive; a ring holding the newest CONSOLE_LINES
+            std::vector<ConsoleLine> console_;
+            std::size_t console_start_ = 0;
+            // Per logger, the history sequence merged up to
+            std::array<std::uint64_t, static_cast<std::size_t>(LogNamespaces::COUNT)> console_seen_ = {};
     };
 
     class Engine {
@@ -45,8 +116,18 @@ namespace ENGINE_NS {
             ENGINE_API auto quit() -> void;
             ENGINE_API auto run() -> void;
 
+            // Mounted over the loose assets at startup when it exists
+            static constexpr const char* ASSET_ARCHIVE  = "assets.pak";
+            // Processed assets, reused across launches for as long as their sources are unchanged
+            static constexpr const char* ARTIFACT_CACHE = "cache/artifacts";
+
             StateManager state_manager{};
             LogLocator logger{};
+            JobSystem jobs{};
+            fileio::VirtualFileSystem files{&jobs};
+            // Loose assets are tracked as they load, so their metadata turns dirty when edited on disk
+            fileio::FileWatcher file_watcher{};
+            fileio::ArtifactCache artifacts{ARTIFACT_CACHE};
 
             const bool& crashed = crashed_;
 
@@ -2,8 +2,12 @@
 #include "engine/meta_defines.h"
 
 #include <vulkan/vulkan_core.h>
+#include <chrono>
 
 namespace ENGINE_NS {
+    // CPU time consumed by every thread of this process so far
+    auto process_cpu_time() -> std::chrono::nanoseconds;
+
     void vulkan_crash(VkResult error, int line, const char* function, const char* file);
     void crash(ErrorCode reason);
     void crash(ErrorCode reason, int line);
@@ -0,0 +1,147 @@
+#pragma once
+#include "engine/fileio/error.h"
+#include "engine/fileio/file.h"
+#include "engine/meta_defines.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+/*
+    Packed asset archives
+
+    Many small assets packed into one file, so startup maps a single file instead of opening each asset separately.
+    The layout is:
+        Header
+        Entry[entry_count]        path hash, blob offset, file and stored size, name offset and size, compression
+        u32[slot_count]           open addressed hash table of entry index + 1, 0 for an empty slot
+        names                     every entry's path, back to back, for resolving hash collisions
+        blobs                     each starting on a BLOB_ALIGNMENT boundary
+
+    Paths are stored normalised with forward slashes, exactly as they are asked for at runtime, so
+    "assets/shaders/game/tilemap/tilemap.spv" in the archive is found by loading that same path. Lookups hash the path
+    and probe the slot table, so they cost the same however many entries there are. Values are in the writer's byte
+    order; archives written with another are refused
+
+    Compressed blobs are split into BLOCK_SIZE blocks of the original file, each compressed on its own with lz, so they
+    decode in parallel and a bad block cannot corrupt its neighbours. A compressed blob is a u32 stored size per block
+    followed by the blocks back to back. Blocks that do not shrink are kept as they are and flagged with STORED_RAW,
+    and whole files that do not shrink are stored uncompressed and read in place as before
+*/
+namespace ENGINE_NS {
+    class JobSystem;
+
+    namespace fileio {
+        namespace archive {
+            constexpr std::array<char, 8> MAGIC     = {'E', 'N', 'G', 'P', 'A', 'K', '\0', '\0'};
+            constexpr std::uint32_t VERSION         = 2;
+            constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+            constexpr std::uint64_t BLOB_ALIGNMENT  = 4096;
+            constexpr std::uint64_t BLOCK_SIZE      = 64 * 1024;
+            constexpr std::uint32_t STORED_RAW      = 0x8000'0000;
+
+            enum class Compression : std::uint32_t {
+                NONE,
+                LZ
+            };
+
+            struct Header {
+                    std::array<char, 8> magic    = MAGIC;
+                    std::uint32_t version        = VERSION;
+                    std::uint32_t byte_order     = BYTE_ORDER_MARK;
+                    std::uint32_t entry_count    = 0;
+                    std::uint32_t slot_count     = 0;
+                    std::uint64_t entries_offset = 0;
+                    std::uint64_t slots_offset   = 0;
+                    std::uint64_t names_offset   = 0;
+                    std::uint64_t names_size     = 0;
+            };
+            struct Entry {
+                    std::uint64_t hash        = 0;
+                    std::uint64_t offset      = 0;
+                    std::uint64_t size        = 0;
+                    std::uint64_t stored_size = 0;
+                    std::uint32_t name_offset = 0;
+                    std::uint32_t name_size   = 0;
+                    Compression compression   = Compression::NONE;
+                    std::uint32_t reserved    = 0;
+            };
+            static_assert(sizeof(Header) == 56 && sizeof(Entry) == 48, "Archive layout must not depend on the compiler");
+
+            // A file as it sits in the archive. Uncompressed blobs are the file itself
+            struct Blob {
+                    std::span<const std::byte> stored;
+                    std::uint64_t size      = 0;
+                    Compression compression = Compression::NONE;
+            };
+
+            // The form paths are stored and looked up in: lexically normal, forward slashes, no leading "./"
+            ENGINE_API auto normalise(const std::filesystem::path& path) -> std::string;
+            // 64 bit FNV-1a. Part of the format, so it must never change without bumping VERSION
+            ENGINE_API auto hash(std::string_view path) -> std::uint64_t;
+
+            // Decode blob into destination, which must be exactly blob.size bytes. Blocks are split across jobs when
+            // given a job system. False if the blob is corrupt, in which case destination holds garbage
+            [[nodiscard("not checking if the blob was corrupt")]]
+            ENGINE_API auto unpack(const Blob& blob, std::span<std::byte> destination, JobSystem* jobs = nullptr) -> bool;
+        } // namespace archive
+
+        // A mapped archive. Blobs are read in place and stay valid for as long as the archive lives, including across moves
+        class Archive {
+            public:
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API static auto open(const std::filesystem::path& path) -> std::expected<Archive, error::Error>;
+
+                ENGINE_API auto find(const std::filesystem::path& path) const -> std::optional<archive::Blob>;
+                // Lookup for a path already in archive::normalise form
+                ENGINE_API auto find_normalised(std::string_view path) const -> std::optional<archive::Blob>;
+
+                auto size() const -> std::size_t {
+                    return entries_.size();
+                }
+                auto metadata() const -> const FileMetadata& {
+                    return file_.metadata;
+                }
+
+            private:
+                explicit Archive(MappedFile&& file);
+
+                MappedFile file_;
+                std::span<const archive::Entry> entries_;
+                std::span<const std::uint32_t> slots_;
+                std::string_view names_;
+        };
+
+        // Collects files and writes them out as one archive
+        class ArchiveWriter {
+            public:
+                explicit ArchiveWriter(archive::Compression compression = archive::Compression::NONE) : compression_(compression) {
+                }
+
+                // Adding the same archive path twice keeps the later source
+                ENGINE_API auto add_file(const std::filesystem::path& archive_path, const std::filesystem::path& source) -> void;
+                // Every regular file under directory, stored under its path as given joined with the file's relative path
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto add_directory(const std::filesystem::path& directory) -> std::expected<void, error::Error>;
+
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto write(const std::filesystem::path& output) const -> std::expected<void, error::Error>;
+
+                auto size() const -> std::size_t {
+                    return sources_.size();
+                }
+
+            private:
+                // Ordered so the same inputs always produce the same archive
+                std::map<std::string, std::filesystem::path> sources_;
+                archive::Compression compression_ = archive::Compression::NONE;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
@@ -0,0 +1,78 @@
+#pragma once
+#include "engine/fileio/error.h"
+#include "engine/fileio/file.h"
+#include "engine/meta_defines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        // Identifies one processed form of one source: what processed it, how, and from exactly which bytes
+        struct ArtifactKey {
+                std::string processor{};
+                std::uint64_t source_hash     = 0;
+                std::uint64_t parameters_hash = 0;
+                std::uint64_t source_size     = 0;
+
+                // The artifact's name inside the cache directory
+                ENGINE_API auto file_name() const -> std::string;
+                auto operator==(const ArtifactKey& rhs) const -> bool = default;
+        };
+
+        /*
+            Content addressed cache of processed assets: compiled shaders, mipmapped textures, optimised meshes
+
+            Artifacts are named by a content_hash of their source and of the parameters they were processed with, so a
+            source edited and then reverted finds its old artifact again, and nothing has to compare timestamps. Editing
+            one asset reprocesses only that asset on the next launch. Artifacts are written to a temporary name and
+            renamed into place, so a crash or a second process storing the same key never leaves a partial artifact
+            behind. Hits are mapped rather than read.
+
+            Nothing is ever evicted; the directory can be deleted at any time to start over
+        */
+        class ArtifactCache {
+            public:
+                ENGINE_API explicit ArtifactCache(std::filesystem::path directory);
+
+                // processor names the processing step and its version, e.g. "mipmaps-2". Bump the version whenever the
+                // step's output changes. parameters holds every setting that changes the output
+                ENGINE_API static auto key(std::string_view processor,
+                                           std::span<const std::byte> source,
+                                           std::span<const std::byte> parameters = {}) -> ArtifactKey;
+
+                ENGINE_API auto find(const ArtifactKey& key) const -> std::optional<MappedFile>;
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto store(const ArtifactKey& key, std::span<const std::byte> artifact) const
+                    -> std::expected<void, error::Error>;
+
+                // The cached artifact for key, otherwise the result of process() once it has been stored. process
+                // returns any contiguous container of trivially copyable values
+                template <typename TProcess>
+                auto get_or_process(const ArtifactKey& key, TProcess&& process) const -> std::expected<MappedFile, error::Error> {
+                    if (auto cached = find(key)) {
+                        return std::move(cached.value());
+                    }
+                    auto artifact = std::forward<TProcess>(process)();
+                    if (auto err = store(key, std::as_bytes(std::span(artifact))); !err) {
+                        return std::unexpected(err.error());
+                    }
+                    return File::map(directory_ / key.file_name(), AccessHint::SEQUENTIAL);
+                }
+
+                auto directory() const -> const std::filesystem::path& {
+                    return directory_;
+                }
+
+            private:
+                std::filesystem::path directory_;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
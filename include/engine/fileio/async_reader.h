@@ -0,0 +1,91 @@
+#pragma once
+#include "engine/fileio/error.h"
+#include "engine/meta_defines.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        // Bytes read, which is less than requested only when the file ends first
+        using ReadResult = std::expected<std::size_t, error::Error>;
+
+        struct ReadRequest {
+                std::filesystem::path path{};
+                std::uint64_t offset = 0;
+                // Must stay valid until the read completes
+                std::span<std::byte> destination{};
+                // Runs on an I/O thread as soon as this read finishes, before the rest of its batch. Keep it short, or
+                // hand the data to the job system, so it does not hold up other reads
+                std::function<void(ReadResult)> on_complete = nullptr;
+        };
+
+        /*
+            Asynchronous batched file reader
+
+            Batches of reads are handed to I/O threads and complete in whatever order the disk finishes them, so loads
+            which touch many files can decode each one as it lands rather than waiting on serial reads. Each file in a
+            batch is opened once however many reads it has.
+
+            On Linux reads go through an io_uring, keeping up to queue_depth of them in flight from a single thread.
+            Where io_uring is missing or not permitted, and on other platforms, a small pool of threads issues blocking
+            positional reads instead. Batches still queued when the reader is destroyed are finished first
+        */
+        class AsyncReader {
+            public:
+                enum class Backend : std::uint8_t {
+                    // io_uring when the kernel allows it, otherwise THREAD_POOL
+                    AUTO,
+                    IO_URING,
+                    THREAD_POOL
+                };
+
+                static constexpr std::uint32_t DEFAULT_QUEUE_DEPTH = 64;
+                static constexpr std::size_t DEFAULT_THREADS       = 4;
+
+                ENGINE_API explicit AsyncReader(Backend backend           = Backend::AUTO,
+                                                std::uint32_t queue_depth = DEFAULT_QUEUE_DEPTH,
+                                                std::size_t threads       = DEFAULT_THREADS);
+                ENGINE_API ~AsyncReader();
+
+                AsyncReader(const AsyncReader&)                    = delete;
+                auto operator=(const AsyncReader&) -> AsyncReader& = delete;
+
+                // Results are in request order
+                [[nodiscard("the future is the only way to know when the batch is done")]]
+                ENGINE_API auto submit(std::vector<ReadRequest> batch) -> std::future<std::vector<ReadResult>>;
+
+                // The backend actually in use; never AUTO
+                ENGINE_API auto backend() const -> Backend;
+
+            private:
+                struct Batch;
+                struct Ring;
+
+                auto ring_loop_() -> void;
+                auto pool_loop_() -> void;
+
+                Backend backend_;
+                std::uint32_t queue_depth_;
+                std::unique_ptr<Ring> ring_;
+
+                std::mutex mutex_;
+                std::condition_variable condition_;
+                std::deque<std::shared_ptr<Batch>> queue_;
+                bool running_ = true;
+
+                std::vector<std::thread> threads_;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
@@ -0,0 +1,25 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        /*
+            Fast 64 bit hash of file contents, in the wyhash family: 48 byte stripes through three independent
+            multiply-fold lanes, so large inputs run at memory bandwidth rather than at the latency of one dependency
+            chain. Not cryptographic; it is for noticing that content changed, not for defending against crafted
+            collisions.
+
+            The result is the same on every platform and must stay so, since it names files on disk
+        */
+        ENGINE_API auto content_hash(std::span<const std::byte> bytes, std::uint64_t seed = 0) -> std::uint64_t;
+
+        inline auto content_hash(std::string_view text, std::uint64_t seed = 0) -> std::uint64_t {
+            return content_hash(std::as_bytes(std::span(text)), seed);
+        }
+    } // namespace fileio
+} // namespace ENGINE_NS
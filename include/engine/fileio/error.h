@@ -18,7 +18,10 @@ namespace ENGINE_NS {
                 NOT_WRITEABLE,
                 NOT_READABLE,
                 WRITE_ERROR,
-                OPEN
+                OPEN,
+                MAP,
+                READ_ERROR,
+                INVALID_ARCHIVE
             };
 
             namespace types {
@@ -69,6 +72,22 @@ namespace ENGINE_NS {
                 struct Open : Base {
                         inline Open() : Base("An error occured while opening the file", errno) {
                         }
+                        inline Open(int error_code) : Base("An error occured while opening the file", error_code) {
+                        }
+                };
+                struct Read : Base {
+                        inline Read() : Base("An error occured while reading from file") {};
+                        inline Read(int error_code) : Base("An error occured while reading from file", error_code) {};
+                };
+                struct InvalidArchive : Base {
+                        inline InvalidArchive() : Base("The file is not a valid archive") {
+                        }
+                };
+                struct Map : Base {
+                        inline Map() : Base("An error occured while mapping the file") {
+                        }
+                        inline Map(int error_code) : Base("An error occured while mapping the file", error_code) {
+                        }
                 };
             } // namespace types
 
@@ -85,6 +104,9 @@ namespace ENGINE_NS {
                             types::NotReadable not_readable;
                             types::Write write;
                             types::Open open;
+                            types::Map map;
+                            types::Read read;
+                            types::InvalidArchive invalid_archive;
                             Contained();
                     } contained;
                     std::uint8_t _padding[3] = {};
@@ -161,6 +183,36 @@ namespace ENGINE_NS {
                     static inline auto open() -> Error {
                         return Error(types::Open{});
                     }
+                    static inline auto open(int error_code) -> Error {
+                        return Error(types::Open(error_code));
+                    }
+
+                    inline Error(types::Map error) : error(Flag::MAP), reason(contained.map.reason) {
+                        contained.map = error;
+                    }
+                    static inline auto map() -> Error {
+                        return Error(types::Map{});
+                    }
+                    static inline auto map(int error_code) -> Error {
+                        return Error(types::Map(error_code));
+                    }
+
+                    inline Error(types::Read error) : error(Flag::READ_ERROR), reason(contained.read.reason) {
+                        contained.read = error;
+                    }
+                    static inline auto read() -> Error {
+                        return Error(types::Read{});
+                    }
+                    static inline auto read(int error_code) -> Error {
+                        return Error(types::Read(error_code));
+                    }
+
+                    inline Error(types::InvalidArchive error) : error(Flag::INVALID_ARCHIVE), reason(contained.invalid_archive.reason) {
+                        contained.invalid_archive = error;
+                    }
+                    static inline auto invalid_archive() -> Error {
+                        return Error(types::InvalidArchive{});
+                    }
             };
         } // namespace error
     } // namespace fileio
@@ -3,10 +3,13 @@
 #include "engine/meta_defines.h"
 #include "engine/newtype.h"
 
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
 #include <expected>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -38,6 +41,8 @@ namespace ENGINE_NS {
         struct FileMetadata {
                 std::filesystem::path path{};
                 std::filesystem::file_time_type last_write{};
+                // Set by a FileWatcher tracking this file once it changes on disk. Shared by copies of this metadata
+                std::shared_ptr<const std::atomic<bool>> changed{};
                 auto dirty() const -> bool;
         };
         struct IoMetadata {
@@ -45,6 +50,15 @@ namespace ENGINE_NS {
                 OpenMode open_mode{};
         };
 
+        // How a mapping is expected to be read, so the kernel can read ahead or drop pages accordingly
+        enum class AccessHint : std::uint8_t {
+            NORMAL,
+            SEQUENTIAL,
+            RANDOM,
+            WILL_NEED,
+            DONT_NEED
+        };
+
         struct Offset : public NewType<Offset, std::uint64_t> {};
         struct Position : public NewType<Position, std::uint64_t> {
                 inline auto is_eof() const -> bool {
@@ -62,10 +76,14 @@ namespace ENGINE_NS {
                 bool is_eof_ = false;
                 friend class File;
         };
+        class MappedFile;
         class File {
             public:
                 static auto open(const std::filesystem::path& path, OpenMode open_mode, IoMode io_mode)
                     -> std::expected<File, error::Error>;
+                // Map a whole file read-only, so it can be parsed in place without copying it into a buffer
+                static auto map(const std::filesystem::path& path, AccessHint hint = AccessHint::NORMAL)
+                    -> std::expected<MappedFile, error::Error>;
 
 
                 File(File&& rhs) noexcept;
@@ -110,23 +128,16 @@ namespace ENGINE_NS {
                     }
                     return std::expected<void, error::Error>{};
                 }
+                // Spans write their elements, never the span itself
+                template <typename T, std::size_t Extent, typename = std::enable_if<std::is_trivially_copyable_v<T>>::type>
+                [[nodiscard("not checking if operation has an error")]]
+                auto write(std::span<T, Extent> to_write) -> std::expected<void, error::Error> {
+                    return write_(to_write.data(), sizeof(T), to_write.size());
+                }
                 template <typename T, typename = std::enable_if<std::is_trivially_copyable_v<T>>::type>
                 [[nodiscard("not checking if operation has an error")]]
                 auto write_buffer(const std::vector<T>& to_write) -> std::expected<void, error::Error> {
-                    if (!handle_ || moved_) {
-                        return std::expected<void, error::Error>{};
-                    }
-                    if (!is_writable()) {
-                        return std::unexpected(error::Error::not_writable());
-                    }
-                    if (std::fwrite(to_write.data(), sizeof(T), to_write.size(), handle_) != to_write.size()) {
-                        if (errno < 0) {
-                            return std::unexpected(error::Error::write(errno));
-                        } else {
-                            return std::unexpected(error::Error::write());
-                        }
-                    }
-                    return std::expected<void, error::Error>{};
+                    return write(std::span<const T>(to_write));
                 }
 
                 template <typename TInner, typename = std::enable_if<std::is_trivially_copyable_v<TInner>>::type>
@@ -141,18 +152,45 @@ namespace ENGINE_NS {
                 template <typename TInner, typename = std::enable_if<std::is_trivially_copyable_v<TInner>>::type>
                 [[nodiscard("not checking if operation has an error")]]
                 auto read_into(std::vector<TInner>& buffer) -> std::expected<void, error::Error> {
-                    if (!handle_ || moved_) {
-                        return std::expected<void, error::Error>{};
-                    }
-                    if (!is_readable()) {
-                        return std::unexpected(error::Error::not_readable());
-                    }
-                    std::fread(buffer.data(), sizeof(TInner), buffer.size(), handle_);
-                    if (std::ferror(handle_)) {
-                        return std::unexpected(error::Error::indicator());
+                    if (auto err = read_into(std::span<TInner>(buffer)); !err) {
+                        return std::unexpected(err.error());
                     }
                     return std::expected<void, error::Error>{};
                 }
+                // Read straight into caller owned memory, such as a mapped staging buffer. Returns how many whole
+                // elements were read, which is fewer than requested only at the end of the file
+                template <typename TInner, std::size_t Extent, typename = std::enable_if<std::is_trivially_copyable_v<TInner>>::type>
+                [[nodiscard("not checking if operation has an error")]]
+                auto read_into(std::span<TInner, Extent> buffer) -> std::expected<std::size_t, error::Error> {
+                    return read_(buffer.data(), sizeof(TInner), buffer.size());
+                }
+
+                /*
+                    Positional reads and writes at an absolute byte offset, leaving the cursor where it was. Writes
+                    buffered by the stream are flushed first so positional reads see them. They bypass the stream's own
+                    buffer, so interleaving them with cursor writes to the same bytes needs a flush in between
+                */
+                template <typename TInner, std::size_t Extent, typename = std::enable_if<std::is_trivially_copyable_v<TInner>>::type>
+                [[nodiscard("not checking if operation has an error")]]
+                auto pread(std::uint64_t offset, std::span<TInner, Extent> buffer) -> std::expected<std::size_t, error::Error> {
+                    auto read = pread_(offset, std::as_writable_bytes(buffer));
+                    if (!read) {
+                        return std::unexpected(read.error());
+                    }
+                    return *read / sizeof(TInner);
+                }
+                template <typename T, std::size_t Extent, typename = std::enable_if<std::is_trivially_copyable_v<T>>::type>
+                [[nodiscard("not checking if operation has an error")]]
+                auto pwrite(std::uint64_t offset, std::span<T, Extent> to_write) -> std::expected<void, error::Error> {
+                    return pwrite_(offset, std::as_bytes(to_write));
+                }
+
+                // Scatter consecutive bytes from the cursor into each buffer in turn. Returns the bytes read
+                [[nodiscard("not checking if operation has an error")]]
+                auto readv(std::span<const std::span<std::byte>> buffers) -> std::expected<std::size_t, error::Error>;
+                // Gather each buffer in turn into consecutive bytes at the cursor
+                [[nodiscard("not checking if operation has an error")]]
+                auto writev(std::span<const std::span<const std::byte>> buffers) -> std::expected<void, error::Error>;
 
                 auto is_writable() const -> bool;
                 auto is_readable() const -> bool;
@@ -166,7 +204,63 @@ namespace ENGINE_NS {
                 std::FILE* handle_ = nullptr;
 
             private:
+                auto read_(void* data, std::size_t size, std::size_t count) -> std::expected<std::size_t, error::Error>;
+                auto write_(const void* data, std::size_t size, std::size_t count) -> std::expected<void, error::Error>;
+                auto pread_(std::uint64_t offset, std::span<std::byte> buffer) -> std::expected<std::size_t, error::Error>;
+                auto pwrite_(std::uint64_t offset, std::span<const std::byte> buffer) -> std::expected<void, error::Error>;
+
                 bool moved_ = false;
         };
+
+        /*
+            Read-only view of a whole file, unmapped when destroyed
+
+            The bytes stay valid for as long as the mapping lives, including across moves. Writes to the file by other
+            processes may or may not show through, so map only assets that are not being rewritten underneath
+        */
+        class MappedFile {
+            public:
+                MappedFile(MappedFile&& rhs) noexcept;
+                auto operator=(MappedFile&& rhs) noexcept -> MappedFile&;
+                ~MappedFile();
+
+                MappedFile(const MappedFile&)                    = delete;
+                auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+                auto bytes() const -> std::span<const std::byte> {
+                    return {data_, size_};
+                }
+                auto size() const -> std::size_t {
+                    return size_;
+                }
+                auto empty() const -> bool {
+                    return size_ == 0;
+                }
+
+                // The file viewed as whole Ts; trailing bytes that do not fill a T are left out. Mappings start on a page
+                // boundary, so any T with a smaller alignment can be read in place
+                template <typename T, typename = std::enable_if<std::is_trivially_copyable_v<T>>::type>
+                auto view() const -> std::span<const T> {
+                    static_assert(alignof(T) <= 4096, "Mappings are only page aligned");
+                    return {reinterpret_cast<const T*>(data_), size_ / sizeof(T)};
+                }
+
+                // Hint how a byte range will be read. Ranges are widened to whole pages; advice is best effort and
+                // never fails
+                auto advise(AccessHint hint, std::size_t offset = 0, std::size_t length = SIZE_MAX) const -> void;
+
+                const FileMetadata& metadata = metadata_;
+
+            private:
+                MappedFile(FileMetadata file_metadata, const std::byte* data, std::size_t size, void* mapping);
+                auto release_() -> void;
+
+                FileMetadata metadata_{};
+                const std::byte* data_ = nullptr;
+                std::size_t size_      = 0;
+                // The file mapping object on Windows; unused elsewhere
+                void* mapping_ = nullptr;
+                friend class File;
+        };
     } // namespace fileio
 } // namespace ENGINE_NS
@@ -0,0 +1,88 @@
+#pragma once
+#include "engine/fileio/error.h"
+#include "engine/fileio/file.h"
+#include "engine/meta_defines.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        /*
+            Notices tracked files changing on disk without stat-ing them every frame
+
+            On Linux each tracked file's directory gets an inotify watch, since editors tend to save by writing a new
+            file and renaming it over the old one, which a watch on the file itself would lose. A background thread
+            gathers events for batch_window after the first one arrives, so a save that touches a file several times is
+            reported once. It then sets the flag behind dirty() on every FileMetadata tracking a changed file and hands
+            the changed paths to each subscriber, on the watcher thread. Deleted files count as changed.
+
+            Other platforms have no backend yet: tracking succeeds, but nothing is ever marked dirty
+        */
+        class FileWatcher {
+            public:
+                // Paths as they were first tracked
+                using Subscriber     = std::function<void(std::span<const std::filesystem::path>)>;
+                using SubscriptionId = std::uint64_t;
+
+                static constexpr std::chrono::milliseconds DEFAULT_BATCH_WINDOW{50};
+
+                ENGINE_API explicit FileWatcher(std::chrono::milliseconds batch_window = DEFAULT_BATCH_WINDOW);
+                ENGINE_API ~FileWatcher();
+
+                FileWatcher(const FileWatcher&)                    = delete;
+                auto operator=(const FileWatcher&) -> FileWatcher& = delete;
+
+                // Give metadata a fresh flag and set it once metadata.path changes. A file is reported once, then no longer
+                // followed; track it again after reloading it to start clean
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto track(FileMetadata& metadata) -> std::expected<void, error::Error>;
+
+                // A subscriber may still be called by a batch that was already being delivered when it unsubscribed.
+                // Subscribers must not subscribe or unsubscribe themselves
+                ENGINE_API auto subscribe(Subscriber subscriber) -> SubscriptionId;
+                ENGINE_API auto unsubscribe(SubscriptionId id) -> void;
+
+                // False if the platform has no backend or the kernel refused one
+                ENGINE_API auto available() const -> bool;
+
+            private:
+                struct Tracked {
+                        std::filesystem::path path;
+                        std::vector<std::weak_ptr<std::atomic<bool>>> flags;
+                };
+
+                auto run_() -> void;
+                auto flush_(std::vector<std::string>& changed) -> void;
+
+                std::chrono::milliseconds batch_window_;
+                int inotify_ = -1;
+                // Written to wake the watcher thread when shutting down
+                int wake_    = -1;
+
+                std::mutex mutex_;
+                // Keyed by absolute, lexically normal path
+                std::unordered_map<std::string, Tracked> tracked_;
+                std::unordered_map<std::string, int> watches_;
+                std::unordered_map<int, std::filesystem::path> directories_;
+
+                std::mutex subscribers_mutex_;
+                std::vector<std::pair<SubscriptionId, Subscriber>> subscribers_;
+                SubscriptionId next_subscription_ = 1;
+
+                std::thread thread_;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
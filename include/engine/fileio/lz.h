@@ -0,0 +1,35 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+/*
+    LZ block codec
+
+    A small LZ77 byte codec in the LZ4 block layout: sequences of a token byte (literal count and match length
+    nibbles, each extended with 255-runs when saturated), the literals, then a 16 bit little endian match offset. The
+    last sequence is literals only. Compression is a single greedy pass with a 4 byte hash table, so it trades ratio
+    for speed; decompression is a tight copy loop that checks every length and offset against both buffers, so
+    corrupt input fails rather than reading or writing out of bounds.
+
+    Offsets are 16 bit, so inputs are meant to be blocks of at most 64 KiB
+*/
+namespace ENGINE_NS {
+    namespace fileio {
+        namespace lz {
+            // Worst case compressed size of size bytes of incompressible input
+            constexpr auto compress_bound(std::size_t size) -> std::size_t {
+                return size + size / 255 + 16;
+            }
+
+            // Compress source into destination. Returns the compressed size, or 0 if destination is too small
+            ENGINE_API auto compress(std::span<const std::byte> source, std::span<std::byte> destination) -> std::size_t;
+
+            // Decompress source into destination. Returns the decompressed size, or nothing if source is malformed or
+            // would not fit
+            ENGINE_API auto decompress(std::span<const std::byte> source, std::span<std::byte> destination) -> std::optional<std::size_t>;
+        } // namespace lz
+    } // namespace fileio
+} // namespace ENGINE_NS
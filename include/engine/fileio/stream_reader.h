@@ -0,0 +1,56 @@
+#pragma once
+#include "engine/fileio/error.h"
+#include "engine/meta_defines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        /*
+            Reads one large file front to back, a chunk at a time, with the next chunk already being read
+
+            Two chunk buffers alternate: while the caller parses the chunk next() last returned, a background thread
+            fills the other one, so parsing and disk reads overlap instead of taking turns. The file is opened with a
+            sequential access hint (posix_fadvise on Linux, FILE_FLAG_SEQUENTIAL_SCAN on Windows) so the kernel reads
+            further ahead. Pages already read stay in the page cache.
+
+            Meant for level and mesh files too big to map comfortably or wanted in one pass; small files are better
+            served by File::map or the virtual file system
+        */
+        class StreamReader {
+            public:
+                static constexpr std::size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API static auto open(const std::filesystem::path& path, std::size_t chunk_size = DEFAULT_CHUNK_SIZE)
+                    -> std::expected<StreamReader, error::Error>;
+
+                ENGINE_API StreamReader(StreamReader&& rhs) noexcept;
+                ENGINE_API auto operator=(StreamReader&& rhs) noexcept -> StreamReader&;
+                ENGINE_API ~StreamReader();
+
+                // The next chunk, valid until the following call. Every chunk is chunk_size bytes except the last; an empty
+                // chunk means the whole file has been read
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto next() -> std::expected<std::span<const std::byte>, error::Error>;
+
+                // Size of the file when it was opened
+                ENGINE_API auto size() const -> std::uint64_t;
+                // File offset of the chunk next() last returned
+                ENGINE_API auto offset() const -> std::uint64_t;
+
+            private:
+                struct State;
+
+                explicit StreamReader(std::unique_ptr<State> state);
+                auto close_() -> void;
+
+                std::unique_ptr<State> state_;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
@@ -0,0 +1,87 @@
+#pragma once
+#include "engine/fileio/archive.h"
+#include "engine/fileio/error.h"
+#include "engine/fileio/file.h"
+#include "engine/meta_defines.h"
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace ENGINE_NS {
+    namespace fileio {
+        // The bytes of an asset: borrowed from a mounted archive, decompressed from one, or mapped from a loose file
+        class VirtualFile {
+            public:
+                auto bytes() const -> std::span<const std::byte> {
+                    return bytes_;
+                }
+                auto size() const -> std::size_t {
+                    return bytes_.size();
+                }
+                auto empty() const -> bool {
+                    return bytes_.empty();
+                }
+                // Archive blobs and mappings start on a page boundary and decompressed files are allocated with the default new
+                // alignment, so any T no more aligned than std::max_align_t reads in place
+                template <typename T, typename = std::enable_if<std::is_trivially_copyable_v<T>>::type>
+                auto view() const -> std::span<const T> {
+                    return {reinterpret_cast<const T*>(bytes_.data()), bytes_.size() / sizeof(T)};
+                }
+                auto from_archive() const -> bool {
+                    return !loose_.has_value();
+                }
+
+                const FileMetadata& metadata = metadata_;
+
+                VirtualFile(VirtualFile&& rhs) noexcept;
+                auto operator=(VirtualFile&& rhs) noexcept -> VirtualFile&;
+
+            private:
+                VirtualFile(FileMetadata file_metadata, std::span<const std::byte> bytes);
+                VirtualFile(FileMetadata file_metadata, std::vector<std::byte>&& unpacked);
+                explicit VirtualFile(MappedFile&& file);
+
+                FileMetadata metadata_{};
+                std::optional<MappedFile> loose_;
+                std::vector<std::byte> unpacked_;
+                std::span<const std::byte> bytes_;
+                friend class VirtualFileSystem;
+        };
+
+        /*
+            Resolves asset paths against mounted archives before falling back to loose files on disk
+
+            Archives are searched newest mount first, so a patch archive mounted after the base one overrides it. Paths
+            are matched the way archive::normalise writes them. Mount everything up front: opening files is safe from
+            any number of threads, but not while another thread mounts. Uncompressed files opened from an archive borrow
+            its memory and must not outlive the file system. Compressed ones are decoded into memory the file owns, with
+            their blocks split across jobs when the file system is given a job system
+        */
+        class VirtualFileSystem {
+            public:
+                explicit VirtualFileSystem(JobSystem* jobs = nullptr) : jobs_(jobs) {
+                }
+
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto mount(const std::filesystem::path& archive_path) -> std::expected<void, error::Error>;
+                ENGINE_API auto mount(Archive&& archive) -> void;
+
+                [[nodiscard("not checking if operation has an error")]]
+                ENGINE_API auto open(const std::filesystem::path& path) const -> std::expected<VirtualFile, error::Error>;
+                ENGINE_API auto exists(const std::filesystem::path& path) const -> bool;
+
+                auto archive_count() const -> std::size_t {
+                    return archives_.size();
+                }
+
+            private:
+                std::vector<Archive> archives_;
+                JobSystem* jobs_ = nullptr;
+        };
+    } // namespace fileio
+} // namespace ENGINE_NS
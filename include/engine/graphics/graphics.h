@@ -6,6 +6,8 @@
 #include "engine/graphics/util.h"
 #include "engine/graphics/vulkan.h"
 #include "engine/meta_defines.h"
+#include "engine/mpsc_queue.h"
+#include "engine/rcu.h"
 #include "engine/rwlock.h"
 
 #include <volk/volk.h>
@@ -42,12 +44,19 @@ namespace ENGINE_NS {
     class GraphicsEngine;
 
     namespace graphics {
-        constexpr std::size_t FRAME_OVERLAP  = 2;
-        constexpr const char* IMMEDIATE_NAME = "immediate";
+        constexpr std::size_t FRAME_OVERLAP         = 2;
+        constexpr std::size_t UPLOAD_QUEUE_CAPACITY = 1'024;
+        constexpr const char* IMMEDIATE_NAME        = "immediate";
+
+        class RegisteredPipeline;
+        using PipelineRegistry = tsl::robin_map<std::uint64_t, std::shared_ptr<RegisteredPipeline>>;
+
         struct FrameData {
                 // Allocations that are created in the process of rendering. Should never be pushed to outside the render thread
                 GraphicsPerFrameDeletionQueue deletion_queue{};
-                std::vector<std::uint64_t> in_use_pipelines;
+                // The registry version this frame last recorded with. Holding it keeps those pipelines alive until the frame's
+                // fence has been waited on
+                std::shared_ptr<const PipelineRegistry> pipelines;
                 DescriptorAllocatorGrowable descriptor_allocator;
                 VkCommandPool command_pool          = VK_NULL_HANDLE;
                 VkCommandBuffer main_command_buffer = VK_NULL_HANDLE;
@@ -192,7 +201,8 @@ namespace ENGINE_NS {
             ImageAllocation& draw_image = draw_image_;
 
         private:
-            bool initialised_ = false;
+            // Worker threads wait on this until initialise has finished
+            std::atomic<bool> initialised_ = false;
 
             GraphicsMainDeletionQueue deletion_queue_{};
             GraphicsPerFrameDeletionQueue frame_deletion_queue_{};
@@ -203,23 +213,29 @@ namespace ENGINE_NS {
             VulkanDescriptorSetLayout draw_image_layout_{};
 
             RwLock<std::vector<std::unique_ptr<graphics::RegisteredPipeline>>> new_pipelines_;
-            RwLock<tsl::robin_map<std::uint64_t, std::unique_ptr<graphics::RegisteredPipeline>>> registered_pipelines_;
-            RwLock<tsl::robin_map<std::uint64_t, std::uint64_t>> in_use_pipelines_;
-            RwLock<std::vector<std::unique_ptr<graphics::RegisteredPipeline>>> to_delete_pipelines_;
+            // Pipelines are destroyed when the last registry version referencing them is released
+            Rcu<graphics::PipelineRegistry> registered_pipelines_;
             std::uint64_t next_pipeline_uid_ = 0;
 
             std::thread render_thread_;
-            std::chrono::milliseconds update_rate_;
+            // Bumped by draw() each main loop frame; the render thread sleeps until it changes
+            std::atomic<std::uint64_t> frame_requests_ = 0;
 
             GraphicsUploadDeletionQueue upload_deletion_queue_{};
-            RwLock<std::deque<graphics::MeshUpload>> mesh_uploads_;
-            RwLock<std::deque<graphics::TextureUpload>> texture_uploads_;
+            // Requests waiting on the upload thread. Producers only block once UPLOAD_QUEUE_CAPACITY are outstanding
+            MpscQueue<graphics::MeshUpload> mesh_uploads_{graphics::UPLOAD_QUEUE_CAPACITY};
+            MpscQueue<graphics::TextureUpload> texture_uploads_{graphics::UPLOAD_QUEUE_CAPACITY};
             std::thread upload_thread_;
-            std::atomic<bool> upload_ready_;
+            std::mutex upload_lock_;
+            std::condition_variable upload_condition_{};
+            bool upload_ready_ = false;
 
             std::thread pipeline_compile_thread_;
             std::mutex pipeline_compile_lock_;
             std::condition_variable pipeline_compile_condition_{};
+            // Ids taken off new_pipelines_ and still compiling, guarded by pipeline_compile_lock_. Deregistering one removes
+            // it here so the compile thread drops it instead of publishing it
+            std::vector<std::uint64_t> compiling_pipelines_;
 
             std::atomic<bool> running_;
 
@@ -260,6 +276,7 @@ namespace ENGINE_NS {
             auto draw_() -> void;
 
             auto upload_() -> void;
+            auto notify_upload_() -> void;
             auto upload_meshes_(std::vector<graphics::StagingBuffer>& staging_buffers) -> void;
             auto upload_textures_(std::vector<graphics::StagingBuffer>& staging_buffers) -> void;
 
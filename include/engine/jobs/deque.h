@@ -0,0 +1,94 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace ENGINE_NS {
+    namespace jobs {
+        /*
+            Fixed capacity Chase-Lev work-stealing deque of pointers
+
+            The owning thread pushes and pops at the bottom (LIFO, so it keeps working on what is hot in cache) while
+            any other thread may steal from the top (FIFO, taking the oldest and usually largest pieces of work).
+            Only push and pop may be called by the owner, steal may be called from anywhere
+        */
+        template <typename T>
+        class WorkStealingDeque {
+            public:
+                explicit WorkStealingDeque(std::size_t capacity) :
+                    mask_(capacity - 1), buffer_(std::make_unique<std::atomic<T*>[]>(capacity)) {
+                    assert(std::has_single_bit(capacity) && "Capacity must be a power of two");
+                }
+
+                WorkStealingDeque(const WorkStealingDeque&)                    = delete;
+                auto operator=(const WorkStealingDeque&) -> WorkStealingDeque& = delete;
+
+                // Returns false when full
+                auto push(T* item) -> bool {
+                    auto bottom = bottom_.load(std::memory_order_relaxed);
+                    auto top    = top_.load(std::memory_order_acquire);
+                    if (bottom - top > static_cast<std::int64_t>(mask_)) {
+                        return false;
+                    }
+                    buffer_[static_cast<std::size_t>(bottom) & mask_].store(item, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                auto pop() -> T* {
+                    auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+                    bottom_.store(bottom, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    auto top = top_.load(std::memory_order_relaxed);
+
+                    if (top > bottom) {
+                        bottom_.store(bottom + 1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+
+                    auto* item = buffer_[static_cast<std::size_t>(bottom) & mask_].load(std::memory_order_relaxed);
+                    if (top == bottom) {
+                        // Last item: race any thieves for it
+                        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                            item = nullptr;
+                        }
+                        bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    }
+                    return item;
+                }
+
+                auto steal() -> T* {
+                    auto top = top_.load(std::memory_order_acquire);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    auto bottom = bottom_.load(std::memory_order_acquire);
+                    if (top >= bottom) {
+                        return nullptr;
+                    }
+
+                    auto* item = buffer_[static_cast<std::size_t>(top) & mask_].load(std::memory_order_relaxed);
+                    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        return nullptr;
+                    }
+                    return item;
+                }
+
+                // Approximate when other threads are pushing or stealing
+                auto size() const -> std::size_t {
+                    auto bottom = bottom_.load(std::memory_order_relaxed);
+                    auto top    = top_.load(std::memory_order_relaxed);
+                    return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+                }
+
+            private:
+                alignas(64) std::atomic<std::int64_t> top_ = 0;
+                alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+                std::size_t mask_;
+                std::unique_ptr<std::atomic<T*>[]> buffer_;
+        };
+    } // namespace jobs
+} // namespace ENGINE_NS
@@ -0,0 +1,153 @@
+#pragma once
+#include "engine/jobs/deque.h"
+#include "engine/meta_defines.h"
+
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ENGINE_NS {
+    class JobSystem;
+
+    namespace jobs {
+        enum class Affinity : std::uint8_t {
+            // Any worker, or a thread helping out while it waits
+            ANY,
+            // Only the thread that created the JobSystem, inside run_main_thread_jobs or wait
+            MAIN_THREAD
+        };
+
+        struct Job;
+
+        /*
+            Counts unfinished jobs. Every job scheduled with a counter as its signal increments it and decrements it
+            once the job has run. Jobs can be made to wait for a counter to reach zero before they are queued.
+            A counter must outlive every job signalling it and must not be reused until it has reached zero
+        */
+        class Counter {
+            public:
+                Counter() = default;
+                ~Counter() {
+                    assert(done() && "Counter destroyed with jobs outstanding");
+                }
+                Counter(const Counter&)                    = delete;
+                auto operator=(const Counter&) -> Counter& = delete;
+
+                auto done() const -> bool {
+                    return pending_.load(std::memory_order_acquire) == 0;
+                }
+
+            private:
+                friend class ::ENGINE_NS::JobSystem;
+
+                // Held while the final job hands its continuations back to the scheduler
+                static constexpr std::uint32_t SETTLING = UINT32_MAX;
+
+                std::atomic<std::uint32_t> pending_ = 0;
+                std::mutex continuations_mutex_;
+                std::vector<Job*> continuations_;
+        };
+
+        struct Job {
+                std::function<void()> function;
+                Counter* signal   = nullptr;
+                Affinity affinity = Affinity::ANY;
+        };
+    } // namespace jobs
+
+    /*
+        Work-stealing job system shared across the engine
+
+        Each worker owns a deque it pushes new jobs onto and pops from; idle workers steal from the others. Threads that
+        are not workers (main, render, upload...) submit through a shared injection queue. Waiting on a counter never
+        just blocks: the waiting thread runs other jobs until the counter reaches zero, so jobs may freely schedule and
+        wait on sub-jobs. Workers with nothing to do park until new work is submitted.
+
+        Jobs are profiled as Tracy zones on named worker threads. Jobs run to completion on one thread; there are no
+        fibers, so a job which waits keeps its stack and thread until its counter finishes.
+    */
+    class JobSystem {
+        public:
+            // One worker per hardware thread, less the thread that creates the system
+            ENGINE_API JobSystem();
+            ENGINE_API explicit JobSystem(std::size_t worker_count);
+            ENGINE_API ~JobSystem();
+
+            JobSystem(const JobSystem&)                    = delete;
+            auto operator=(const JobSystem&) -> JobSystem& = delete;
+
+            ENGINE_API auto schedule(std::function<void()> function, jobs::Counter* signal = nullptr) -> void;
+            // Queue once dependency reaches zero
+            ENGINE_API auto schedule_after(const jobs::Counter& dependency,
+                                           std::function<void()> function,
+                                           jobs::Counter* signal   = nullptr,
+                                           jobs::Affinity affinity = jobs::Affinity::ANY) -> void;
+            // Run on the main thread the next time it calls run_main_thread_jobs or waits on a counter
+            ENGINE_API auto schedule_main(std::function<void()> function, jobs::Counter* signal = nullptr) -> void;
+
+            // Run every queued main thread job. Call once per frame from the main thread
+            ENGINE_API auto run_main_thread_jobs() -> void;
+
+            // Return once counter reaches zero, running other jobs in the meantime
+            ENGINE_API auto wait(jobs::Counter& counter) -> void;
+
+            // Split [begin, end) into chunks of at most grain and call func(first, last) on each in parallel
+            template <typename TFunc>
+            auto parallel_for(std::size_t begin, std::size_t end, std::size_t grain, TFunc&& func) -> void {
+                ZoneScoped;
+                if (begin >= end) {
+                    return;
+                }
+                grain        = std::max<std::size_t>(grain, 1);
+                auto counter = jobs::Counter();
+                for (auto first = begin; first < end; first += std::min(grain, end - first)) {
+                    auto last = first + std::min(grain, end - first);
+                    schedule([&func, first, last] { func(first, last); }, &counter);
+                }
+                wait(counter);
+            }
+
+            ENGINE_API auto worker_count() const -> std::size_t;
+
+        private:
+            static constexpr std::size_t DEQUE_CAPACITY = 4'096;
+
+            struct Worker {
+                    Worker() : deque(DEQUE_CAPACITY) {
+                    }
+
+                    jobs::WorkStealingDeque<jobs::Job> deque;
+                    std::thread thread;
+            };
+
+            std::vector<std::unique_ptr<Worker>> workers_;
+            std::thread::id main_thread_;
+
+            std::mutex injection_mutex_;
+            std::deque<jobs::Job*> injection_;
+
+            std::mutex main_mutex_;
+            std::vector<jobs::Job*> main_jobs_;
+
+            // Bumped whenever work is queued so parked workers can tell they missed something
+            std::atomic<std::uint32_t> work_epoch_ = 0;
+            std::atomic<std::uint32_t> sleeping_   = 0;
+            std::atomic<bool> running_             = true;
+
+            auto worker_loop_(Worker& worker, std::size_t index) -> void;
+            auto current_worker_() -> Worker*;
+
+            auto enqueue_(jobs::Job* job) -> void;
+            auto find_job_(Worker* worker, std::size_t& victim) -> jobs::Job*;
+            auto run_(jobs::Job* job) -> void;
+            auto signal_(jobs::Counter& counter) -> void;
+            auto wake_() -> void;
+    };
+} // namespace ENGINE_NS
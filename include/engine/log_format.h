@@ -0,0 +1,186 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+/*
+    Deferred log formatting
+
+    Log calls whose arguments are all plain values (numbers, bools, chars, strings) do not format on the calling thread.
+    Instead the arguments are encoded into a small fixed buffer next to a pointer to the format string, and the text is
+    produced later by the sink or, for binary logs, offline by tools/log_decoder. Format strings are referenced, not
+    copied, so they must be string literals (fmt::runtime strings are not supported by the logger)
+*/
+namespace ENGINE_NS {
+    namespace logger {
+        enum class ArgTag : std::uint8_t { BOOL, CHAR, I64, U64, F32, F64, STRING };
+
+        constexpr std::size_t DEFERRED_ARGS_CAPACITY = 128;
+
+        template <typename T>
+        concept StringArg = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> ||
+                            std::is_same_v<T, char*> || (std::is_array_v<T> && std::is_same_v<std::remove_extent_t<T>, char>);
+
+        // Wide and unicode characters cannot be formatted into a char buffer at all
+        template <typename T>
+        concept IntegerArg = std::is_integral_v<T> && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                             !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+        // Long double is left out since it would not survive the round trip through a double
+        template <typename T>
+        concept DeferrableArg = IntegerArg<T> || std::is_same_v<T, float> || std::is_same_v<T, double> || StringArg<T>;
+
+        // Tagged argument bytes. Never allocates; encoding fails once the capacity is used up
+        struct ArgBuffer {
+                std::array<std::byte, DEFERRED_ARGS_CAPACITY> bytes;
+                std::uint32_t size = 0;
+
+                auto write(const void* data, std::size_t count) -> bool {
+                    if (count > bytes.size() - size) {
+                        return false;
+                    }
+                    std::memcpy(bytes.data() + size, data, count);
+                    size += static_cast<std::uint32_t>(count);
+                    return true;
+                }
+
+                template <typename T>
+                auto write_tagged(ArgTag tag, T value) -> bool {
+                    return write(&tag, sizeof(tag)) && write(&value, sizeof(value));
+                }
+
+                auto view() const -> std::span<const std::byte> {
+                    return {bytes.data(), size};
+                }
+        };
+
+        template <typename T>
+        auto encode_arg(ArgBuffer& buffer, const T& value) -> bool {
+            using U = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<U, bool>) {
+                return buffer.write_tagged(ArgTag::BOOL, static_cast<std::uint8_t>(value));
+            } else if constexpr (std::is_same_v<U, char>) {
+                return buffer.write_tagged(ArgTag::CHAR, value);
+            } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                return buffer.write_tagged(ArgTag::I64, static_cast<std::int64_t>(value));
+            } else if constexpr (std::is_integral_v<U>) {
+                return buffer.write_tagged(ArgTag::U64, static_cast<std::uint64_t>(value));
+            } else if constexpr (std::is_same_v<U, float>) {
+                return buffer.write_tagged(ArgTag::F32, value);
+            } else if constexpr (std::is_same_v<U, double>) {
+                return buffer.write_tagged(ArgTag::F64, value);
+            } else {
+                static_assert(StringArg<U>, "Argument cannot be deferred");
+                auto text = std::string_view();
+                if constexpr (std::is_pointer_v<U>) {
+                    // A string_view of a null pointer is undefined, so null is written the way printf writes it
+                    text = value != nullptr ? std::string_view(value) : std::string_view("(null)");
+                } else {
+                    text = std::string_view(value);
+                }
+                return buffer.write_tagged(ArgTag::STRING, static_cast<std::uint32_t>(text.size())) && buffer.write(text.data(), text.size());
+            }
+        }
+
+        template <typename... T>
+        auto encode_args(ArgBuffer& buffer, const T&... args) -> bool {
+            return (encode_arg(buffer, args) && ...);
+        }
+
+        // Format encoded arguments with format, appending to out. False if the arguments or format string are malformed
+        ENGINE_API auto format_args(std::string_view format, std::span<const std::byte> args, fmt::memory_buffer& out) -> bool;
+
+        constexpr auto level_name(std::uint8_t level) -> std::string_view {
+            switch (level) {
+                case 1 << 3:
+                    return "DEBUG";
+                case 1 << 2:
+                    return "ERROR";
+                case 1 << 1:
+                    return "WARNING";
+                case 1 << 0:
+                    return "INFO";
+                default:
+                    return "UNKNOWN";
+            }
+        }
+
+        // The line layout shared by text streams and the binary log decoder
+        template <typename OutputIt>
+        auto format_line(OutputIt out, std::chrono::duration<double> time, std::string_view level, std::string_view owner, std::string_view message)
+            -> OutputIt {
+            auto hours        = static_cast<std::uint64_t>(std::floor(time.count() / 60 / 60));
+            auto minutes      = static_cast<std::uint64_t>(std::floor(time.count() / 60));
+            auto seconds      = static_cast<std::uint64_t>(std::floor(time.count()));
+            auto milliseconds = static_cast<std::uint64_t>(10'000.0 * (time.count() - std::floor(time.count())));
+            return fmt::format_to(out, "{:0>2}:{:0>2}:{:0>2}.{:0>4} [{}] ({}) {}", hours, minutes, seconds, milliseconds, level, owner, message);
+        }
+
+        /*
+            Binary log files
+
+            A header (magic, version, byte order mark) followed by records, each starting with a RecordType byte:
+                FORMAT  u32 id, u32 size, bytes           a format string, sent before its first use
+                OWNER   u32 id, u32 size, bytes           a logger identifier, sent before its first use
+                ENTRY   u64 index, u8 level, u32 owner, i64 nanoseconds since the logger started, u32 format,
+                        u32 size, argument bytes
+            Values are in the writer's byte order; the decoder refuses files written with another
+        */
+        namespace binary {
+            constexpr std::array<char, 8> MAGIC     = {'E', 'N', 'G', 'L', 'O', 'G', '\0', '\0'};
+            constexpr std::uint32_t VERSION         = 1;
+            constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+            // Used for entries that were formatted eagerly; their only argument is the message
+            constexpr std::string_view PLAIN_FORMAT = "{}";
+
+            enum class RecordType : std::uint8_t { FORMAT = 1, OWNER = 2, ENTRY = 3 };
+
+            class Writer {
+                public:
+                    ENGINE_API explicit Writer(std::FILE* file);
+
+                    ENGINE_API auto write(std::uint64_t index,
+                                          std::uint8_t level,
+                                          std::string_view owner,
+                                          std::chrono::nanoseconds time,
+                                          std::string_view format,
+                                          std::span<const std::byte> args) -> void;
+                    ENGINE_API auto flush() -> void;
+
+                private:
+                    struct StringHash {
+                            using is_transparent = void;
+                            auto operator()(std::string_view text) const -> std::size_t {
+                                return std::hash<std::string_view>{}(text);
+                            }
+                    };
+
+                    auto put_string_(RecordType type, std::uint32_t id, std::string_view text) -> void;
+                    auto put_(const void* data, std::size_t size) -> void;
+
+                    std::FILE* file_;
+                    // Format strings are literals, so their address identifies them
+                    std::unordered_map<const char*, std::uint32_t> formats_;
+                    std::unordered_map<std::string, std::uint32_t, StringHash, std::equal_to<>> owners_;
+            };
+
+            // Decode a binary log into text lines. Returns the number of entries written
+            ENGINE_API auto decode(std::FILE* input, std::FILE* output) -> std::expected<std::uint64_t, std::string>;
+        } // namespace binary
+    } // namespace logger
+} // namespace ENGINE_NS
@@ -1,19 +1,40 @@
 #pragma once
+#include "engine/log_format.h"
 #include "engine/meta_defines.h"
 
 #include <fmt/format.h>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
-#include <deque>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+// The most verbose level compiled into the program, as a logger::Level value. Calls to the more verbose helpers
+// (Logger::debug and friends) compile to nothing. Release builds drop debug logging unless told otherwise
+#ifndef ENGINE_LOG_MIN_LEVEL
+    #ifdef NDEBUG
+        #define ENGINE_LOG_MIN_LEVEL 4
+    #else
+        #define ENGINE_LOG_MIN_LEVEL 8
+    #endif
+#endif
+
 namespace ENGINE_NS {
+    class Logger;
+
     namespace logger {
         using Clock = std::chrono::steady_clock;
 
@@ -34,13 +55,284 @@ namespace ENGINE_NS {
 
         ENGINE_API auto level_to_string(Level level) -> std::string_view;
 
+        // Whether an entry at level gets past threshold. Inline so a filtered-out call costs a compare
+        constexpr auto passes(Level level, Level threshold) -> bool {
+            return static_cast<std::uint8_t>(level) <= static_cast<std::uint8_t>(threshold);
+        }
+        constexpr auto compiled_in(Level level) -> bool {
+            return static_cast<std::uint8_t>(level) <= ENGINE_LOG_MIN_LEVEL;
+        }
+
+        // Views into a logger's history; valid for as long as the HistoryView it came from
         struct Entry {
                 std::uint64_t index{};
                 Level level{};
-                std::string owner;
-                std::string message;
+                std::string_view owner;
+                std::string_view message;
                 std::chrono::duration<double> log_time_{};
         };
+
+        // Owner names are interned once per identifier and never freed, so views of them stay valid for the program
+        using OwnerId = std::uint32_t;
+        ENGINE_API auto intern_owner(std::string_view owner) -> OwnerId;
+        ENGINE_API auto owner_name(OwnerId owner) -> std::string_view;
+
+        /*
+            Fixed-capacity record of a logger's most recent entries
+
+            Entry metadata lives in a ring of slots and message text in a byte arena used as a ring, both allocated
+            once up front. Recording an entry evicts the oldest ones until there is a free slot and room for its text.
+            Messages longer than the arena are truncated
+        */
+        class History {
+            public:
+                struct Slot {
+                        std::uint64_t index{};
+                        std::chrono::duration<double> time{};
+                        std::uint32_t offset = 0;
+                        std::uint32_t size   = 0;
+                        Level level{};
+                };
+
+                ENGINE_API History(std::size_t entries, std::size_t bytes);
+
+                ENGINE_API auto push(std::uint64_t index, Level level, std::chrono::duration<double> time, std::string_view message) -> void;
+
+                // Entries are numbered by a sequence that keeps counting up as old entries are evicted
+                auto first() const -> std::uint64_t {
+                    return first_;
+                }
+                auto end() const -> std::uint64_t {
+                    return end_;
+                }
+                auto slot(std::uint64_t sequence) const -> const Slot& {
+                    return slots_[sequence % slot_capacity_];
+                }
+                auto message(const Slot& slot) const -> std::string_view {
+                    return {arena_.get() + slot.offset, slot.size};
+                }
+
+            private:
+                auto evict_() -> void;
+
+                std::unique_ptr<Slot[]> slots_;
+                std::size_t slot_capacity_;
+                std::unique_ptr<char[]> arena_;
+                std::size_t arena_capacity_;
+                std::size_t arena_head_ = 0;
+                std::uint64_t first_    = 0;
+                std::uint64_t end_      = 0;
+        };
+
+        /*
+            The last entries of a logger at or below a level, oldest first
+
+            Holds a shared lock on the logger's history, so the sink cannot record new entries into that logger until the
+            view is gone. Keep views short lived, and never flush the sink while holding one
+        */
+        class HistoryView {
+            public:
+                class Iterator {
+                    public:
+                        using iterator_category = std::forward_iterator_tag;
+                        using value_type        = Entry;
+                        using difference_type   = std::ptrdiff_t;
+
+                        Iterator() = default;
+                        Iterator(const HistoryView* view, std::uint64_t sequence) : view_(view), sequence_(sequence) {
+                        }
+
+                        auto operator*() const -> Entry {
+                            return view_->entry_(sequence_);
+                        }
+                        auto operator++() -> Iterator& {
+                            sequence_ = view_->next_(sequence_ + 1);
+                            return *this;
+                        }
+                        auto operator++(int) -> Iterator {
+                            auto previous = *this;
+                            ++*this;
+                            return previous;
+                        }
+                        auto operator==(const Iterator& rhs) const -> bool {
+                            return sequence_ == rhs.sequence_;
+                        }
+
+                        // Where the entry sits in its history; see HistoryView::at
+                        auto sequence() const -> std::uint64_t {
+                            return sequence_;
+                        }
+
+                    private:
+                        const HistoryView* view_ = nullptr;
+                        std::uint64_t sequence_  = 0;
+                };
+
+                // Every entry still held from sequence onwards
+                struct Since {
+                        std::uint64_t sequence = 0;
+                };
+
+                ENGINE_API HistoryView(std::shared_lock<std::shared_mutex>&& lock,
+                                       const History& history,
+                                       OwnerId owner,
+                                       std::uint64_t count,
+                                       Level filter);
+                ENGINE_API HistoryView(std::shared_lock<std::shared_mutex>&& lock, const History& history, OwnerId owner, Since since);
+
+                auto begin() const -> Iterator {
+                    return {this, first_};
+                }
+                auto end() const -> Iterator {
+                    return {this, end_};
+                }
+                auto size() const -> std::size_t {
+                    return size_;
+                }
+                auto empty() const -> bool {
+                    return size_ == 0;
+                }
+                auto front() const -> Entry {
+                    return entry_(first_);
+                }
+                auto back() const -> Entry {
+                    return entry_(last_);
+                }
+
+                // The entry at sequence, if the history still holds it
+                auto at(std::uint64_t sequence) const -> std::optional<Entry> {
+                    if (sequence < history_->first() || sequence >= history_->end()) {
+                        return std::nullopt;
+                    }
+                    return entry_(sequence);
+                }
+                // The sequence the next entry recorded will get
+                auto end_sequence() const -> std::uint64_t {
+                    return history_->end();
+                }
+
+            private:
+                ENGINE_API auto entry_(std::uint64_t sequence) const -> Entry;
+                ENGINE_API auto next_(std::uint64_t sequence) const -> std::uint64_t;
+
+                std::shared_lock<std::shared_mutex> lock_;
+                const History* history_;
+                std::string_view owner_;
+                Level filter_;
+                std::uint64_t first_ = 0;
+                std::uint64_t last_  = 0;
+                std::uint64_t end_   = 0;
+                std::size_t size_    = 0;
+        };
+
+        // What a logging call does when its thread's ring is full
+        enum class OverflowPolicy : std::uint8_t {
+            // Discard the entry. The sink reports how many were lost
+            DROP,
+            // Wait for the sink to make room
+            BLOCK
+        };
+
+        enum class RecordKind : std::uint8_t {
+            // message holds the formatted text
+            MESSAGE,
+            // format and args are kept for the sink to format
+            DEFERRED
+        };
+
+        // A log call captured on the calling thread, waiting for the sink to write it
+        struct Record {
+                std::uint64_t index{};
+                Level level{};
+                const Logger* logger = nullptr;
+                std::chrono::time_point<Clock> time{};
+                RecordKind kind = RecordKind::MESSAGE;
+                std::string message;
+                std::string_view format;
+                ArgBuffer args;
+        };
+
+        /*
+            Background writer shared by loggers
+
+            Each thread that logs gets its own single-producer ring, so a logging call is a copy of its arguments plus a
+            push with no locks or shared writes other than the global entry index. The sink thread drains every ring,
+            formats deferred records, writes the entries out in batches with one flush per stream per batch, and records
+            them in their logger's history.
+
+            Entries come out in index order, across batches too: while a thread is between taking an index and pushing
+            its record, records with later indices are held back for it. A flush or stop writes out whatever is held
+            back, so entries still in flight at that moment may come out of order
+        */
+        class Sink {
+            public:
+                // Records carry their arguments inline, so rings hold fewer of them than when they held a string
+                static constexpr std::size_t DEFAULT_RING_CAPACITY = 1'024;
+
+                ENGINE_API explicit Sink(OverflowPolicy policy = OverflowPolicy::BLOCK, std::size_t ring_capacity = DEFAULT_RING_CAPACITY);
+                ENGINE_API ~Sink();
+
+                Sink(const Sink&)                    = delete;
+                auto operator=(const Sink&) -> Sink& = delete;
+
+                // Gives record the next index and queues it
+                ENGINE_API auto submit(Record&& record) -> void;
+                // Block until everything submitted before the call has been written and flushed
+                ENGINE_API auto flush() -> void;
+                // Write out what is queued and stop the sink thread. Later records are written on the caller's thread
+                ENGINE_API auto stop() -> void;
+
+                ENGINE_API auto dropped() const -> std::uint64_t;
+
+                // Also write every entry from here on to file in the binary log format, leaving formatting to
+                // tools/log_decoder. Pass nullptr to stop. The caller keeps ownership of file
+                ENGINE_API auto write_binary_to(std::FILE* file) -> void;
+
+            private:
+                struct Ring;
+
+                auto ring_() -> Ring&;
+                auto run_() -> void;
+                // Writes what the rings hold and returns how many were written. With hold_back, records from the lowest
+                // index a thread is still submitting on stay in batch_ for a later drain
+                auto drain_(bool hold_back) -> std::size_t;
+                auto pending_() -> bool;
+                auto write_(const std::vector<Record*>& batch) -> void;
+                auto write_binary_(const Record& record, std::string_view owner) -> void;
+                auto wake_() -> void;
+
+                OverflowPolicy policy_;
+                std::size_t ring_capacity_;
+                // Tells a thread's cached ring apart from one belonging to a sink previously at the same address
+                std::uint64_t id_ = 0;
+
+                std::atomic<std::uint64_t> index_   = 0;
+                std::atomic<std::uint64_t> dropped_ = 0;
+                std::uint64_t reported_dropped_     = 0;
+
+                std::mutex rings_mutex_;
+                std::vector<std::shared_ptr<Ring>> rings_;
+
+                // Held while draining and writing, so a flush after stop() can do the sink's work itself
+                std::mutex write_mutex_;
+                // Only touched under write_mutex_; kept between drains so their storage is reused, and so batch_ can
+                // carry held back records over
+                std::vector<Record> batch_;
+                std::vector<Record*> order_;
+                std::unique_ptr<binary::Writer> binary_;
+                // Reused by the writer for deferred formatting and plain messages going to the binary log
+                fmt::memory_buffer message_buffer_;
+                std::vector<std::byte> binary_args_;
+
+                std::mutex poll_mutex_;
+                std::condition_variable poll_condition_;
+                std::atomic<std::uint32_t> wake_epoch_     = 0;
+                std::atomic<bool> sleeping_                = false;
+                std::atomic<bool> stopping_                = false;
+                std::atomic<std::uint64_t> flush_requests_ = 0;
+                std::atomic<std::uint64_t> flushed_        = 0;
+                std::thread thread_;
+        };
     } // namespace logger
 
     struct Stream {
@@ -48,66 +340,124 @@ namespace ENGINE_NS {
             logger::Level level{};
     };
 
+    /*
+        Logging is thread safe and many threads may log through a shared (read) guard at once. Messages whose
+        arguments are all plain values are formatted by the logger's sink; anything else is formatted on the calling
+        thread. Either way the sink writes them to the streams in the background
+    */
     class Logger {
         public:
             Logger(const Logger&) = delete;
             Logger(Logger&& rhs) noexcept :
-                m_log_idx(rhs.m_log_idx), start_time_(rhs.start_time_), m_streams(std::move(rhs.m_streams)),
-                m_entries(std::move(rhs.m_entries)), m_identifier(std::move(rhs.m_identifier)) {
+                m_sink(rhs.m_sink), start_time_(rhs.start_time_), m_streams(std::move(rhs.m_streams)),
+                m_level(rhs.m_level.load(std::memory_order_relaxed)), m_history(std::move(rhs.m_history)), m_owner(rhs.m_owner),
+                m_identifier(std::move(rhs.m_identifier)) {
             }
 
             template <typename... T>
-            auto debug(fmt::format_string<T...> fmt, T&&... args) -> void {
-                this->log(logger::Level::DEBUG, fmt, std::forward<T>(args)...);
+            auto debug(fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::DEBUG)) {
+                    this->log(logger::Level::DEBUG, fmt, std::forward<T>(args)...);
+                }
             }
 
             template <typename... T>
-            auto error(fmt::format_string<T...> fmt, T&&... args) -> void {
-                this->log(logger::Level::ERROR, fmt, std::forward<T>(args)...);
+            auto error(fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::ERROR)) {
+                    this->log(logger::Level::ERROR, fmt, std::forward<T>(args)...);
+                }
             }
 
             template <typename... T>
-            auto warning(fmt::format_string<T...> fmt, T&&... args) -> void {
-                this->log(logger::Level::WARNING, fmt, std::forward<T>(args)...);
+            auto warning(fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::WARNING)) {
+                    this->log(logger::Level::WARNING, fmt, std::forward<T>(args)...);
+                }
             }
 
             template <typename... T>
-            auto info(fmt::format_string<T...> fmt, T&&... args) -> void {
-                this->log(logger::Level::INFO, fmt, std::forward<T>(args)...);
+            auto info(fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr (logger::compiled_in(logger::Level::INFO)) {
+                    this->log(logger::Level::INFO, fmt, std::forward<T>(args)...);
+                }
             }
 
+            // The level check is kept apart from capturing the entry so it inlines into the caller
             template <typename... T>
-            auto log(logger::Level level, fmt::format_string<T...> fmt, T&&... args) -> void {
-                auto message = std::string{};
-                fmt::format_to(std::back_inserter(message), fmt, std::forward<T>(args)...);
-                this->append(level, std::move(message));
+            auto log(logger::Level level, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if (enabled(level)) {
+                    this->capture_(level, fmt, std::forward<T>(args)...);
+                }
             }
 
+            // Whether an entry at level would be kept. Starts at the most verbose level any stream accepts, or at
+            // everything for loggers that only keep history
+            auto enabled(logger::Level level) const -> bool {
+                return logger::passes(level, m_level.load(std::memory_order_relaxed));
+            }
+            auto set_level(logger::Level level) -> void {
+                m_level.store(level, std::memory_order_relaxed);
+            }
+
+            // Only the most recent entries are kept; see LoggerBuilder::with_history
+            ENGINE_API [[nodiscard]]
+            auto last_entries(uint64_t count) const -> logger::HistoryView;
             ENGINE_API [[nodiscard]]
-            auto last_entries(uint64_t count) const -> std::vector<const logger::Entry*>;
+            auto last_entries_of(uint64_t count, logger::Level filter) const -> logger::HistoryView;
+            // Entries recorded since a sequence taken from an earlier view, for consumers that follow the log
             ENGINE_API [[nodiscard]]
-            auto last_entries_of(uint64_t count, logger::Level filter) const -> std::vector<const logger::Entry*>;
+            auto entries_since(uint64_t sequence) const -> logger::HistoryView;
 
             friend auto swap(Logger& a, Logger& b) noexcept -> void {
-                std::swap(a.m_log_idx, b.m_log_idx);
+                std::swap(a.m_sink, b.m_sink);
                 std::swap(a.start_time_, b.start_time_);
                 std::swap(a.m_streams, b.m_streams);
-                std::swap(a.m_entries, b.m_entries);
+                auto level = a.m_level.load(std::memory_order_relaxed);
+                a.m_level.store(b.m_level.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                b.m_level.store(level, std::memory_order_relaxed);
+                std::swap(a.m_history, b.m_history);
+                std::swap(a.m_owner, b.m_owner);
                 std::swap(a.m_identifier, b.m_identifier);
             }
 
             const std::string& identifier = m_identifier;
 
             friend class LoggerBuilder;
+            friend class logger::Sink;
 
         private:
-            Logger(std::string_view identifier, std::vector<Stream>&& streams, std::uint64_t& idx);
-            auto append(logger::Level level, std::string&& message) -> void;
+            Logger(std::string_view identifier, std::vector<Stream>&& streams, logger::Sink& sink, logger::History&& history);
 
-            uint64_t& m_log_idx;
+            template <typename... T>
+            auto capture_(logger::Level level, fmt::format_string<T...> fmt, T&&... args) const -> void {
+                if constexpr ((logger::DeferrableArg<std::remove_cvref_t<T>> && ...)) {
+                    auto record   = logger::Record{};
+                    record.kind   = logger::RecordKind::DEFERRED;
+                    auto format   = fmt::string_view(fmt);
+                    record.format = std::string_view(format.data(), format.size());
+                    // Arguments too large for the record are formatted here instead
+                    if (logger::encode_args(record.args, args...)) {
+                        this->append(level, std::move(record));
+                        return;
+                    }
+                }
+                auto message = std::string{};
+                fmt::format_to(std::back_inserter(message), fmt, std::forward<T>(args)...);
+                this->append(level, std::move(message));
+            }
+
+            ENGINE_API auto append(logger::Level level, std::string&& message) const -> void;
+            ENGINE_API auto append(logger::Level level, logger::Record&& record) const -> void;
+
+            // Shared by every logger so entries from different loggers can be put back in order
+            logger::Sink* m_sink;
             std::chrono::time_point<logger::Clock> start_time_;
             std::vector<Stream> m_streams;
-            std::deque<logger::Entry> m_entries;
+            std::atomic<logger::Level> m_level;
+            // Guards m_history, which the sink records into as it writes
+            mutable std::shared_mutex m_mutex;
+            mutable logger::History m_history;
+            logger::OwnerId m_owner;
             std::string m_identifier;
     };
 
@@ -117,11 +467,18 @@ namespace ENGINE_NS {
 
             ENGINE_API auto with_identifier(std::string&& identifier) -> LoggerBuilder&;
             ENGINE_API auto with_stream(Stream stream) -> LoggerBuilder&;
-            ENGINE_API auto build(std::uint64_t& idx) -> Logger;
+            // How many entries, and how many bytes of message text, the logger keeps for last_entries
+            ENGINE_API auto with_history(std::size_t entries, std::size_t bytes) -> LoggerBuilder&;
+            ENGINE_API auto build(logger::Sink& sink) -> Logger;
+
+            static constexpr std::size_t DEFAULT_HISTORY_ENTRIES = 4'096;
+            static constexpr std::size_t DEFAULT_HISTORY_BYTES   = 256 * 1'024;
 
         private:
             std::string m_identifier;
             std::vector<Stream> m_streams;
+            std::size_t m_history_entries = DEFAULT_HISTORY_ENTRIES;
+            std::size_t m_history_bytes   = DEFAULT_HISTORY_BYTES;
     };
 } // namespace ENGINE_NS
 
@@ -53,4 +53,14 @@ namespace StaticNames {
     static constexpr const char* DeleteRegisteredPipelines  = "Delete Registered Pipelines";
     static constexpr const char* PopGameStates              = "Pop Game Stats";
     static constexpr const char* PushGameStates             = "Push Game Stats";
+    static constexpr const char* JobWorkerThreadName        = "Job Worker";
+    static constexpr const char* RunJob                     = "Job";
+    static constexpr const char* MeshUploadQueueDepth       = "Mesh upload queue";
+    static constexpr const char* TextureUploadQueueDepth    = "Texture upload queue";
+    static constexpr const char* ProcessCpuUsage            = "CPU usage (% of one core)";
+    static constexpr const char* LogSinkThreadName          = "Log Sink";
+    static constexpr const char* FileReaderThreadName       = "File Reader";
+    static constexpr const char* FileReadsInFlight          = "File reads in flight";
+    static constexpr const char* FileWatcherThreadName      = "File Watcher";
+    static constexpr const char* StreamReaderThreadName     = "Stream Reader";
 } // namespace StaticNames
@@ -0,0 +1,107 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace ENGINE_NS {
+    /*
+        Bounded lock-free multi-producer single-consumer queue
+
+        Each cell carries a sequence number telling producers and the consumer whose turn it is, so producers only
+        contend on a single fetch of the tail and never wait on the consumer while there is room. The consumer owns the
+        head outright. Capacity is rounded up to a power of two
+    */
+    template <typename T>
+    class MpscQueue {
+        public:
+            explicit MpscQueue(std::size_t capacity) :
+                mask_(std::bit_ceil(capacity) - 1), cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+                assert(capacity > 0 && "Queue must hold at least one element");
+                for (std::size_t i = 0; i <= mask_; i++) {
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+            ~MpscQueue() {
+                while (try_pop()) {
+                }
+            }
+
+            MpscQueue(const MpscQueue&)                    = delete;
+            auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+
+            // Returns false, leaving value untouched, when the queue is full
+            auto try_push(T&& value) -> bool {
+                auto tail = tail_.load(std::memory_order_relaxed);
+                while (true) {
+                    auto& cell    = cells_[tail & mask_];
+                    auto sequence = cell.sequence.load(std::memory_order_acquire);
+                    auto diff     = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+                    if (diff == 0) {
+                        if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                            ::new (static_cast<void*>(cell.storage)) T(std::move(value));
+                            cell.sequence.store(tail + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        tail = tail_.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            // Yields until there is room. Only waits on the consumer draining the queue, never on a lock
+            auto push(T&& value) -> void {
+                while (!try_push(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+
+            // Consumer only
+            auto try_pop() -> std::optional<T> {
+                auto head     = head_.load(std::memory_order_relaxed);
+                auto& cell    = cells_[head & mask_];
+                auto sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence != head + 1) {
+                    return std::nullopt;
+                }
+                auto* item  = std::launder(reinterpret_cast<T*>(cell.storage));
+                auto result = std::optional<T>(std::move(*item));
+                item->~T();
+                cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+                head_.store(head + 1, std::memory_order_relaxed);
+                return result;
+            }
+
+            // Approximate while producers are pushing
+            auto size() const -> std::size_t {
+                auto tail = tail_.load(std::memory_order_relaxed);
+                auto head = head_.load(std::memory_order_relaxed);
+                return tail > head ? tail - head : 0;
+            }
+            auto capacity() const -> std::size_t {
+                return mask_ + 1;
+            }
+
+        private:
+            struct Cell {
+                    std::atomic<std::size_t> sequence;
+                    alignas(T) std::byte storage[sizeof(T)];
+            };
+
+            alignas(64) std::atomic<std::size_t> tail_ = 0;
+            // Only written by the consumer; atomic so size() can be read from anywhere
+            alignas(64) std::atomic<std::size_t> head_ = 0;
+            std::size_t mask_;
+            std::unique_ptr<Cell[]> cells_;
+    };
+} // namespace ENGINE_NS
@@ -5,6 +5,7 @@
 
 #include <robin_map.h>
 
+#include <cassert>
 #include <iterator>
 #include <optional>
 #include <utility>
@@ -15,6 +16,9 @@ namespace ENGINE_NS {
     class Pool;
 
     namespace pool {
+        template <typename T>
+        class Pinned;
+
         template <typename T>
         class Borrow {
             public:
@@ -35,6 +39,11 @@ namespace ENGINE_NS {
                     return this->m_owner->get(*this);
                 }
 
+                // Resolve the handle once so a scope can dereference without further lookups
+                auto pin() -> std::optional<Pinned<T>> {
+                    return this->m_owner->pin(*this);
+                }
+
                 auto index() -> Index {
                     return this->m_owner->index_of(*this);
                 }
@@ -86,6 +95,50 @@ namespace ENGINE_NS {
                 template <typename, size_t, size_t>
                 friend class ENGINE_NS::Pool;
         };
+
+        /*
+            A raw pointer to a pooled object, resolved once from a Borrow.
+
+            A Pinned is only valid until the pool grows or the object is freed. Debug builds remember the pool's
+            growth epoch and the handle, and assert on every dereference that neither has changed. Release builds
+            store nothing but the pointer.
+        */
+        template <typename T>
+        class Pinned {
+            public:
+                auto operator->() const -> T* {
+                    return this->get();
+                }
+                auto operator*() const -> T& {
+                    return *this->get();
+                }
+                auto get() const -> T* {
+#ifndef NDEBUG
+                    assert(m_owner->is_pin_valid_(m_handle, m_ptr, m_epoch));
+#endif
+                    return m_ptr;
+                }
+
+            private:
+#ifndef NDEBUG
+                Pinned(T* ptr, Pool<T>& pool, Handle handle, size_t epoch) :
+                    m_ptr(ptr), m_owner(&pool), m_handle(handle), m_epoch(epoch) {
+                }
+
+                T* m_ptr;
+                Pool<T>* m_owner;
+                Handle m_handle;
+                size_t m_epoch;
+#else
+                explicit Pinned(T* ptr) : m_ptr(ptr) {
+                }
+
+                T* m_ptr;
+#endif
+
+                template <typename, size_t, size_t>
+                friend class ENGINE_NS::Pool;
+        };
     } // namespace pool
 
     template <typename T, size_t DefaultCount, size_t GrowthFactor>
@@ -154,6 +207,10 @@ namespace ENGINE_NS {
                 }
                 m_region.reserve(count);
                 m_handles.reserve(count);
+#ifndef NDEBUG
+                // Growing may move every object, invalidating all outstanding pins
+                m_epoch += 1;
+#endif
             }
 
             auto allocate(T&& object) -> pool::Borrow<T> {
@@ -241,6 +298,18 @@ namespace ENGINE_NS {
                 return (*this)[index];
             }
 
+            auto pin(pool::Borrow<T> object) -> std::optional<pool::Pinned<T>> {
+                auto ptr = this->get(object);
+                if (!ptr) {
+                    return std::nullopt;
+                }
+#ifndef NDEBUG
+                return pool::Pinned<T>(*ptr, *this, object.handle, m_epoch);
+#else
+                return pool::Pinned<T>(*ptr);
+#endif
+            }
+
             auto operator[](Index idx) const -> std::optional<const T*> {
                 if (idx == Index::gravestone()) {
                     return std::nullopt;
@@ -268,6 +337,19 @@ namespace ENGINE_NS {
 
             size_t m_size = 0;
             Handle m_current_handle{};
+
+#ifndef NDEBUG
+            size_t m_epoch = 0;
+
+            auto is_pin_valid_(Handle handle, const T* ptr, size_t epoch) const -> bool {
+                if (epoch != m_epoch || !m_handles.contains(handle)) {
+                    return false;
+                }
+                return (*this)[m_handles.at(handle)] == ptr;
+            }
+
+            friend class pool::Pinned<T>;
+#endif
     };
 } // namespace ENGINE_NS
 
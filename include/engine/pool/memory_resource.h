@@ -0,0 +1,166 @@
+#pragma once
+#include "engine/meta_defines.h"
+#include "engine/pool/region.h"
+#include "engine/pool/types.h"
+
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+
+namespace ENGINE_NS {
+    namespace pool {
+        struct ResourceStatistics {
+                // Total calls to allocate/deallocate, including those forwarded upstream
+                std::size_t allocations   = 0;
+                std::size_t deallocations = 0;
+
+                // Calls which could not be served by a node and went to the upstream resource
+                std::size_t upstream_allocations   = 0;
+                std::size_t upstream_deallocations = 0;
+
+                // Bytes requested by callers which are currently outstanding
+                std::size_t bytes_in_use      = 0;
+                std::size_t peak_bytes_in_use = 0;
+
+                // Bytes of node storage held by the resource, used or not
+                std::size_t bytes_reserved = 0;
+        };
+
+        template <std::size_t Size, std::size_t Alignment>
+        struct alignas(Alignment) Node {
+                // User-provided so that emplacing a node does not zero it
+                Node() {
+                }
+                std::byte storage[Size];
+        };
+
+        /*
+            A std::pmr::memory_resource which hands out fixed-size nodes from a chain of Regions.
+
+            Requests which fit in a node are served from the first Region with a free slot. When every Region is full
+            a new one is appended, each GrowthFactor times larger than the last, the same way Pool grows. Regions are
+            never reallocated since that would move live nodes; instead they are chained.
+
+            Requests larger than a node, or with a stricter alignment, are forwarded to the upstream resource.
+
+            Like std::pmr::unsynchronized_pool_resource, this is not thread-safe.
+        */
+        template <std::size_t NodeSize,
+                  std::size_t NodeAlignment = alignof(std::max_align_t),
+                  std::size_t DefaultCount  = 512,
+                  std::size_t GrowthFactor  = 2>
+        class NodeResource : public std::pmr::memory_resource {
+            public:
+                using NodeType = Node<NodeSize, NodeAlignment>;
+
+                NodeResource() : NodeResource(std::pmr::get_default_resource()) {
+                }
+                explicit NodeResource(std::pmr::memory_resource* upstream) : m_upstream(upstream) {
+                }
+
+                NodeResource(const NodeResource&)                    = delete;
+                auto operator=(const NodeResource&) -> NodeResource& = delete;
+
+                auto upstream_resource() const -> std::pmr::memory_resource* {
+                    return m_upstream;
+                }
+
+                auto statistics() const -> const ResourceStatistics& {
+                    return m_statistics;
+                }
+
+                auto capacity() const -> std::size_t {
+                    std::size_t capacity = 0;
+                    for (const auto& region : m_regions) {
+                        capacity += region.capacity();
+                    }
+                    return capacity;
+                }
+
+                static constexpr auto node_size() -> std::size_t {
+                    return NodeSize;
+                }
+                static constexpr auto node_alignment() -> std::size_t {
+                    return NodeAlignment;
+                }
+
+            protected:
+                auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+                    ZoneScoped;
+                    m_statistics.allocations += 1;
+                    if (!fits_(bytes, alignment)) {
+                        m_statistics.upstream_allocations += 1;
+                        return m_upstream->allocate(bytes, alignment);
+                    }
+
+                    auto& region = region_with_space_();
+                    auto* node   = region.emplace(region.get_free_index());
+                    assert(node != nullptr);
+
+                    m_statistics.bytes_in_use += bytes;
+                    m_statistics.peak_bytes_in_use = std::max(m_statistics.peak_bytes_in_use, m_statistics.bytes_in_use);
+                    return static_cast<void*>(node->storage);
+                }
+
+                auto do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) -> void override {
+                    ZoneScoped;
+                    m_statistics.deallocations += 1;
+                    if (!fits_(bytes, alignment)) {
+                        m_statistics.upstream_deallocations += 1;
+                        m_upstream->deallocate(ptr, bytes, alignment);
+                        return;
+                    }
+
+                    for (auto& region : m_regions) {
+                        auto idx = region.index_of(ptr);
+                        if (idx == Index::gravestone()) {
+                            continue;
+                        }
+                        region.free(idx);
+                        m_statistics.bytes_in_use -= bytes;
+                        return;
+                    }
+                    // Pointer did not come from this resource
+                    assert(false);
+                }
+
+                auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+                    return this == &other;
+                }
+
+            private:
+                std::pmr::memory_resource* m_upstream = nullptr;
+
+                // Deque so that appending a Region never moves the existing ones
+                std::deque<Region<NodeType>> m_regions;
+
+                ResourceStatistics m_statistics{};
+
+                static constexpr auto fits_(std::size_t bytes, std::size_t alignment) -> bool {
+                    return bytes <= NodeSize && alignment <= NodeAlignment;
+                }
+
+                auto region_with_space_() -> Region<NodeType>& {
+                    // Newer regions are larger, so they are the most likely to have space
+                    for (auto it = m_regions.rbegin(); it != m_regions.rend(); ++it) {
+                        if (it->get_free_index() != Index::gravestone()) {
+                            return *it;
+                        }
+                    }
+
+                    auto count = m_regions.empty() ? DefaultCount : m_regions.back().capacity() * GrowthFactor;
+                    m_regions.emplace_back(count);
+                    m_statistics.bytes_reserved += count * sizeof(NodeType);
+                    return m_regions.back();
+                }
+        };
+
+        // A node resource sized to hold exactly one T per node
+        template <typename T, std::size_t DefaultCount = 512, std::size_t GrowthFactor = 2>
+        using PoolResource = NodeResource<sizeof(T), alignof(T), DefaultCount, GrowthFactor>;
+    } // namespace pool
+} // namespace ENGINE_NS
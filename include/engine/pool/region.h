@@ -230,11 +230,16 @@ namespace ENGINE_NS {
                         m_free_list.erase(idx + ForwardJump(1));
                         right->state = AllocationState::FREE;
 
-                        auto last_free             = right + static_cast<size_t>(right->jump.last_free);
-                        last_free->jump.first_free = last_free->jump.first_free + left->jump.first_free + BackwardJump(1);
+                        // Read both jumps up front: when a run is a single element its first and last share the same union
+                        auto right_last_free = right->jump.last_free;
+                        auto left_first_free = left->jump.first_free;
 
-                        auto first_free            = left - static_cast<size_t>(left->jump.first_free);
-                        first_free->jump.last_free = first_free->jump.last_free + right->jump.last_free + ForwardJump(1);
+                        // The left run, this element and the right run merge; left is two elements behind right
+                        auto last_free             = right + static_cast<size_t>(right_last_free);
+                        last_free->jump.first_free = last_free->jump.first_free + left_first_free + BackwardJump(2);
+
+                        auto first_free            = left - static_cast<size_t>(left_first_free);
+                        first_free->jump.last_free = first_free->jump.last_free + right_last_free + ForwardJump(2);
                     } else if (right->state == AllocationState::GRAVESTONE || right->state == AllocationState::IN_USE) {
                         auto first_free            = left - static_cast<size_t>(left->jump.first_free);
                         first_free->jump.last_free = first_free->jump.last_free + ForwardJump(1);
@@ -0,0 +1,61 @@
+#pragma once
+#include "engine/meta_defines.h"
+
+#include <tracy/Tracy.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace ENGINE_NS {
+    /*
+        Read-copy-update container for read-mostly data
+
+        Readers take an immutable snapshot of the current version and never wait on a writer. Writers copy the current
+        version, modify the copy and publish it; writers are serialised among themselves. A version is destroyed once
+        the last snapshot of it is released, so a reader that holds on to a snapshot (e.g. for as long as a frame is in
+        flight) decides when the data it saw can be reclaimed
+    */
+    template <typename T>
+    class Rcu {
+        public:
+            using Snapshot = std::shared_ptr<const T>;
+
+            Rcu()
+                requires std::is_default_constructible_v<T>
+                : current_(std::make_shared<const T>()) {
+            }
+            explicit Rcu(T&& initial) : current_(std::make_shared<const T>(std::move(initial))) {
+            }
+
+            Rcu(const Rcu&)                    = delete;
+            auto operator=(const Rcu&) -> Rcu& = delete;
+
+            auto read() const -> Snapshot {
+                return current_.load(std::memory_order_acquire);
+            }
+
+            // Publish func(copy of the current version) as the new version
+            template <typename TFunc>
+            auto update(TFunc&& func) -> void
+                requires std::is_copy_constructible_v<T>
+            {
+                ZoneScoped;
+                std::scoped_lock lock(writer_mutex_);
+                auto next = std::make_shared<T>(*current_.load(std::memory_order_relaxed));
+                std::forward<TFunc>(func)(*next);
+                current_.store(std::move(next), std::memory_order_release);
+            }
+
+            // Replace the current version outright
+            auto publish(T&& value) -> void {
+                std::scoped_lock lock(writer_mutex_);
+                current_.store(std::make_shared<const T>(std::move(value)), std::memory_order_release);
+            }
+
+        private:
+            std::atomic<Snapshot> current_;
+            TracyLockable(std::mutex, writer_mutex_);
+    };
+} // namespace ENGINE_NS
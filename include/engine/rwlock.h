@@ -4,9 +4,133 @@
 #include <tracy/Tracy.hpp>
 #include <atomic>
 #include <cstdint>
+#include <string_view>
 #include <utility>
 
 namespace ENGINE_NS {
+    namespace rwlock {
+#ifdef TRACY_ENABLE
+        using Profiler = tracy::SharedLockableCtx;
+#else
+        // Stands in for tracy::SharedLockableCtx so the lock hooks compile away when profiling is off
+        struct Profiler {
+                explicit Profiler(const void*) {
+                }
+                auto BeforeLock() -> bool {
+                    return false;
+                }
+                auto AfterLock() -> void {
+                }
+                auto AfterUnlock() -> void {
+                }
+                auto AfterTryLock(bool) -> void {
+                }
+                auto BeforeLockShared() -> bool {
+                    return false;
+                }
+                auto AfterLockShared() -> void {
+                }
+                auto AfterUnlockShared() -> void {
+                }
+                auto AfterTryLockShared(bool) -> void {
+                }
+        };
+#endif
+    } // namespace rwlock
+
+    /*
+        Reader-writer mutex with writer preference. Satisfies SharedMutex so it works with std::unique_lock/std::shared_lock
+
+        The whole state is a single 32 bit word:
+            bits  0-14  readers holding the lock
+            bit   15    at least one reader is parked waiting for a writer to leave
+            bits 16-30  writers waiting for the lock
+            bit   31    a writer holds the lock
+        Once a writer is waiting no new readers are admitted, so a steady stream of readers cannot starve writers.
+        Contended acquisitions spin with a backoff for a short while and then park on the word with std::atomic::wait.
+        Every acquire and release is reported to Tracy as a shared lock when profiling is enabled
+    */
+    class RwMutex {
+        public:
+            ENGINE_API RwMutex();
+            RwMutex(const RwMutex&)                    = delete;
+            auto operator=(const RwMutex&) -> RwMutex& = delete;
+
+            auto lock() -> void {
+                auto profiled = profiler_.BeforeLock();
+                auto expected = std::uint32_t{0};
+                if (!state_.compare_exchange_strong(expected, WRITER, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    lock_slow_();
+                }
+                if (profiled) {
+                    profiler_.AfterLock();
+                }
+            }
+            auto try_lock() -> bool {
+                auto state    = state_.load(std::memory_order_relaxed);
+                auto acquired = (state & (WRITER | READER_MASK)) == 0 &&
+                                state_.compare_exchange_strong(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+                profiler_.AfterTryLock(acquired);
+                return acquired;
+            }
+            auto unlock() -> void {
+                auto previous = state_.fetch_and(~(WRITER | READERS_PARKED), std::memory_order_release);
+                if ((previous & (READERS_PARKED | WAITING_WRITER_MASK)) != 0) {
+                    state_.notify_all();
+                }
+                profiler_.AfterUnlock();
+            }
+
+            auto lock_shared() -> void {
+                auto profiled = profiler_.BeforeLockShared();
+                auto state    = state_.load(std::memory_order_relaxed);
+                if ((state & (WRITER | WAITING_WRITER_MASK)) != 0 ||
+                    !state_.compare_exchange_strong(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    lock_shared_slow_();
+                }
+                if (profiled) {
+                    profiler_.AfterLockShared();
+                }
+            }
+            auto try_lock_shared() -> bool {
+                auto state    = state_.load(std::memory_order_relaxed);
+                auto acquired = (state & (WRITER | WAITING_WRITER_MASK)) == 0 &&
+                                state_.compare_exchange_strong(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed);
+                profiler_.AfterTryLockShared(acquired);
+                return acquired;
+            }
+            auto unlock_shared() -> void {
+                auto previous = state_.fetch_sub(1, std::memory_order_release);
+                if ((previous & READER_MASK) == 1 && (previous & WAITING_WRITER_MASK) != 0) {
+                    state_.notify_all();
+                }
+                profiler_.AfterUnlockShared();
+            }
+
+            // Take another shared hold on behalf of a thread which already has one. Never waits, so duplicating a read
+            // guard cannot deadlock against a writer queued behind the original hold
+            ENGINE_API auto add_shared() -> void;
+
+            // Label the lock in the profiler
+            ENGINE_API auto set_name(std::string_view name) -> void;
+
+            // Forget every holder and wake all waiters. Only for tearing down after a crash
+            ENGINE_API auto unsafe_reset() -> void;
+
+        private:
+            static constexpr std::uint32_t READER_MASK         = 0x0000'7fff;
+            static constexpr std::uint32_t READERS_PARKED      = 0x0000'8000;
+            static constexpr std::uint32_t WAITING_WRITER      = 0x0001'0000;
+            static constexpr std::uint32_t WAITING_WRITER_MASK = 0x7fff'0000;
+            static constexpr std::uint32_t WRITER              = 0x8000'0000;
+
+            std::atomic<std::uint32_t> state_ = 0;
+            rwlock::Profiler profiler_;
+
+            ENGINE_API auto lock_slow_() -> void;
+            ENGINE_API auto lock_shared_slow_() -> void;
+    };
+
     template <typename T>
     class RwDataMut {
         public:
@@ -23,25 +147,20 @@ namespace ENGINE_NS {
             }
 
             auto drop() -> void {
-                if (moved_) {
-                    return;
-                }
-                if (!dropped_) {
-                    lock_->store(false, std::memory_order_release);
+                if (mutex_ != nullptr) {
+                    mutex_->unlock();
                 }
-                dropped_ = true;
+                mutex_ = nullptr;
             }
 
-            RwDataMut(RwDataMut<T>&& rhs) noexcept : lock_(rhs.lock_), wrapped_(std::move(rhs.wrapped_)), dropped_(rhs.dropped_) {
-                rhs.moved_ = true;
+            RwDataMut(RwDataMut<T>&& rhs) noexcept : mutex_(std::exchange(rhs.mutex_, nullptr)), wrapped_(rhs.wrapped_) {
             }
 
             auto operator=(RwDataMut<T>&& rhs) noexcept -> RwDataMut<T>& {
                 if (&rhs != this) {
-                    lock_      = rhs.lock_;
-                    wrapped_   = std::move(rhs.wrapped_);
-                    dropped_   = rhs.dropped_;
-                    rhs.moved_ = true;
+                    drop();
+                    mutex_   = std::exchange(rhs.mutex_, nullptr);
+                    wrapped_ = rhs.wrapped_;
                 }
                 return *this;
             }
@@ -49,13 +168,12 @@ namespace ENGINE_NS {
         private:
             template <typename TLock>
             friend class RwLock;
-            explicit RwDataMut(std::atomic<bool>& lock, T& wrapped) : lock_(&lock), wrapped_(&wrapped) {
+            explicit RwDataMut(RwMutex& mutex, T& wrapped) : mutex_(&mutex), wrapped_(&wrapped) {
             }
 
-            std::atomic<bool>* lock_ = nullptr;
-            T* wrapped_              = nullptr;
-            bool dropped_            = false;
-            bool moved_              = false;
+            // Null once dropped or moved from
+            RwMutex* mutex_ = nullptr;
+            T* wrapped_     = nullptr;
     };
 
     template <typename T>
@@ -71,43 +189,36 @@ namespace ENGINE_NS {
             }
 
             auto drop() -> void {
-                if (moved_) {
-                    return;
-                }
-                if (!dropped_) {
-                    currently_reading_->fetch_sub(1, std::memory_order_release);
+                if (mutex_ != nullptr) {
+                    mutex_->unlock_shared();
                 }
-                dropped_ = true;
+                mutex_ = nullptr;
             }
 
-            RwData(const RwData<T>& rhs) : currently_reading_(rhs.currently_reading_), wrapped_(rhs.wrapped_), dropped_(false) {
-                if (!dropped_) {
-                    currently_reading_->fetch_add(1, std::memory_order_acquire);
+            RwData(const RwData<T>& rhs) : mutex_(rhs.mutex_), wrapped_(rhs.wrapped_) {
+                if (mutex_ != nullptr) {
+                    mutex_->add_shared();
                 }
             }
-            RwData(RwData<T>&& rhs) noexcept :
-                currently_reading_(rhs.currently_reading_), wrapped_(std::move(rhs.wrapped_)), dropped_(rhs.dropped_) {
-                rhs.moved_ = true;
+            RwData(RwData<T>&& rhs) noexcept : mutex_(std::exchange(rhs.mutex_, nullptr)), wrapped_(rhs.wrapped_) {
             }
 
             auto operator=(const RwData<T>& rhs) -> RwData<T>& {
                 if (&rhs != this) {
-                    currently_reading_ = rhs.currently_reading_;
-                    wrapped_           = rhs.wrapped_;
-                    dropped_           = rhs.dropped_;
-
-                    if (!dropped_) {
-                        currently_reading_->fetch_add(1, std::memory_order_acquire);
+                    if (rhs.mutex_ != nullptr) {
+                        rhs.mutex_->add_shared();
                     }
+                    drop();
+                    mutex_   = rhs.mutex_;
+                    wrapped_ = rhs.wrapped_;
                 }
                 return *this;
             }
             auto operator=(RwData<T>&& rhs) noexcept -> RwData<T>& {
                 if (&rhs != this) {
-                    currently_reading_ = rhs.currently_reading_;
-                    wrapped_           = std::move(rhs.wrapped_);
-                    dropped_           = rhs.dropped_;
-                    rhs.moved_         = true;
+                    drop();
+                    mutex_   = std::exchange(rhs.mutex_, nullptr);
+                    wrapped_ = rhs.wrapped_;
                 }
                 return *this;
             }
@@ -115,15 +226,12 @@ namespace ENGINE_NS {
         private:
             template <typename TLock>
             friend class RwLock;
-            explicit RwData(std::atomic<std::uint64_t>& currently_reading, const T& wrapped) :
-                currently_reading_(&currently_reading), wrapped_(&wrapped) {
-                currently_reading_->fetch_add(1, std::memory_order_release);
+            explicit RwData(RwMutex& mutex, const T& wrapped) : mutex_(&mutex), wrapped_(&wrapped) {
             }
 
-            std::atomic<std::uint64_t>* currently_reading_ = nullptr;
-            const T* wrapped_                              = nullptr;
-            bool dropped_                                  = false;
-            bool moved_                                    = false;
+            // Null once dropped or moved from
+            RwMutex* mutex_   = nullptr;
+            const T* wrapped_ = nullptr;
     };
 
     template <typename T>
@@ -154,12 +262,10 @@ namespace ENGINE_NS {
                 : wrapped_(std::move(contained)) {
             }
 
+            // Only the data moves; locks are never held across a move so the new lock starts open
             RwLock(RwLock<T>&& rhs) noexcept
                 requires std::is_move_constructible_v<T>
                 : wrapped_(std::move(rhs.wrapped_)) {
-                currently_reading_.store(rhs.currently_reading_.load(std::memory_order::acquire), std::memory_order::release);
-                currently_writing_.store(rhs.currently_writing_.load(std::memory_order::acquire), std::memory_order::release);
-                rhs.moved_ = true;
             }
 
 
@@ -177,51 +283,36 @@ namespace ENGINE_NS {
             {
                 if (&rhs != this) {
                     wrapped_ = std::move(rhs.wrapped_);
-                    currently_reading_.store(rhs.currently_reading_.load(std::memory_order::acquire), std::memory_order::release);
-                    currently_writing_.store(rhs.currently_writing_.load(std::memory_order::acquire), std::memory_order::release);
-                    rhs.moved_ = true;
                 }
                 return *this;
             }
 
             auto read() const -> RwData<T> {
-                ZoneScoped;
-                while (currently_writing_.load(std::memory_order_acquire)) {
-                    // spin
-                }
-                return RwData<T>(const_cast<std::atomic<std::uint64_t>&>(currently_reading_), wrapped_);
+                mutex_.lock_shared();
+                return RwData<T>(mutex_, wrapped_);
             }
             auto write() -> RwDataMut<T> {
-                ZoneScoped;
-                while (currently_reading_.load(std::memory_order_acquire) != 0) {
-                    // spin
-                }
-                currently_writing_.store(true, std::memory_order_release);
-                return RwDataMut<T>(currently_writing_, wrapped_);
+                mutex_.lock();
+                return RwDataMut<T>(mutex_, wrapped_);
             }
 
+            auto set_name(std::string_view name) -> void {
+                mutex_.set_name(name);
+            }
 
             friend auto swap(RwLock& a, RwLock& b) noexcept -> void
                 requires std::is_nothrow_swappable_v<T>
             {
                 using std::swap;
                 swap(a.wrapped_, b.wrapped_);
-
-                b.currently_reading_.exchange(a.currently_reading_.exchange(b.currently_reading_));
-                b.currently_writing_.exchange(a.currently_writing_.exchange(b.currently_writing_));
-
-                swap(a.moved_, b.moved_);
             }
 
             auto unsafe_open_all_locks() {
-                currently_reading_.store(0, std::memory_order_release);
-                currently_writing_.store(false, std::memory_order_release);
+                mutex_.unsafe_reset();
             }
 
         private:
             T wrapped_;
-            std::atomic<std::uint64_t> currently_reading_;
-            std::atomic<bool> currently_writing_;
-            bool moved_ = false;
+            mutable RwMutex mutex_;
     };
 } // namespace ENGINE_NS
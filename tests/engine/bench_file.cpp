@@ -0,0 +1,136 @@
+#include <engine/fileio/archive.h>
+#include <engine/fileio/content_hash.h>
+#include <engine/fileio/file.h>
+#include <engine/fileio/stream_reader.h>
+#include <engine/fileio/virtual_file_system.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+// Startup cost of reaching every asset: opening each loose file against mapping one archive and looking them all up.
+// The files are hot in the page cache, so this is the per-file system call overhead alone; cold disks widen the gap.
+// The compressed archive adds decoding, which is what a slow disk trades its read time for
+TEST_CASE("Archive - bench", "[Archive][bench]") {
+    constexpr std::size_t FILES = 500;
+    constexpr std::size_t SIZE  = 16 * 1024;
+
+    auto root              = std::filesystem::temp_directory_path() / "engine_bench_archive_assets";
+    auto packed            = std::filesystem::temp_directory_path() / "engine_bench_archive.pak";
+    auto packed_compressed = std::filesystem::temp_directory_path() / "engine_bench_archive_compressed.pak";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    auto paths    = std::vector<std::filesystem::path>();
+    auto contents = std::vector<std::uint8_t>(SIZE, 0x5a);
+    for (std::size_t i = 0; i < FILES; i++) {
+        paths.push_back(root / ("asset_" + std::to_string(i) + ".bin"));
+        auto file = fileio::File::open(paths.back(), fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+        REQUIRE(file.has_value());
+        REQUIRE(file->write_buffer(contents).has_value());
+    }
+    auto writer = fileio::ArchiveWriter();
+    REQUIRE(writer.add_directory(root).has_value());
+    REQUIRE(writer.write(packed).has_value());
+    auto compressed_writer = fileio::ArchiveWriter(fileio::archive::Compression::LZ);
+    REQUIRE(compressed_writer.add_directory(root).has_value());
+    REQUIRE(compressed_writer.write(packed_compressed).has_value());
+
+    BENCHMARK("open and read 500 loose files") {
+        std::size_t total = 0;
+        auto buffer       = std::vector<std::uint8_t>(SIZE);
+        for (const auto& path : paths) {
+            auto file = fileio::File::open(path, fileio::OpenMode::BINARY, fileio::IoMode::READ);
+            total += file->read_into(std::span(buffer)).value() + buffer[SIZE - 1];
+        }
+        return total;
+    };
+    BENCHMARK("map 500 loose files") {
+        std::size_t total = 0;
+        auto files        = fileio::VirtualFileSystem();
+        for (const auto& path : paths) {
+            auto file = files.open(path);
+            total += file->size() + static_cast<std::size_t>(file->bytes()[SIZE - 1]);
+        }
+        return total;
+    };
+    BENCHMARK("mount one archive and find 500 files") {
+        std::size_t total = 0;
+        auto files        = fileio::VirtualFileSystem();
+        (void)files.mount(packed);
+        for (const auto& path : paths) {
+            auto file = files.open(path);
+            total += file->size() + static_cast<std::size_t>(file->bytes()[SIZE - 1]);
+        }
+        return total;
+    };
+
+    BENCHMARK("mount one compressed archive and decode 500 files") {
+        std::size_t total = 0;
+        auto files        = fileio::VirtualFileSystem();
+        (void)files.mount(packed_compressed);
+        for (const auto& path : paths) {
+            auto file = files.open(path);
+            total += file->size() + static_cast<std::size_t>(file->bytes()[SIZE - 1]);
+        }
+        return total;
+    };
+
+    std::filesystem::remove_all(root);
+    std::filesystem::remove(packed);
+    std::filesystem::remove(packed_compressed);
+}
+
+// One pass over a large file, hashing each chunk as a stand in for parsing it. Reading into a buffer waits for every read
+// before parsing and parses before every read; streaming parses one chunk while the next is read. The file is hot in the
+// page cache, so reads are copies, and the gap grows with a slower disk or a slower parser
+TEST_CASE("StreamReader - bench", "[StreamReader][bench]") {
+    constexpr std::size_t SIZE  = 256 * 1024 * 1024;
+    constexpr std::size_t CHUNK = 1024 * 1024;
+
+    auto path = std::filesystem::temp_directory_path() / "engine_bench_stream.bin";
+    {
+        auto file  = fileio::File::open(path, fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+        auto chunk = std::vector<std::uint8_t>(CHUNK);
+        REQUIRE(file.has_value());
+        for (std::size_t written = 0; written < SIZE; written += CHUNK) {
+            chunk[0] = static_cast<std::uint8_t>(written / CHUNK);
+            REQUIRE(file->write_buffer(chunk).has_value());
+        }
+    }
+
+    BENCHMARK("File::read_into 256 MiB in 1 MiB chunks and hash them") {
+        std::uint64_t hash = 0;
+        auto file          = fileio::File::open(path, fileio::OpenMode::BINARY, fileio::IoMode::READ);
+        auto buffer        = std::vector<std::byte>(CHUNK);
+        while (true) {
+            auto read = file->read_into(std::span(buffer)).value();
+            if (read == 0) {
+                break;
+            }
+            hash ^= fileio::content_hash(std::span(buffer).first(read));
+        }
+        return hash;
+    };
+    BENCHMARK("StreamReader 256 MiB in 1 MiB chunks and hash them") {
+        std::uint64_t hash = 0;
+        auto reader        = fileio::StreamReader::open(path, CHUNK);
+        while (true) {
+            auto chunk = reader->next().value();
+            if (chunk.empty()) {
+                break;
+            }
+            hash ^= fileio::content_hash(chunk);
+        }
+        return hash;
+    };
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,58 @@
+#include <engine/jobs/job_system.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    // Enough arithmetic per element that scheduling is not the only thing measured
+    auto work(std::uint64_t seed) -> double {
+        auto value = static_cast<double>(seed);
+        for (int i = 0; i < 64; i++) {
+            value = std::sqrt(value * 1.0001 + 1.0);
+        }
+        return value;
+    }
+} // namespace
+
+TEST_CASE("Job system - scaling bench", "[Jobs][bench]") {
+    // Worker counts beyond the machine's core count are still run so oversubscription shows up in the results
+    std::size_t workers = GENERATE(1, 2, 4, 8, 16, 32);
+    auto system         = JobSystem(workers - 1);
+    auto name           = std::to_string(workers) + " threads";
+
+    constexpr std::size_t COUNT = 1 << 18;
+    auto output                 = std::vector<double>(COUNT);
+
+    BENCHMARK(name + " parallel_for coarse") {
+        system.parallel_for(0, COUNT, COUNT / 256, [&](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; i++) {
+                output[i] = work(i);
+            }
+        });
+        return output[COUNT / 2];
+    };
+    BENCHMARK(name + " parallel_for fine") {
+        system.parallel_for(0, COUNT, 64, [&](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; i++) {
+                output[i] = work(i);
+            }
+        });
+        return output[COUNT / 2];
+    };
+    BENCHMARK(name + " empty jobs") {
+        auto counter = jobs::Counter();
+        for (int i = 0; i < 10'000; i++) {
+            system.schedule([] {}, &counter);
+        }
+        system.wait(counter);
+        return counter.done();
+    };
+}
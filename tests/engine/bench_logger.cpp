@@ -0,0 +1,56 @@
+#include <engine/engine.h>
+#include <engine/logger.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <string>
+
+using namespace ::ENGINE_NS;
+
+// Measures the caller's side of a log call: capture the arguments, then hand off to the sink thread
+TEST_CASE("Logger - bench", "[Logger][bench]") {
+    auto* file = std::tmpfile();
+    {
+        auto sink = logger::Sink();
+        auto log  = LoggerBuilder().with_identifier("BENCH").with_stream({file, logger::Level::DEBUG}).build(sink);
+        auto long_name = std::string(logger::DEFERRED_ARGS_CAPACITY, 'x');
+
+        BENCHMARK("log short message") {
+            log.info("frame submitted");
+        };
+        BENCHMARK("log formatted message") {
+            log.debug(R"(Compiling pipeline "{}" with id "{}")", "tilemap", 42);
+        };
+        BENCHMARK("log formatted message, formatted eagerly") {
+            // Too long to defer, so this pays for formatting on the calling thread as every call used to
+            log.debug(R"(Compiling pipeline "{}" with id "{}")", long_name, 42);
+        };
+        sink.flush();
+    }
+    std::fclose(file);
+}
+
+// A call below the level in effect should cost one relaxed load and a compare: no lock, no formatting, no record
+TEST_CASE("Logger - filtered bench", "[Logger][bench]") {
+    auto* file = std::tmpfile();
+    {
+        auto sink = logger::Sink();
+        auto log  = LoggerBuilder().with_identifier("BENCH").with_stream({file, logger::Level::INFO}).build(sink);
+
+        BENCHMARK("debug filtered by the logger's streams") {
+            log.debug(R"(Compiling pipeline "{}" with id "{}")", "tilemap", 42);
+        };
+
+        auto locator = LogLocator();
+        locator.set_level(LogNamespaces::GRAPHICS, logger::Level::INFO);
+        BENCHMARK("debug filtered by the namespace level") {
+            locator.debug(LogNamespaces::GRAPHICS, R"(Compiling pipeline "{}" with id "{}")", "tilemap", 42);
+        };
+        BENCHMARK("namespace level check") {
+            return locator.enabled(LogNamespaces::GRAPHICS, logger::Level::DEBUG);
+        };
+    }
+    std::fclose(file);
+}
@@ -0,0 +1,303 @@
+#include <engine/pool.h>
+#include <engine/pool/region.h>
+#include <engine/random.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+// Skip combinations that would need more memory than a dev machine reasonably has spare
+constexpr std::size_t MAX_BENCH_BYTES = 1ull << 30;
+
+template <std::size_t Size>
+struct Payload {
+        Payload() {
+        }
+        Payload(std::uint8_t value) {
+            bytes[0] = value;
+        }
+        std::uint8_t bytes[Size];
+};
+
+/*
+    Every container is driven through the same interface so each case measures identical work:
+        reserve(count)
+        allocate() -> key
+        free(key)
+        for_each(func)
+*/
+template <typename T>
+class PoolAdapter {
+    public:
+        static constexpr const char* NAME = "Pool";
+
+        auto reserve(std::size_t count) -> void {
+            m_pool.reserve(count);
+            m_borrows.reserve(count);
+        }
+        auto allocate() -> std::size_t {
+            m_borrows.push_back(m_pool.allocate(static_cast<std::uint8_t>(m_borrows.size())));
+            return m_borrows.size() - 1;
+        }
+        auto free(std::size_t key) -> void {
+            m_pool.free(m_borrows[key]);
+        }
+        template <typename TFunc>
+        auto for_each(TFunc&& func) -> void {
+            for (auto& object : m_pool) {
+                func(object);
+            }
+        }
+
+    private:
+        Pool<T> m_pool;
+        std::vector<pool::Borrow<T>> m_borrows;
+};
+
+template <typename T>
+class RegionAdapter {
+    public:
+        static constexpr const char* NAME = "Region";
+
+        auto reserve(std::size_t count) -> void {
+            m_region.reserve(count);
+        }
+        auto allocate() -> std::size_t {
+            if (m_region.get_free_index() == Index::gravestone()) {
+                m_region.reserve(std::max<std::size_t>(512, m_region.capacity() * 2));
+            }
+            auto idx = m_region.get_free_index();
+            m_region.emplace(idx, static_cast<std::uint8_t>(static_cast<std::size_t>(idx)));
+            return static_cast<std::size_t>(idx);
+        }
+        auto free(std::size_t key) -> void {
+            m_region.free(Index(key));
+        }
+        template <typename TFunc>
+        auto for_each(TFunc&& func) -> void {
+            if (!m_region.alive()) {
+                return;
+            }
+            for (auto& allocation : m_region) {
+                func(allocation.object);
+            }
+        }
+
+    private:
+        Region<T> m_region;
+};
+
+// The usual hand-rolled alternative: contiguous storage, a liveness flag per slot and a stack of free slots
+template <typename T, typename TStorage>
+class FreeListAdapter {
+    public:
+        auto reserve(std::size_t count) -> void {
+            if constexpr (requires(TStorage storage) { storage.reserve(std::size_t{}); }) {
+                m_objects.reserve(count);
+            }
+            m_alive.reserve(count);
+            m_free.reserve(count);
+        }
+        auto allocate() -> std::size_t {
+            if (m_free.empty()) {
+                m_objects.emplace_back(static_cast<std::uint8_t>(m_objects.size()));
+                m_alive.push_back(true);
+                return m_objects.size() - 1;
+            }
+            auto key       = m_free.back();
+            m_objects[key] = T(static_cast<std::uint8_t>(key));
+            m_alive[key]   = true;
+            m_free.pop_back();
+            return key;
+        }
+        auto free(std::size_t key) -> void {
+            m_alive[key] = false;
+            m_free.push_back(key);
+        }
+        template <typename TFunc>
+        auto for_each(TFunc&& func) -> void {
+            for (std::size_t i = 0; i < m_objects.size(); i++) {
+                if (m_alive[i]) {
+                    func(m_objects[i]);
+                }
+            }
+        }
+
+    private:
+        TStorage m_objects;
+        std::vector<bool> m_alive;
+        std::vector<std::size_t> m_free;
+};
+
+template <typename T>
+struct VectorAdapter : FreeListAdapter<T, std::vector<T>> {
+        static constexpr const char* NAME = "std::vector + free list";
+};
+
+template <typename T>
+struct DequeAdapter : FreeListAdapter<T, std::deque<T>> {
+        static constexpr const char* NAME = "std::deque + free list";
+};
+
+template <typename T>
+class UnorderedMapAdapter {
+    public:
+        static constexpr const char* NAME = "std::unordered_map";
+
+        auto reserve(std::size_t count) -> void {
+            m_objects.reserve(count);
+        }
+        auto allocate() -> std::size_t {
+            auto key = m_next_key++;
+            m_objects.emplace(key, T(static_cast<std::uint8_t>(key)));
+            return key;
+        }
+        auto free(std::size_t key) -> void {
+            m_objects.erase(key);
+        }
+        template <typename TFunc>
+        auto for_each(TFunc&& func) -> void {
+            for (auto& [key, object] : m_objects) {
+                func(object);
+            }
+        }
+
+    private:
+        std::unordered_map<std::size_t, T> m_objects;
+        std::size_t m_next_key = 0;
+};
+
+auto shuffled_keys(std::size_t count, Random& rng) -> std::vector<std::size_t> {
+    auto keys = std::vector<std::size_t>(count);
+    for (std::size_t i = 0; i < count; i++) {
+        keys[i] = i;
+    }
+    for (std::size_t i = count - 1; i > 0; i--) {
+        auto j = rng.range<std::uint64_t>({0, i});
+        std::swap(keys[i], keys[j]);
+    }
+    return keys;
+}
+
+// Fill in place: Pool borrows point back at their pool, so adapters must never be moved once used
+template <typename TAdapter>
+auto fill(TAdapter& container, std::size_t count) -> void {
+    container.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        container.allocate();
+    }
+}
+
+template <template <typename> typename TAdapter, typename T>
+auto run_benchmarks(std::size_t count) -> void {
+    using Adapter = TAdapter<T>;
+    auto name     = std::string(Adapter::NAME) + " [" + std::to_string(sizeof(T)) + "B x " + std::to_string(count) + "]";
+    auto rng      = Random(0x9E3779B97F4A7C15);
+
+    BENCHMARK_ADVANCED(name + " allocate")(Catch::Benchmark::Chronometer meter) {
+        auto containers = std::vector<Adapter>(meter.runs());
+        for (auto& container : containers) {
+            container.reserve(count);
+        }
+        meter.measure([&](int run) {
+            auto& container = containers[run];
+            for (std::size_t i = 0; i < count; i++) {
+                container.allocate();
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED(name + " free")(Catch::Benchmark::Chronometer meter) {
+        auto keys       = shuffled_keys(count, rng);
+        auto containers = std::vector<Adapter>(meter.runs());
+        for (auto& container : containers) {
+            fill(container, count);
+        }
+        meter.measure([&](int run) {
+            auto& container = containers[run];
+            for (auto key : keys) {
+                container.free(key);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED(name + " churn")(Catch::Benchmark::Chronometer meter) {
+        auto containers = std::vector<Adapter>(meter.runs());
+        auto live       = std::vector<std::vector<std::size_t>>();
+        for (auto& container : containers) {
+            fill(container, count);
+            live.push_back(shuffled_keys(count, rng));
+        }
+        // Precompute the victims so the generator is not part of the measurement
+        auto victims = std::vector<std::size_t>(count);
+        for (auto& victim : victims) {
+            victim = rng.range<std::uint64_t>({0, count - 1});
+        }
+        meter.measure([&](int run) {
+            auto& container = containers[run];
+            auto& keys      = live[run];
+            for (auto victim : victims) {
+                container.free(keys[victim]);
+                keys[victim] = container.allocate();
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED(name + " iterate dense")(Catch::Benchmark::Chronometer meter) {
+        auto container = Adapter();
+        fill(container, count);
+        meter.measure([&] {
+            std::uint64_t sum = 0;
+            container.for_each([&sum](const T& object) { sum += object.bytes[0]; });
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED(name + " iterate sparse")(Catch::Benchmark::Chronometer meter) {
+        // Free 90% of the objects in random order, leaving scattered survivors
+        auto container = Adapter();
+        fill(container, count);
+        auto keys      = shuffled_keys(count, rng);
+        for (std::size_t i = 0; i < count - count / 10; i++) {
+            container.free(keys[i]);
+        }
+        meter.measure([&] {
+            std::uint64_t sum = 0;
+            container.for_each([&sum](const T& object) { sum += object.bytes[0]; });
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED(name + " grow")(Catch::Benchmark::Chronometer meter) {
+        auto containers = std::vector<Adapter>(meter.runs());
+        meter.measure([&](int run) {
+            auto& container = containers[run];
+            for (std::size_t i = 0; i < count; i++) {
+                container.allocate();
+            }
+        });
+    };
+}
+
+TEMPLATE_TEST_CASE("Pool - bench", "[Pool][Region][bench]", Payload<8>, Payload<64>, Payload<256>) {
+    std::size_t count = GENERATE(1'000, 10'000, 100'000, 1'000'000, 10'000'000);
+    if (count * sizeof(TestType) > MAX_BENCH_BYTES) {
+        return;
+    }
+
+    run_benchmarks<PoolAdapter, TestType>(count);
+    run_benchmarks<RegionAdapter, TestType>(count);
+    run_benchmarks<VectorAdapter, TestType>(count);
+    run_benchmarks<DequeAdapter, TestType>(count);
+    run_benchmarks<UnorderedMapAdapter, TestType>(count);
+}
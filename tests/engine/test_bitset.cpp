@@ -1,4 +1,5 @@
 #include <engine/bitset.h>
+#include <engine/random.h>
 
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -6,6 +7,11 @@
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <catch2/generators/catch_generators_random.hpp>
 
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 using namespace ::ENGINE_NS;
 
 TEST_CASE("Bitset::Bitset", "[Bitset]") {
@@ -762,3 +768,330 @@ TEST_CASE("Bitset::extend", "[Bitset]") {
     bitset.extend(100);
     REQUIRE(bitset.size() == 150);
 }
+
+TEST_CASE("Bitset::is_inline", "[Bitset]") {
+    SECTION("Small") {
+        auto bitset = Bitset(Bitset::INLINE_BITS);
+        REQUIRE(bitset.is_inline());
+    }
+    SECTION("Spill") {
+        auto bitset = Bitset();
+        bitset.set(3);
+        bitset.set(Bitset::INLINE_BITS - 1);
+        REQUIRE(bitset.is_inline());
+
+        bitset.set(Bitset::INLINE_BITS);
+        REQUIRE_FALSE(bitset.is_inline());
+        REQUIRE(bitset[3] == 1);
+        REQUIRE(bitset[Bitset::INLINE_BITS - 1] == 1);
+        REQUIRE(bitset[Bitset::INLINE_BITS] == 1);
+        REQUIRE(bitset[4] == 0);
+    }
+    SECTION("Mixed operations") {
+        auto small = Bitset();
+        small.set(1);
+        small.set(70);
+        auto big = Bitset();
+        big.set(1);
+        big.set(1'000);
+
+        auto combined = small | big;
+        REQUIRE_FALSE(combined.is_inline());
+        REQUIRE(combined[1] == 1);
+        REQUIRE(combined[70] == 1);
+        REQUIRE(combined[1'000] == 1);
+
+        auto intersection = small & big;
+        REQUIRE(intersection[1] == 1);
+        REQUIRE(intersection[70] == 0);
+        REQUIRE(small.is_subset_of(combined));
+    }
+    SECTION("Moved from") {
+        auto bitset = Bitset();
+        bitset.set(1'000);
+        auto moved = std::move(bitset);
+
+        REQUIRE(moved[1'000] == 1);
+        REQUIRE(bitset.size() == 0);
+        REQUIRE(bitset.is_inline());
+
+        bitset.set(2);
+        REQUIRE(bitset[2] == 1);
+    }
+}
+
+TEST_CASE("Bitset::for_each_set_bit", "[Bitset]") {
+    SECTION("Empty") {
+        auto bitset = Bitset(500);
+        auto calls  = 0;
+        bitset.for_each_set_bit([&calls](size_t) { calls++; });
+        REQUIRE(calls == 0);
+    }
+    SECTION("Ascending across words") {
+        auto bitset = Bitset();
+        bitset.set(0);
+        bitset.set(63);
+        bitset.set(64);
+        bitset.set(300);
+        bitset.set(5'000);
+
+        auto bits = std::vector<size_t>();
+        bitset.for_each_set_bit([&bits](size_t idx) { bits.push_back(idx); });
+        REQUIRE(bits == std::vector<size_t>{0, 63, 64, 300, 5'000});
+        REQUIRE(bitset.set_bits() == bits);
+    }
+}
+
+TEST_CASE("Bitset::count", "[Bitset]") {
+    SECTION("Empty") {
+        REQUIRE(Bitset().count() == 0);
+        REQUIRE(Bitset(5'000).count() == 0);
+    }
+    SECTION("Small") {
+        auto bitset = Bitset();
+        bitset.set(1);
+        bitset.set(2);
+        bitset.set(200);
+        REQUIRE(bitset.count() == 3);
+    }
+    SECTION("Large") {
+        auto bitset = Bitset();
+        for (size_t idx = 0; idx < 10'000; idx += 3) {
+            bitset.set(idx);
+        }
+        REQUIRE(bitset.count() == 3'334);
+    }
+}
+
+TEST_CASE("Bitset::find_first", "[Bitset]") {
+    REQUIRE_FALSE(Bitset().find_first().has_value());
+    REQUIRE_FALSE(Bitset(1'000).find_first().has_value());
+
+    auto bitset = Bitset();
+    bitset.set(4'000);
+    bitset.set(700);
+    REQUIRE(bitset.find_first() == 700);
+}
+
+TEST_CASE("Bitset::any", "[Bitset]") {
+    auto bitset = Bitset(1'000);
+    REQUIRE_FALSE(bitset.any());
+    REQUIRE(bitset.none());
+
+    bitset.set(999);
+    REQUIRE(bitset.any());
+    REQUIRE_FALSE(bitset.none());
+
+    bitset.clear(999);
+    REQUIRE(bitset.none());
+}
+
+TEST_CASE("Bitset::large operations", "[Bitset]") {
+    // Large enough to take the vectorised paths where they are available
+    constexpr size_t bits = 10'007;
+    auto lhs              = Bitset();
+    auto rhs              = Bitset();
+    for (size_t idx = 0; idx < bits; idx++) {
+        if (idx % 3 == 0) {
+            lhs.set(idx);
+        }
+        if (idx % 5 == 0) {
+            rhs.set(idx);
+        }
+    }
+
+    SECTION("or") {
+        auto combined = lhs | rhs;
+        for (size_t idx = 0; idx < bits; idx++) {
+            REQUIRE(combined[idx] == ((idx % 3 == 0 || idx % 5 == 0) ? 1 : 0));
+        }
+    }
+    SECTION("and") {
+        auto combined = lhs & rhs;
+        REQUIRE(combined.count() == (bits + 14) / 15);
+        REQUIRE(combined.is_subset_of(lhs));
+        REQUIRE(combined.is_subset_of(rhs));
+    }
+    SECTION("xor") {
+        auto combined = lhs ^ rhs;
+        REQUIRE(combined.count() == lhs.count() + rhs.count() - 2 * (lhs & rhs).count());
+    }
+    SECTION("subset") {
+        REQUIRE_FALSE(lhs.is_subset_of(rhs));
+        REQUIRE(lhs.is_subset_of(lhs | rhs));
+
+        auto smaller = Bitset();
+        smaller.set(3);
+        REQUIRE(smaller.is_subset_of(lhs));
+        REQUIRE_FALSE(lhs.is_subset_of(smaller));
+    }
+}
+
+TEST_CASE("Bitset - bench", "[Bitset][bench]") {
+    auto bits = GENERATE(256, 4'096, 65'536);
+    auto lhs  = Bitset();
+    auto rhs  = Bitset();
+    for (auto idx = 0; idx < bits; idx++) {
+        if (idx % 3 == 0) {
+            lhs.set(idx);
+        }
+        if (idx % 7 == 0) {
+            rhs.set(idx);
+        }
+    }
+    auto suffix = " [" + std::to_string(bits) + " bits]";
+
+    BENCHMARK("bit_or" + suffix) {
+        return lhs | rhs;
+    };
+    BENCHMARK("bit_and" + suffix) {
+        return lhs & rhs;
+    };
+    BENCHMARK("is_subset_of" + suffix) {
+        return rhs.is_subset_of(lhs);
+    };
+    BENCHMARK("count" + suffix) {
+        return lhs.count();
+    };
+    BENCHMARK("set_bits" + suffix) {
+        return lhs.set_bits();
+    };
+    BENCHMARK("for_each_set_bit" + suffix) {
+        size_t sum = 0;
+        lhs.for_each_set_bit([&sum](size_t idx) { sum += idx; });
+        return sum;
+    };
+}
+
+namespace {
+    // Archetype-like component masks: a few components each, drawn from a realistic number of component types
+    auto random_component_sets(std::size_t count, std::uint32_t component_types) -> std::vector<Bitset> {
+        auto rng  = Random(0xC0FFEE);
+        auto sets = std::vector<Bitset>();
+        sets.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            auto set        = Bitset();
+            auto components = rng.range<std::uint32_t>({2, 8});
+            for (std::uint32_t c = 0; c < components; c++) {
+                set.set(rng.range<std::uint32_t>({0, component_types - 1}));
+            }
+            sets.push_back(std::move(set));
+        }
+        return sets;
+    }
+} // namespace
+
+TEST_CASE("Bitset::hash", "[Bitset]") {
+    SECTION("Equal sets hash equally") {
+        auto lhs = Bitset(500);
+        lhs.set(3);
+        lhs.set(70);
+        auto rhs = Bitset(500);
+        rhs.set(70);
+        rhs.set(9);
+        rhs.set(3);
+        rhs.clear(9);
+
+        REQUIRE(lhs == rhs);
+        REQUIRE(lhs.hash() == rhs.hash());
+        REQUIRE(std::hash<Bitset>{}(lhs) == std::hash<Bitset>{}(rhs));
+    }
+    SECTION("Sets with the same bits hash equally whatever their size") {
+        auto lhs = Bitset();
+        lhs.set(3);
+        lhs.set(70);
+        auto rhs = Bitset(500);
+        rhs.set(70);
+        rhs.set(3);
+
+        REQUIRE(lhs.hash() == rhs.hash());
+        REQUIRE(std::hash<Bitset>{}(lhs) == std::hash<Bitset>{}(rhs));
+    }
+    SECTION("Operators produce the same hash as building directly") {
+        auto a = Bitset();
+        a.set(1);
+        auto b = Bitset();
+        b.set(2);
+        auto expected = Bitset();
+        expected.set(1);
+        expected.set(2);
+
+        REQUIRE((a | b).hash() == expected.hash());
+        REQUIRE((a ^ b).hash() == expected.hash());
+        REQUIRE((a & b).hash() == Bitset().hash());
+    }
+    SECTION("Modification invalidates the cache") {
+        auto bitset = Bitset();
+        bitset.set(5);
+        auto before = bitset.hash();
+        bitset.set(6);
+        REQUIRE(bitset.hash() != before);
+        bitset.clear(6);
+        REQUIRE(bitset.hash() == before);
+        bitset.flip(5);
+        REQUIRE(bitset.hash() == Bitset().hash());
+    }
+    SECTION("Copies keep the hash") {
+        auto bitset = Bitset();
+        bitset.set(12);
+        auto copy = bitset;
+        REQUIRE(copy.hash() == bitset.hash());
+    }
+    SECTION("Distinct component sets do not collide") {
+        auto sets   = random_component_sets(20'000, 96);
+        auto unique = std::unordered_set<Bitset>(sets.begin(), sets.end());
+        auto hashes = std::unordered_set<std::uint64_t>();
+        for (const auto& set : unique) {
+            hashes.insert(set.hash());
+        }
+        REQUIRE(hashes.size() == unique.size());
+    }
+    SECTION("Low bits are well distributed") {
+        // robin_map buckets on the low bits, so those must be uniform even for sets which differ in one bit
+        constexpr std::size_t buckets = 256;
+        auto counts                   = std::vector<std::size_t>(buckets);
+        auto sets                     = std::size_t{0};
+        for (std::size_t a = 0; a < 96; a++) {
+            for (std::size_t b = a + 1; b < 96; b++) {
+                auto set = Bitset();
+                set.set(a);
+                set.set(b);
+                counts[set.hash() % buckets] += 1;
+                sets += 1;
+            }
+        }
+        auto expected = sets / buckets;
+        REQUIRE(*std::ranges::max_element(counts) < expected * 2);
+        REQUIRE(*std::ranges::min_element(counts) > expected / 3);
+    }
+}
+
+TEST_CASE("Bitset::hash - bench", "[Bitset][bench]") {
+    auto sets   = random_component_sets(4'096, 96);
+    auto lookup = std::unordered_set<Bitset>(sets.begin(), sets.end());
+
+    BENCHMARK("hash, cold") {
+        std::uint64_t combined = 0;
+        for (auto& set : sets) {
+            // Flipped twice so the cached hash is dropped but the bits the later benchmarks hash stay the same
+            set.flip(0);
+            set.flip(0);
+            combined ^= set.hash();
+        }
+        return combined;
+    };
+    BENCHMARK("hash, cached") {
+        std::uint64_t combined = 0;
+        for (const auto& set : sets) {
+            combined ^= set.hash();
+        }
+        return combined;
+    };
+    BENCHMARK("unordered_set lookup") {
+        std::size_t found = 0;
+        for (const auto& set : sets) {
+            found += lookup.contains(set) ? 1 : 0;
+        }
+        return found;
+    };
+}
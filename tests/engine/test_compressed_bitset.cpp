@@ -0,0 +1,210 @@
+#include <engine/bitset.h>
+#include <engine/compressed_bitset.h>
+#include <engine/random.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    auto members(const CompressedBitset& bitset) -> std::vector<std::uint32_t> {
+        auto result = std::vector<std::uint32_t>();
+        bitset.for_each_set_bit([&result](std::uint32_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    auto members(const Bitset& bitset) -> std::vector<std::uint32_t> {
+        auto result = std::vector<std::uint32_t>();
+        bitset.for_each_set_bit([&result](size_t idx) { result.push_back(static_cast<std::uint32_t>(idx)); });
+        return result;
+    }
+
+    // A mix of sparse singles, a dense patch that needs a bitmap and a long run, spread over several blocks
+    auto random_sets(Random& rng, CompressedBitset& compressed, Bitset& reference) -> void {
+        for (int i = 0; i < 2'000; i++) {
+            auto idx = static_cast<std::uint32_t>(rng.range<std::uint64_t>({0, 300'000}));
+            compressed.set(idx);
+            reference.set(idx);
+        }
+        auto dense_base = static_cast<std::uint32_t>(rng.range<std::uint64_t>({0, 200'000}));
+        for (std::uint32_t i = 0; i < 10'000; i++) {
+            if (rng.range<std::uint64_t>({0, 1}) == 1) {
+                compressed.set(dense_base + i);
+                reference.set(dense_base + i);
+            }
+        }
+        auto run_base = static_cast<std::uint32_t>(rng.range<std::uint64_t>({0, 200'000}));
+        compressed.set_range(run_base, run_base + 20'000);
+        for (std::uint32_t i = run_base; i <= run_base + 20'000; i++) {
+            reference.set(i);
+        }
+    }
+} // namespace
+
+TEST_CASE("CompressedBitset::set", "[CompressedBitset]") {
+    SECTION("Empty") {
+        auto bitset = CompressedBitset();
+        REQUIRE(bitset.none());
+        REQUIRE(bitset.count() == 0);
+        REQUIRE(bitset[0] == 0);
+        REQUIRE(bitset[1'000'000] == 0);
+    }
+    SECTION("Set and clear across blocks") {
+        auto bitset = CompressedBitset();
+        bitset.set(0);
+        bitset.set(65'535);
+        bitset.set(65'536);
+        bitset.set(4'000'000'000);
+        REQUIRE(bitset.any());
+        REQUIRE(bitset.count() == 4);
+        REQUIRE(bitset[0] == 1);
+        REQUIRE(bitset[1] == 0);
+        REQUIRE(bitset[65'535] == 1);
+        REQUIRE(bitset[65'536] == 1);
+        REQUIRE(bitset[4'000'000'000] == 1);
+
+        bitset.set(0);
+        REQUIRE(bitset.count() == 4);
+
+        bitset.clear(65'536);
+        bitset.clear(7);
+        REQUIRE(bitset.count() == 3);
+        REQUIRE(bitset[65'536] == 0);
+
+        bitset.clear(0);
+        bitset.clear(65'535);
+        bitset.clear(4'000'000'000);
+        REQUIRE(bitset.none());
+    }
+    SECTION("Array grows into a bitmap and shrinks back") {
+        auto bitset = CompressedBitset();
+        for (std::uint32_t i = 0; i < 10'000; i++) {
+            bitset.set(i * 2);
+        }
+        REQUIRE(bitset.count() == 10'000);
+        REQUIRE(bitset[9'998] == 1);
+        REQUIRE(bitset[9'999] == 0);
+
+        for (std::uint32_t i = 0; i < 8'000; i++) {
+            bitset.clear(i * 2);
+        }
+        REQUIRE(bitset.count() == 2'000);
+        REQUIRE(bitset[16'000] == 1);
+        REQUIRE(bitset[15'998] == 0);
+    }
+    SECTION("Set range") {
+        auto bitset = CompressedBitset();
+        bitset.set(5);
+        bitset.set_range(100, 200'000);
+        REQUIRE(bitset.count() == 1 + 200'000 - 100 + 1);
+        REQUIRE(bitset[5] == 1);
+        REQUIRE(bitset[99] == 0);
+        REQUIRE(bitset[100] == 1);
+        REQUIRE(bitset[131'072] == 1);
+        REQUIRE(bitset[200'000] == 1);
+        REQUIRE(bitset[200'001] == 0);
+
+        bitset.clear(150'000);
+        REQUIRE(bitset[150'000] == 0);
+        REQUIRE(bitset[150'001] == 1);
+        REQUIRE(bitset.count() == 200'000 - 100 + 1);
+    }
+}
+
+TEST_CASE("CompressedBitset::for_each_set_bit", "[CompressedBitset]") {
+    auto bitset = CompressedBitset();
+    bitset.set(70'000);
+    bitset.set(3);
+    bitset.set_range(10, 12);
+    bitset.set(65'536);
+    REQUIRE(members(bitset) == std::vector<std::uint32_t>{3, 10, 11, 12, 65'536, 70'000});
+}
+
+TEST_CASE("CompressedBitset::operations", "[CompressedBitset]") {
+    auto rng = Random(0x5EED);
+    for (int round = 0; round < 8; round++) {
+        auto lhs           = CompressedBitset();
+        auto rhs           = CompressedBitset();
+        auto lhs_reference = Bitset();
+        auto rhs_reference = Bitset();
+        random_sets(rng, lhs, lhs_reference);
+        random_sets(rng, rhs, rhs_reference);
+
+        // Odd rounds exercise the run containers as well
+        if (round % 2 == 1) {
+            lhs.optimise();
+            rhs.optimise();
+        }
+
+        // Or
+        {
+            REQUIRE(members(lhs | rhs) == members(lhs_reference | rhs_reference));
+        }
+        // And
+        {
+            REQUIRE(members(lhs & rhs) == members(lhs_reference & rhs_reference));
+        }
+        // And not
+        {
+            auto expected = std::vector<std::uint32_t>();
+            lhs_reference.for_each_set_bit([&](size_t idx) {
+                if (!rhs_reference.get(idx)) {
+                    expected.push_back(static_cast<std::uint32_t>(idx));
+                }
+            });
+            REQUIRE(members(lhs.bit_and_not(rhs)) == expected);
+            REQUIRE(lhs.bit_and_not(lhs).none());
+        }
+        // Equality
+        {
+            auto copy = lhs;
+            REQUIRE(copy == lhs);
+            copy.optimise();
+            REQUIRE(copy == lhs);
+            REQUIRE((lhs | rhs) == (rhs | lhs));
+            REQUIRE(!(lhs == rhs));
+        }
+        // Compound assignment
+        {
+            auto combined = lhs;
+            combined |= rhs;
+            REQUIRE(combined == (lhs | rhs));
+            combined &= lhs;
+            REQUIRE(combined == lhs);
+        }
+    }
+}
+
+TEST_CASE("CompressedBitset::optimise", "[CompressedBitset]") {
+    auto bitset = CompressedBitset();
+    for (std::uint32_t i = 0; i < 1'000'000; i++) {
+        bitset.set(i);
+    }
+    auto before = bitset.memory_usage();
+    bitset.optimise();
+    REQUIRE(bitset.memory_usage() < before / 20);
+    REQUIRE(bitset.count() == 1'000'000);
+    REQUIRE(bitset[999'999] == 1);
+    REQUIRE(bitset[1'000'000] == 0);
+
+    // Mutating a run container still works
+    bitset.clear(500'000);
+    bitset.set(2'000'000);
+    REQUIRE(bitset[500'000] == 0);
+    REQUIRE(bitset[500'001] == 1);
+    REQUIRE(bitset.count() == 1'000'000);
+}
+
+TEST_CASE("CompressedBitset::Bitset interop", "[CompressedBitset]") {
+    auto rng        = Random(0xB175E7);
+    auto compressed = CompressedBitset();
+    auto reference  = Bitset();
+    random_sets(rng, compressed, reference);
+
+    REQUIRE(CompressedBitset::from_bitset(reference) == compressed);
+    REQUIRE(members(compressed.to_bitset()) == members(reference));
+    REQUIRE(CompressedBitset().to_bitset().none());
+}
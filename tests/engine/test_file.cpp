@@ -0,0 +1,655 @@
+#include <engine/fileio/archive.h>
+#include <engine/fileio/artifact_cache.h>
+#include <engine/fileio/async_reader.h>
+#include <engine/fileio/content_hash.h>
+#include <engine/fileio/file.h>
+#include <engine/fileio/file_watcher.h>
+#include <engine/fileio/lz.h>
+#include <engine/fileio/stream_reader.h>
+#include <engine/fileio/virtual_file_system.h>
+#include <engine/jobs/job_system.h>
+#include <engine/random.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    // Removes the file when the test is done with it, pass or fail
+    struct TempPath {
+            std::filesystem::path path;
+
+            explicit TempPath(const char* name) : path(std::filesystem::temp_directory_path() / name) {
+            }
+            ~TempPath() {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            }
+    };
+
+    template <typename T>
+    auto write_file(const std::filesystem::path& path, const std::vector<T>& contents) -> void {
+        auto file = fileio::File::open(path, fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+        REQUIRE(file.has_value());
+        REQUIRE(file->write_buffer(contents).has_value());
+        REQUIRE(file->close().has_value());
+    }
+
+    auto random_bytes(std::size_t count, std::uint64_t seed) -> std::vector<std::byte> {
+        auto rng   = Random(seed);
+        auto bytes = std::vector<std::byte>(count);
+        for (auto& b : bytes) {
+            b = static_cast<std::byte>(rng.range<std::uint64_t>({0, 255}));
+        }
+        return bytes;
+    }
+
+    // Text-like data: a few words repeated in varying order, so it compresses but not trivially
+    auto compressible_bytes(std::size_t count) -> std::vector<std::byte> {
+        static constexpr std::array<std::string_view, 6> WORDS = {"vertex ", "fragment ", "uniform ", "sampler2D ", "vec4 ", "\n"};
+        auto rng   = Random(0xC0DE);
+        auto bytes = std::vector<std::byte>();
+        while (bytes.size() < count) {
+            auto word = WORDS[rng.range<std::uint64_t>({0, WORDS.size() - 1})];
+            for (auto c : word) {
+                bytes.push_back(static_cast<std::byte>(c));
+            }
+        }
+        bytes.resize(count);
+        return bytes;
+    }
+
+    auto round_trip(std::span<const std::byte> source) -> void {
+        auto compressed = std::vector<std::byte>(fileio::lz::compress_bound(source.size()));
+        auto size       = fileio::lz::compress(source, compressed);
+        REQUIRE(size > 0);
+        auto decompressed = std::vector<std::byte>(source.size());
+        REQUIRE(fileio::lz::decompress(std::span(compressed).first(size), decompressed) == source.size());
+        REQUIRE(std::ranges::equal(decompressed, source));
+    }
+} // namespace
+
+TEST_CASE("File", "[File]") {
+    SECTION("Mapping a file exposes its bytes in place") {
+        auto temp  = TempPath("engine_test_file_map.bin");
+        auto words = std::vector<std::uint32_t>(10'000);
+        std::iota(words.begin(), words.end(), 0u);
+        write_file(temp.path, words);
+
+        auto mapped = fileio::File::map(temp.path, fileio::AccessHint::SEQUENTIAL);
+        REQUIRE(mapped.has_value());
+        REQUIRE(mapped->size() == words.size() * sizeof(std::uint32_t));
+        REQUIRE(mapped->metadata.path == temp.path);
+
+        auto view = mapped->view<std::uint32_t>();
+        REQUIRE(view.size() == words.size());
+        REQUIRE(std::equal(view.begin(), view.end(), words.begin()));
+
+        // Advice over any range is harmless, including ranges that run off the end
+        mapped->advise(fileio::AccessHint::RANDOM, 12'345, 100);
+        mapped->advise(fileio::AccessHint::WILL_NEED, mapped->size() - 1);
+        mapped->advise(fileio::AccessHint::DONT_NEED, mapped->size() + 1);
+        REQUIRE(mapped->view<std::uint32_t>()[9'999] == 9'999);
+
+        // Moving keeps the same bytes alive and leaves the source empty
+        auto* data = mapped->bytes().data();
+        auto moved = std::move(mapped.value());
+        REQUIRE(moved.bytes().data() == data);
+        REQUIRE(mapped->empty());
+    }
+    SECTION("Views leave out a trailing partial element") {
+        auto temp = TempPath("engine_test_file_map_partial.bin");
+        write_file(temp.path, std::vector<std::uint8_t>{1, 2, 3, 4, 5, 6});
+
+        auto mapped = fileio::File::map(temp.path);
+        REQUIRE(mapped.has_value());
+        REQUIRE(mapped->bytes().size() == 6);
+        REQUIRE(mapped->view<std::uint32_t>().size() == 1);
+        REQUIRE(mapped->bytes()[5] == std::byte{6});
+    }
+    SECTION("Empty files map to an empty view") {
+        auto temp = TempPath("engine_test_file_map_empty.bin");
+        auto file = fileio::File::open(temp.path, fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+        REQUIRE(file.has_value());
+        REQUIRE(file->close().has_value());
+
+        auto mapped = fileio::File::map(temp.path);
+        REQUIRE(mapped.has_value());
+        REQUIRE(mapped->empty());
+        REQUIRE(mapped->view<std::uint32_t>().empty());
+    }
+    SECTION("Spans read and write in place") {
+        auto temp   = TempPath("engine_test_file_span.bin");
+        auto values = std::array<std::uint32_t, 6>{1, 2, 3, 4, 5, 6};
+        {
+            auto file = fileio::File::open(temp.path, fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+            REQUIRE(file.has_value());
+            REQUIRE(file->write(std::span(values)).has_value());
+            REQUIRE(file->write(std::span<const std::uint32_t>()).has_value());
+        }
+        auto file = fileio::File::open(temp.path, fileio::OpenMode::BINARY, fileio::IoMode::READ);
+        REQUIRE(file.has_value());
+        auto read = std::array<std::uint32_t, 4>{};
+        REQUIRE(file->read_into(std::span(read)).value() == 4);
+        REQUIRE(read == std::array<std::uint32_t, 4>{1, 2, 3, 4});
+        // Only two are left
+        REQUIRE(file->read_into(std::span(read)).value() == 2);
+        REQUIRE(read[1] == 6);
+    }
+    SECTION("Positional reads and writes leave the cursor alone") {
+        auto temp = TempPath("engine_test_file_positional.bin");
+        auto file = fileio::File::open(temp.path, fileio::OpenMode::BINARY, fileio::IoMode::READ | fileio::IoMode::WRITE);
+        REQUIRE(file.has_value());
+        auto values = std::array<std::uint8_t, 8>{0, 1, 2, 3, 4, 5, 6, 7};
+        REQUIRE(file->write(std::span(values)).has_value());
+
+        // Still buffered by the stream, but flushed before the positional read
+        auto middle = std::array<std::uint8_t, 3>{};
+        REQUIRE(file->pread(2, std::span(middle)).value() == 3);
+        REQUIRE(middle == std::array<std::uint8_t, 3>{2, 3, 4});
+        REQUIRE(static_cast<std::uint64_t>(file->position().value()) == 8);
+
+        auto patch = std::array<std::uint8_t, 2>{40, 50};
+        REQUIRE(file->pwrite(4, std::span(patch)).has_value());
+        REQUIRE(static_cast<std::uint64_t>(file->position().value()) == 8);
+        REQUIRE(file->pread(6, std::span(middle)).value() == 2);
+
+        REQUIRE(file->move_to_start().has_value());
+        auto head  = std::array<std::byte, 3>{};
+        auto rest  = std::array<std::byte, 10>{};
+        auto parts = std::array<std::span<std::byte>, 2>{head, rest};
+        REQUIRE(file->readv(parts).value() == 8);
+        REQUIRE(head[2] == std::byte{2});
+        REQUIRE(rest[1] == std::byte{40});
+        REQUIRE(rest[2] == std::byte{50});
+    }
+    SECTION("Gathered writes land back to back") {
+        auto temp  = TempPath("engine_test_file_gather.bin");
+        auto first = std::array<std::byte, 2>{std::byte{1}, std::byte{2}};
+        auto last  = std::array<std::byte, 1>{std::byte{3}};
+        {
+            auto file  = fileio::File::open(temp.path, fileio::OpenMode::BINARY, fileio::IoMode::WRITE);
+            auto parts = std::array<std::span<const std::byte>, 2>{first, last};
+            REQUIRE(file.has_value());
+            REQUIRE(file->writev(parts).has_value());
+        }
+        auto mapped = fileio::File::map(temp.path);
+        REQUIRE(mapped.has_value());
+        REQUIRE(mapped->size() == 3);
+        REQUIRE(mapped->bytes()[2] == std::byte{3});
+    }
+    SECTION("Mapping a missing file is an open error") {
+        auto mapped = fileio::File::map(std::filesystem::temp_directory_path() / "engine_test_file_does_not_exist.bin");
+        REQUIRE(!mapped.has_value());
+        REQUIRE(mapped.error().error == fileio::error::Flag::OPEN);
+    }
+}
+
+TEST_CASE("AsyncReader", "[AsyncReader]") {
+    auto first  = TempPath("engine_test_async_first.bin");
+    auto second = TempPath("engine_test_async_second.bin");
+    auto words  = std::vector<std::uint32_t>(50'000);
+    std::iota(words.begin(), words.end(), 0u);
+    write_file(first.path, words);
+    write_file(second.path, std::vector<std::uint8_t>{1, 2, 3});
+
+    for (auto backend : {fileio::AsyncReader::Backend::AUTO, fileio::AsyncReader::Backend::THREAD_POOL}) {
+        auto reader = fileio::AsyncReader(backend, 8, 2);
+        REQUIRE(reader.backend() != fileio::AsyncReader::Backend::AUTO);
+
+        // More reads than the queue is deep, several sharing a file
+        constexpr std::size_t CHUNKS = 20;
+        constexpr std::size_t CHUNK  = 10'000;
+        auto chunks                  = std::vector<std::vector<std::byte>>(CHUNKS, std::vector<std::byte>(CHUNK));
+        auto tail                    = std::vector<std::byte>(16);
+        auto missing                 = std::vector<std::byte>(16);
+        auto callbacks               = std::atomic<std::size_t>(0);
+
+        auto batch = std::vector<fileio::ReadRequest>();
+        for (std::size_t i = 0; i < CHUNKS; i++) {
+            batch.push_back({first.path, i * CHUNK, chunks[i], [&callbacks](fileio::ReadResult) { callbacks++; }});
+        }
+        batch.push_back({second.path, 1, tail});
+        batch.push_back({std::filesystem::temp_directory_path() / "engine_test_file_does_not_exist.bin", 0, missing});
+
+        auto results = reader.submit(std::move(batch)).get();
+        REQUIRE(results.size() == CHUNKS + 2);
+        REQUIRE(callbacks == CHUNKS);
+        auto bytes = std::as_bytes(std::span(words));
+        for (std::size_t i = 0; i < CHUNKS; i++) {
+            REQUIRE(results[i].has_value());
+            REQUIRE(*results[i] == CHUNK);
+            REQUIRE(std::equal(chunks[i].begin(), chunks[i].end(), bytes.begin() + static_cast<std::ptrdiff_t>(i * CHUNK)));
+        }
+        // Reads past the end stop short
+        REQUIRE(results[CHUNKS].value() == 2);
+        REQUIRE(tail[1] == std::byte{3});
+        REQUIRE(!results[CHUNKS + 1].has_value());
+        REQUIRE(results[CHUNKS + 1].error().error == fileio::error::Flag::OPEN);
+
+        REQUIRE(reader.submit({}).get().empty());
+    }
+}
+
+TEST_CASE("Lz", "[Lz]") {
+    SECTION("Round trips") {
+        round_trip({});
+        round_trip(random_bytes(1, 1));
+        round_trip(random_bytes(13, 2));
+        round_trip(random_bytes(fileio::archive::BLOCK_SIZE, 3));
+        round_trip(compressible_bytes(fileio::archive::BLOCK_SIZE));
+        // Runs longer than a length nibble and matches overlapping what they copy
+        round_trip(std::vector<std::byte>(fileio::archive::BLOCK_SIZE, std::byte{0x41}));
+        auto pattern = std::vector<std::byte>();
+        for (int i = 0; i < 5'000; i++) {
+            pattern.push_back(static_cast<std::byte>(i % 3));
+        }
+        round_trip(pattern);
+    }
+    SECTION("Repetitive data shrinks and random data barely grows") {
+        auto text       = compressible_bytes(fileio::archive::BLOCK_SIZE);
+        auto compressed = std::vector<std::byte>(fileio::lz::compress_bound(text.size()));
+        REQUIRE(fileio::lz::compress(text, compressed) < text.size() / 2);
+
+        auto noise = random_bytes(fileio::archive::BLOCK_SIZE, 4);
+        REQUIRE(fileio::lz::compress(noise, compressed) <= fileio::lz::compress_bound(noise.size()));
+        // Too small a destination fails rather than writing past it
+        REQUIRE(fileio::lz::compress(noise, std::span(compressed).first(noise.size() / 2)) == 0);
+    }
+    SECTION("Malformed input is refused") {
+        auto text       = compressible_bytes(4'096);
+        auto compressed = std::vector<std::byte>(fileio::lz::compress_bound(text.size()));
+        compressed.resize(fileio::lz::compress(text, compressed));
+        auto output = std::vector<std::byte>(text.size());
+
+        // Cut short partway through
+        REQUIRE(!fileio::lz::decompress(std::span(compressed).first(compressed.size() / 2), output).has_value());
+        // Decoding into too small a buffer
+        REQUIRE(!fileio::lz::decompress(compressed, std::span(output).first(text.size() - 1)).has_value());
+        // A match reaching back before the start of the output
+        auto bad_offset = std::vector<std::byte>{std::byte{0x10}, std::byte{'a'}, std::byte{0x05}, std::byte{0x00}, std::byte{0x00}};
+        REQUIRE(!fileio::lz::decompress(bad_offset, output).has_value());
+        // An offset of zero
+        auto zero_offset = std::vector<std::byte>{std::byte{0x10}, std::byte{'a'}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}};
+        REQUIRE(!fileio::lz::decompress(zero_offset, output).has_value());
+    }
+}
+
+TEST_CASE("Archive", "[Archive]") {
+    auto root    = TempPath("engine_test_archive_assets");
+    auto packed  = TempPath("engine_test_archive.pak");
+    auto patched = TempPath("engine_test_archive_patch.pak");
+    std::filesystem::remove_all(root.path);
+    std::filesystem::create_directories(root.path / "shaders" / "game");
+    auto shader = root.path / "shaders" / "game" / "tilemap.spv";
+    auto words  = std::vector<std::uint32_t>(1'000);
+    std::iota(words.begin(), words.end(), 7u);
+    write_file(shader, words);
+    for (int i = 0; i < 50; i++) {
+        auto contents = std::vector<std::uint8_t>(static_cast<std::size_t>(i), std::uint8_t(i));
+        write_file(root.path / ("texture_" + std::to_string(i) + ".bin"), contents);
+    }
+
+    auto writer = fileio::ArchiveWriter();
+    REQUIRE(writer.add_directory(root.path).has_value());
+    REQUIRE(writer.size() == 51);
+    REQUIRE(writer.write(packed.path).has_value());
+
+    SECTION("Every packed file is found, in place and page aligned") {
+        auto archive = fileio::Archive::open(packed.path);
+        REQUIRE(archive.has_value());
+        REQUIRE(archive->size() == 51);
+
+        auto blob = archive->find(shader);
+        REQUIRE(blob.has_value());
+        REQUIRE(blob->compression == fileio::archive::Compression::NONE);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(blob->stored.data()) % fileio::archive::BLOB_ALIGNMENT == 0);
+        REQUIRE(blob->size == words.size() * sizeof(std::uint32_t));
+        REQUIRE(std::ranges::equal(blob->stored, std::as_bytes(std::span(words))));
+
+        // Unnormalised spellings of the same path find the same entry
+        REQUIRE(archive->find(root.path / "shaders" / "." / "game" / ".." / "game" / "tilemap.spv").has_value());
+        for (int i = 0; i < 50; i++) {
+            auto texture = archive->find(root.path / ("texture_" + std::to_string(i) + ".bin"));
+            REQUIRE(texture.has_value());
+            REQUIRE(texture->size == static_cast<std::size_t>(i));
+            REQUIRE(std::ranges::all_of(texture->stored, [i](std::byte b) { return b == std::byte(i); }));
+        }
+        REQUIRE(!archive->find(root.path / "missing.bin").has_value());
+    }
+    SECTION("Files that are not archives are refused") {
+        REQUIRE(fileio::Archive::open(shader).error().error == fileio::error::Flag::INVALID_ARCHIVE);
+
+        // Cut short, so the tables run off the end
+        auto truncated = TempPath("engine_test_archive_truncated.pak");
+        auto mapped    = fileio::File::map(packed.path);
+        auto head      = std::vector<std::byte>(mapped->bytes().begin(), mapped->bytes().begin() + 100);
+        write_file(truncated.path, head);
+        REQUIRE(fileio::Archive::open(truncated.path).error().error == fileio::error::Flag::INVALID_ARCHIVE);
+    }
+    SECTION("A failed write leaves neither the archive nor its temporary file behind") {
+        auto broken = TempPath("engine_test_archive_broken.pak");
+        auto failed = fileio::ArchiveWriter();
+        failed.add_file("present.spv", shader);
+        failed.add_file("missing.spv", root.path / "missing.spv");
+        REQUIRE(!failed.write(broken.path).has_value());
+        REQUIRE(!std::filesystem::exists(broken.path));
+        REQUIRE(!std::filesystem::exists(broken.path.string() + ".partial"));
+    }
+    SECTION("The file system prefers the newest archive, then loose files") {
+        auto patch = fileio::ArchiveWriter();
+        patch.add_file(shader, root.path / "texture_3.bin");
+        REQUIRE(patch.write(patched.path).has_value());
+
+        auto files = fileio::VirtualFileSystem();
+        auto loose = files.open(shader);
+        REQUIRE(loose.has_value());
+        REQUIRE(!loose->from_archive());
+        REQUIRE(loose->view<std::uint32_t>()[0] == 7);
+
+        REQUIRE(files.mount(packed.path).has_value());
+        REQUIRE(files.mount(patched.path).has_value());
+        REQUIRE(files.archive_count() == 2);
+
+        auto patched_shader = files.open(shader);
+        REQUIRE(patched_shader.has_value());
+        REQUIRE(patched_shader->from_archive());
+        REQUIRE(patched_shader->size() == 3);
+        REQUIRE(patched_shader->metadata.path == shader);
+
+        auto texture = files.open(root.path / "texture_9.bin");
+        REQUIRE(texture.has_value());
+        REQUIRE(texture->from_archive());
+        REQUIRE(texture->size() == 9);
+
+        // Not in any archive, so it comes from disk
+        write_file(root.path / "added.bin", std::vector<std::uint8_t>{1});
+        REQUIRE(files.exists(root.path / "added.bin"));
+        REQUIRE(!files.open(root.path / "added.bin")->from_archive());
+        REQUIRE(!files.exists(root.path / "missing.bin"));
+        REQUIRE(!files.mount(shader).has_value());
+    }
+    SECTION("Compressed archives decode to the original files") {
+        // Several blocks with a partial one at the end, one that will not shrink, and ones too small to bother with
+        auto text  = compressible_bytes(5 * fileio::archive::BLOCK_SIZE + 1'234);
+        auto noise = random_bytes(3 * fileio::archive::BLOCK_SIZE, 5);
+        write_file(root.path / "shader.glsl", text);
+        write_file(root.path / "noise.bin", noise);
+
+        auto compressed = fileio::ArchiveWriter(fileio::archive::Compression::LZ);
+        REQUIRE(compressed.add_directory(root.path).has_value());
+        REQUIRE(compressed.write(patched.path).has_value());
+
+        auto archive = fileio::Archive::open(patched.path);
+        REQUIRE(archive.has_value());
+        auto text_blob = archive->find(root.path / "shader.glsl");
+        REQUIRE(text_blob.has_value());
+        REQUIRE(text_blob->compression == fileio::archive::Compression::LZ);
+        REQUIRE(text_blob->size == text.size());
+        REQUIRE(text_blob->stored.size() < text.size() / 2);
+        REQUIRE(archive->find(root.path / "noise.bin")->compression == fileio::archive::Compression::NONE);
+
+        auto decoded = std::vector<std::byte>(text.size());
+        REQUIRE(fileio::archive::unpack(*text_blob, decoded));
+        REQUIRE(decoded == text);
+        // Wrong sized destinations and damaged block tables are caught
+        REQUIRE(!fileio::archive::unpack(*text_blob, std::span(decoded).first(text.size() - 1)));
+        auto damaged   = std::vector<std::byte>(text_blob->stored.begin(), text_blob->stored.end());
+        damaged[0]     = damaged[0] ^ std::byte{1};
+        auto bad_table = fileio::archive::Blob{.stored = damaged, .size = text_blob->size, .compression = text_blob->compression};
+        REQUIRE(!fileio::archive::unpack(bad_table, decoded));
+
+        auto jobs  = JobSystem(2);
+        auto files = fileio::VirtualFileSystem(&jobs);
+        REQUIRE(files.mount(patched.path).has_value());
+        auto shader_source = files.open(root.path / "shader.glsl");
+        REQUIRE(shader_source.has_value());
+        REQUIRE(shader_source->from_archive());
+        REQUIRE(std::ranges::equal(shader_source->bytes(), text));
+        auto moved = std::move(shader_source.value());
+        REQUIRE(std::ranges::equal(moved.bytes(), text));
+        REQUIRE(std::ranges::equal(files.open(root.path / "noise.bin")->bytes(), noise));
+        REQUIRE(files.open(shader)->view<std::uint32_t>()[999] == 1'006);
+        for (int i = 0; i < 50; i++) {
+            REQUIRE(files.open(root.path / ("texture_" + std::to_string(i) + ".bin"))->size() == static_cast<std::size_t>(i));
+        }
+    }
+    std::filesystem::remove_all(root.path);
+}
+
+TEST_CASE("FileWatcher", "[FileWatcher]") {
+    auto root = TempPath("engine_test_watcher");
+    std::filesystem::remove_all(root.path);
+    std::filesystem::create_directories(root.path);
+    auto watched   = root.path / "watched.bin";
+    auto unwatched = root.path / "unwatched.bin";
+    write_file(watched, std::vector<std::uint8_t>{1});
+    write_file(unwatched, std::vector<std::uint8_t>{1});
+
+    // Declared before the watcher so they outlive its thread
+    auto mutex    = std::mutex();
+    auto reported = std::vector<std::filesystem::path>();
+    auto batches  = std::atomic<int>(0);
+
+    auto watcher = fileio::FileWatcher(std::chrono::milliseconds(10));
+    if (!watcher.available()) {
+        SKIP("inotify is not available here");
+    }
+    auto id = watcher.subscribe([&](std::span<const std::filesystem::path> paths) {
+        auto lock = std::scoped_lock(mutex);
+        reported.insert(reported.end(), paths.begin(), paths.end());
+        batches++;
+    });
+
+    auto metadata = fileio::File::map(watched)->metadata;
+    REQUIRE(!metadata.dirty());
+    REQUIRE(watcher.track(metadata).has_value());
+    auto copy = metadata;
+    REQUIRE(!copy.dirty());
+
+    auto wait_for = [](auto condition) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return condition();
+    };
+
+    SECTION("Writes to tracked files mark them dirty and are reported once per batch") {
+        write_file(unwatched, std::vector<std::uint8_t>{2});
+        write_file(watched, std::vector<std::uint8_t>{2});
+        write_file(watched, std::vector<std::uint8_t>{3});
+        REQUIRE(wait_for([&] { return metadata.dirty(); }));
+        REQUIRE(copy.dirty());
+        REQUIRE(wait_for([&] { return batches.load() == 1; }));
+        {
+            auto lock = std::scoped_lock(mutex);
+            REQUIRE(reported == std::vector{watched});
+        }
+
+        // Tracking again after a reload starts clean
+        auto reloaded = fileio::File::map(watched)->metadata;
+        REQUIRE(watcher.track(reloaded).has_value());
+        REQUIRE(!reloaded.dirty());
+        REQUIRE(metadata.dirty());
+    }
+    SECTION("Replacing a file by renaming over it counts as a change") {
+        auto replacement = root.path / "watched.bin.tmp";
+        write_file(replacement, std::vector<std::uint8_t>{4});
+        std::filesystem::rename(replacement, watched);
+        REQUIRE(wait_for([&] { return metadata.dirty(); }));
+    }
+    SECTION("Unsubscribed callbacks are not called") {
+        watcher.unsubscribe(id);
+        std::filesystem::remove(watched);
+        REQUIRE(wait_for([&] { return metadata.dirty(); }));
+        REQUIRE(batches.load() == 0);
+    }
+    SECTION("Tracking a file in a missing directory fails") {
+        auto missing = fileio::FileMetadata{};
+        missing.path = root.path / "missing" / "file.bin";
+        REQUIRE(!watcher.track(missing).has_value());
+    }
+    std::filesystem::remove_all(root.path);
+}
+
+TEST_CASE("Content hash", "[ContentHash]") {
+    SECTION("Pinned values, since hashes name files on disk and must never drift") {
+        REQUIRE(fileio::content_hash(std::string_view("")) == 0x93228a4de0eec5a2ull);
+        REQUIRE(fileio::content_hash(std::string_view("abc")) == 0x989b4a209c1011c9ull);
+        REQUIRE(fileio::content_hash(std::string_view("assets/shaders/game/tilemap/tilemap.spv")) == 0x22470911c784a86dull);
+        REQUIRE(fileio::content_hash(std::string_view("abc"), 1) == 0x4518df1b278ce8d2ull);
+    }
+    SECTION("Every length and every single bit flip hashes differently") {
+        auto bytes  = random_bytes(300, 6);
+        auto hashes = std::set<std::uint64_t>();
+        for (std::size_t length = 0; length <= bytes.size(); length++) {
+            hashes.insert(fileio::content_hash(std::span(bytes).first(length)));
+        }
+        REQUIRE(hashes.size() == bytes.size() + 1);
+
+        auto original = fileio::content_hash(bytes);
+        for (std::size_t bit = 0; bit < bytes.size() * 8; bit++) {
+            bytes[bit / 8] ^= std::byte{1} << (bit % 8);
+            REQUIRE(fileio::content_hash(bytes) != original);
+            bytes[bit / 8] ^= std::byte{1} << (bit % 8);
+        }
+        REQUIRE(fileio::content_hash(bytes) == original);
+        REQUIRE(fileio::content_hash(bytes, 1) != original);
+    }
+}
+
+TEST_CASE("ArtifactCache", "[ArtifactCache]") {
+    auto root = TempPath("engine_test_artifacts");
+    std::filesystem::remove_all(root.path);
+    auto cache = fileio::ArtifactCache(root.path / "cache");
+
+    auto source     = compressible_bytes(10'000);
+    auto parameters = std::array<std::uint32_t, 2>{4, 1};
+    auto key        = fileio::ArtifactCache::key("mipmaps-1", source, std::as_bytes(std::span(parameters)));
+    auto processed  = 0;
+    auto process    = [&] {
+        processed++;
+        return std::vector<std::uint32_t>(source.size() / 4, 0xabcdu);
+    };
+
+    SECTION("A miss processes and stores, then the artifact is reused") {
+        REQUIRE(!cache.find(key).has_value());
+        auto first = cache.get_or_process(key, process);
+        REQUIRE(first.has_value());
+        REQUIRE(processed == 1);
+        REQUIRE(first->view<std::uint32_t>().size() == source.size() / 4);
+        REQUIRE(first->view<std::uint32_t>()[7] == 0xabcdu);
+
+        auto second = cache.get_or_process(key, process);
+        REQUIRE(second.has_value());
+        REQUIRE(processed == 1);
+        REQUIRE(std::ranges::equal(second->bytes(), first->bytes()));
+        // No temporary files are left behind
+        REQUIRE(std::distance(std::filesystem::directory_iterator(cache.directory()), std::filesystem::directory_iterator()) == 1);
+    }
+    SECTION("Keys change with the source, the parameters and the processor, and nothing else") {
+        REQUIRE(fileio::ArtifactCache::key("mipmaps-1", source, std::as_bytes(std::span(parameters))) == key);
+
+        auto edited = source;
+        edited[5'000] ^= std::byte{1};
+        auto other_parameters = std::array<std::uint32_t, 2>{4, 2};
+        auto keys             = std::set<std::string>{
+            key.file_name(),
+            fileio::ArtifactCache::key("mipmaps-1", edited, std::as_bytes(std::span(parameters))).file_name(),
+            fileio::ArtifactCache::key("mipmaps-1", source, std::as_bytes(std::span(other_parameters))).file_name(),
+            fileio::ArtifactCache::key("mipmaps-2", source, std::as_bytes(std::span(parameters))).file_name(),
+            // Flattened to the same name prefix, but still a different key
+            fileio::ArtifactCache::key("mipmaps/1", source, std::as_bytes(std::span(parameters))).file_name(),
+            fileio::ArtifactCache::key("mipmaps_1", source, std::as_bytes(std::span(parameters))).file_name(),
+        };
+        REQUIRE(keys.size() == 6);
+        REQUIRE(fileio::ArtifactCache::key("../../escape", source).file_name().starts_with("______escape-"));
+
+        REQUIRE(cache.store(key, std::as_bytes(std::span(source))).has_value());
+        REQUIRE(!cache.find(fileio::ArtifactCache::key("mipmaps-1", edited, std::as_bytes(std::span(parameters)))).has_value());
+        REQUIRE(cache.find(key).has_value());
+    }
+    SECTION("Storing again replaces the artifact") {
+        REQUIRE(cache.store(key, std::as_bytes(std::span(source))).has_value());
+        REQUIRE(cache.store(key, std::as_bytes(std::span(source)).first(10)).has_value());
+        REQUIRE(cache.find(key)->size() == 10);
+    }
+    std::filesystem::remove_all(root.path);
+}
+
+TEST_CASE("StreamReader", "[StreamReader]") {
+    auto temp     = TempPath("engine_test_stream.bin");
+    auto contents = random_bytes(1'000'000, 7);
+    write_file(temp.path, contents);
+
+    auto read_all = [](fileio::StreamReader& reader, std::size_t chunk_size) {
+        auto read = std::vector<std::byte>();
+        while (true) {
+            auto chunk = reader.next();
+            REQUIRE(chunk.has_value());
+            if (chunk->empty()) {
+                break;
+            }
+            REQUIRE(reader.offset() == read.size());
+            REQUIRE(chunk->size() <= chunk_size);
+            read.insert(read.end(), chunk->begin(), chunk->end());
+        }
+        return read;
+    };
+
+    SECTION("Chunks cover the whole file in order, for any chunk size") {
+        // Whole pages, odd sizes, and chunks just under, exactly at and beyond the file size
+        for (std::size_t chunk_size : std::array<std::size_t, 5>{4'096, 1'000, 999'999, 1'000'000, 4'000'000}) {
+            auto reader = fileio::StreamReader::open(temp.path, chunk_size);
+            REQUIRE(reader.has_value());
+            REQUIRE(reader->size() == contents.size());
+            REQUIRE(read_all(*reader, chunk_size) == contents);
+            // Stays at the end once there
+            REQUIRE(reader->next()->empty());
+        }
+    }
+    SECTION("Empty and missing files") {
+        auto empty = TempPath("engine_test_stream_empty.bin");
+        write_file(empty.path, std::vector<std::byte>{});
+        auto reader = fileio::StreamReader::open(empty.path);
+        REQUIRE(reader.has_value());
+        REQUIRE(reader->next()->empty());
+
+        REQUIRE(!fileio::StreamReader::open(temp.path.string() + ".missing").has_value());
+    }
+    SECTION("Readers can be moved and abandoned partway through") {
+        auto reader = fileio::StreamReader::open(temp.path, 4'096);
+        REQUIRE(reader.has_value());
+        auto first = reader->next();
+        REQUIRE(first.has_value());
+        REQUIRE(std::ranges::equal(*first, std::span(contents).first(4'096)));
+
+        auto moved  = std::move(reader.value());
+        auto second = moved.next();
+        REQUIRE(second.has_value());
+        REQUIRE(std::ranges::equal(*second, std::span(contents).subspan(4'096, 4'096)));
+        REQUIRE(moved.offset() == 4'096);
+        REQUIRE(reader->next()->empty());
+
+        moved = fileio::StreamReader::open(temp.path, 100).value();
+        REQUIRE(std::ranges::equal(*moved.next(), std::span(contents).first(100)));
+    }
+}
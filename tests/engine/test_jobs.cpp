@@ -0,0 +1,210 @@
+#include <engine/jobs/deque.h>
+#include <engine/jobs/job_system.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+TEST_CASE("Work-stealing deque", "[Jobs]") {
+    SECTION("Owner pops newest, thieves steal oldest") {
+        auto deque  = jobs::WorkStealingDeque<int>(8);
+        int values[] = {0, 1, 2, 3};
+        for (auto& value : values) {
+            REQUIRE(deque.push(&value));
+        }
+        REQUIRE(deque.size() == 4);
+        REQUIRE(deque.pop() == &values[3]);
+        REQUIRE(deque.steal() == &values[0]);
+        REQUIRE(deque.pop() == &values[2]);
+        REQUIRE(deque.pop() == &values[1]);
+        REQUIRE(deque.pop() == nullptr);
+        REQUIRE(deque.steal() == nullptr);
+    }
+    SECTION("Push fails once full") {
+        auto deque = jobs::WorkStealingDeque<int>(4);
+        int value  = 0;
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(deque.push(&value));
+        }
+        REQUIRE(!deque.push(&value));
+        REQUIRE(deque.steal() == &value);
+        REQUIRE(deque.push(&value));
+    }
+    SECTION("Every item is taken exactly once under contention") {
+        constexpr int COUNT = 100'000;
+        auto values         = std::vector<int>(COUNT);
+        auto taken          = std::vector<std::atomic<int>>(COUNT);
+        auto deque          = jobs::WorkStealingDeque<int>(1024);
+        auto done           = std::atomic<bool>(false);
+
+        auto take = [&](int* item) {
+            taken[static_cast<std::size_t>(item - values.data())].fetch_add(1);
+        };
+        auto thieves = std::vector<std::thread>();
+        for (int i = 0; i < 3; i++) {
+            thieves.emplace_back([&] {
+                while (!done.load()) {
+                    if (auto* item = deque.steal()) {
+                        take(item);
+                    }
+                }
+            });
+        }
+        for (auto& value : values) {
+            while (!deque.push(&value)) {
+                if (auto* item = deque.pop()) {
+                    take(item);
+                }
+            }
+        }
+        while (auto* item = deque.pop()) {
+            take(item);
+        }
+        done.store(true);
+        for (auto& thief : thieves) {
+            thief.join();
+        }
+        REQUIRE(std::all_of(taken.begin(), taken.end(), [](const auto& count) { return count.load() == 1; }));
+    }
+}
+
+TEST_CASE("Job system", "[Jobs]") {
+    SECTION("Scheduled jobs all run before wait returns") {
+        auto system  = JobSystem(4);
+        auto counter = jobs::Counter();
+        auto ran     = std::atomic<int>(0);
+        for (int i = 0; i < 1'000; i++) {
+            system.schedule([&] { ran.fetch_add(1); }, &counter);
+        }
+        system.wait(counter);
+        REQUIRE(counter.done());
+        REQUIRE(ran.load() == 1'000);
+    }
+    SECTION("Waiting runs jobs when there are no workers") {
+        auto system  = JobSystem(0);
+        auto counter = jobs::Counter();
+        auto ran     = 0;
+        system.schedule([&] { ran++; }, &counter);
+        REQUIRE(!counter.done());
+        system.wait(counter);
+        REQUIRE(ran == 1);
+    }
+    SECTION("Dependent jobs run after their dependency") {
+        auto system = JobSystem(4);
+        auto first  = jobs::Counter();
+        auto second = jobs::Counter();
+        auto stage  = std::atomic<int>(0);
+        auto order  = std::atomic<bool>(true);
+        for (int i = 0; i < 64; i++) {
+            system.schedule(
+                [&] {
+                    std::this_thread::yield();
+                    stage.fetch_add(1);
+                },
+                &first);
+        }
+        for (int i = 0; i < 64; i++) {
+            system.schedule_after(
+                first,
+                [&] {
+                    if (stage.load() < 64) {
+                        order.store(false);
+                    }
+                    stage.fetch_add(1);
+                },
+                &second);
+        }
+        system.wait(second);
+        REQUIRE(order.load());
+        REQUIRE(stage.load() == 128);
+    }
+    SECTION("Continuations of a finished counter run immediately") {
+        auto system     = JobSystem(2);
+        auto finished   = jobs::Counter();
+        auto dependents = jobs::Counter();
+        auto ran        = std::atomic<bool>(false);
+        system.schedule_after(finished, [&] { ran.store(true); }, &dependents);
+        system.wait(dependents);
+        REQUIRE(ran.load());
+    }
+    SECTION("Jobs may schedule and wait on sub-jobs") {
+        auto system  = JobSystem(4);
+        auto counter = jobs::Counter();
+        auto ran     = std::atomic<int>(0);
+        for (int i = 0; i < 16; i++) {
+            system.schedule(
+                [&] {
+                    auto inner = jobs::Counter();
+                    for (int j = 0; j < 16; j++) {
+                        system.schedule([&] { ran.fetch_add(1); }, &inner);
+                    }
+                    system.wait(inner);
+                },
+                &counter);
+        }
+        system.wait(counter);
+        REQUIRE(ran.load() == 256);
+    }
+    SECTION("Main thread jobs only run on the main thread") {
+        auto system      = JobSystem(4);
+        auto main_thread = std::this_thread::get_id();
+        auto counter     = jobs::Counter();
+        auto elsewhere   = std::atomic<int>(0);
+        auto ran         = std::atomic<int>(0);
+
+        for (int i = 0; i < 32; i++) {
+            system.schedule(
+                [&] {
+                    system.schedule_main(
+                        [&] {
+                            if (std::this_thread::get_id() != main_thread) {
+                                elsewhere.fetch_add(1);
+                            }
+                            ran.fetch_add(1);
+                        },
+                        &counter);
+                },
+                &counter);
+        }
+        system.wait(counter);
+        REQUIRE(ran.load() == 32);
+        REQUIRE(elsewhere.load() == 0);
+
+        auto deferred = jobs::Counter();
+        auto pumped   = false;
+        system.schedule_main([&] { pumped = true; }, &deferred);
+        REQUIRE(!pumped);
+        system.run_main_thread_jobs();
+        REQUIRE(pumped);
+        REQUIRE(deferred.done());
+    }
+    SECTION("Parallel for covers the range exactly once") {
+        auto system = JobSystem(4);
+        auto hits   = std::vector<std::atomic<int>>(10'007);
+        system.parallel_for(0, hits.size(), 64, [&](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; i++) {
+                hits[i].fetch_add(1);
+            }
+        });
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](const auto& count) { return count.load() == 1; }));
+
+        auto nested = std::atomic<std::uint64_t>(0);
+        system.parallel_for(0, 32, 1, [&](std::size_t, std::size_t) {
+            system.parallel_for(0, 1'000, 100, [&](std::size_t first, std::size_t last) {
+                auto sum = std::uint64_t(0);
+                for (auto i = first; i < last; i++) {
+                    sum += i;
+                }
+                nested.fetch_add(sum);
+            });
+        });
+        REQUIRE(nested.load() == 32ull * (999ull * 1'000ull / 2));
+    }
+}
@@ -0,0 +1,313 @@
+#include <engine/logger.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    auto read_all(std::FILE* file) -> std::string {
+        std::fflush(file);
+        std::rewind(file);
+        auto text = std::string();
+        for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+            text.push_back(static_cast<char>(c));
+        }
+        return text;
+    }
+
+    auto count_lines(std::FILE* file) -> std::size_t {
+        std::fflush(file);
+        std::rewind(file);
+        std::size_t lines = 0;
+        for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+            lines += c == '\n' ? 1 : 0;
+        }
+        return lines;
+    }
+} // namespace
+
+TEST_CASE("Logger", "[Logger]") {
+    SECTION("Entries from every thread are written in index order, each thread's in call order") {
+        auto* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        {
+            auto sink = logger::Sink();
+            constexpr int THREADS = 4;
+            constexpr int PER     = 2'000;
+            auto log              = LoggerBuilder()
+                           .with_identifier("TEST")
+                           .with_stream({file, logger::Level::DEBUG})
+                           .with_history(THREADS * PER, THREADS * PER * 32)
+                           .build(sink);
+
+            auto threads          = std::vector<std::thread>();
+            for (int t = 0; t < THREADS; t++) {
+                threads.emplace_back([&log, t] {
+                    for (int i = 0; i < PER; i++) {
+                        log.info("thread {} line {}", t, i);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            sink.flush();
+
+            REQUIRE(count_lines(file) == THREADS * PER);
+            auto entries = log.last_entries(THREADS * PER);
+            REQUIRE(entries.size() == THREADS * PER);
+            auto next       = std::vector<int>(THREADS, 0);
+            auto ordered    = true;
+            auto by_index   = true;
+            auto next_index = std::uint64_t{0};
+            for (const auto& entry : entries) {
+                int thread = 0;
+                int line   = 0;
+                REQUIRE(std::sscanf(std::string(entry.message).c_str(), "thread %d line %d", &thread, &line) == 2);
+                ordered    = ordered && line == next[static_cast<std::size_t>(thread)]++;
+                by_index   = by_index && entry.index >= next_index;
+                next_index = entry.index + 1;
+            }
+            REQUIRE(ordered);
+            REQUIRE(by_index);
+            REQUIRE(entries.back().owner == "TEST");
+        }
+        std::fclose(file);
+    }
+    SECTION("Streams only receive entries at or above their level") {
+        auto* verbose = std::tmpfile();
+        auto* quiet   = std::tmpfile();
+        {
+            auto sink = logger::Sink();
+            auto log  = LoggerBuilder()
+                           .with_identifier("TEST")
+                           .with_stream({verbose, logger::Level::DEBUG})
+                           .with_stream({quiet, logger::Level::WARNING})
+                           .build(sink);
+            log.debug("debug");
+            log.info("info");
+            log.warning("warning");
+            log.error("error");
+            sink.flush();
+
+            REQUIRE(count_lines(verbose) == 4);
+            REQUIRE(count_lines(quiet) == 2);
+            REQUIRE(log.last_entries_of(4, logger::Level::WARNING).size() == 2);
+        }
+        std::fclose(verbose);
+        std::fclose(quiet);
+    }
+    SECTION("Dropping loses entries only when a ring is full, and counts them") {
+        auto* file = std::tmpfile();
+        {
+            auto sink = logger::Sink(logger::OverflowPolicy::DROP, 2);
+            auto log  = LoggerBuilder().with_identifier("TEST").with_stream({file, logger::Level::DEBUG}).build(sink);
+            for (int i = 0; i < 10'000; i++) {
+                log.info("line {}", i);
+            }
+            sink.flush();
+            REQUIRE(count_lines(file) + sink.dropped() == 10'000);
+        }
+        std::fclose(file);
+    }
+    SECTION("Logging after the sink stops is written immediately") {
+        auto* file = std::tmpfile();
+        {
+            auto sink = logger::Sink();
+            auto log  = LoggerBuilder().with_identifier("TEST").with_stream({file, logger::Level::DEBUG}).build(sink);
+            log.info("before");
+            sink.stop();
+            REQUIRE(count_lines(file) == 1);
+            log.info("after");
+            REQUIRE(count_lines(file) == 2);
+        }
+        std::fclose(file);
+    }
+    SECTION("Deferred arguments format the same as eager ones") {
+        auto sink     = logger::Sink();
+        auto log      = LoggerBuilder().with_identifier("TEST").build(sink);
+        auto text     = std::string("string");
+        char array[]  = "array";
+        const auto* c = "pointer";
+        log.info("{} {:>4} {:.3f} {} {} {} {} {} {:x} {}", -3, 7u, 0.5f, 1.25, true, 'c', text, std::string_view(text), 255, array);
+        log.info("{} {}", c, std::uint8_t(200));
+        // Too long to defer, so formatted on the calling thread
+        log.info("{}", std::string(logger::DEFERRED_ARGS_CAPACITY * 2, 'x'));
+        sink.flush();
+
+        auto entries = log.last_entries(3);
+        REQUIRE(entries.size() == 3);
+        auto entry = entries.begin();
+        REQUIRE((*entry++).message == fmt::format("{} {:>4} {:.3f} {} {} {} {} {} {:x} {}", -3, 7u, 0.5f, 1.25, true, 'c', text, text, 255, array));
+        REQUIRE((*entry++).message == "pointer 200");
+        REQUIRE((*entry++).message == std::string(logger::DEFERRED_ARGS_CAPACITY * 2, 'x'));
+    }
+    SECTION("Null string pointers are deferred as (null)") {
+        auto sink          = logger::Sink();
+        auto log           = LoggerBuilder().with_identifier("TEST").build(sink);
+        const char* absent = nullptr;
+        log.info("[{}]", absent);
+        sink.flush();
+
+        auto entries = log.last_entries(1);
+        REQUIRE(entries.size() == 1);
+        REQUIRE(entries.front().message == "[(null)]");
+    }
+    SECTION("Binary logs decode to the same lines as the text streams") {
+        auto* text   = std::tmpfile();
+        auto* binary = std::tmpfile();
+        auto* decode = std::tmpfile();
+        {
+            auto sink  = logger::Sink();
+            auto log   = LoggerBuilder().with_identifier("TEST").with_stream({text, logger::Level::DEBUG}).build(sink);
+            auto other = LoggerBuilder().with_identifier("OTHER").with_stream({text, logger::Level::DEBUG}).build(sink);
+            sink.write_binary_to(binary);
+            for (int i = 0; i < 100; i++) {
+                log.info("line {} of {:.2f}", i, 100.0);
+                other.warning("{}", std::string(200, 'y'));
+            }
+            sink.flush();
+            sink.write_binary_to(nullptr);
+        }
+        std::rewind(binary);
+        auto decoded = logger::binary::decode(binary, decode);
+        REQUIRE(decoded.has_value());
+        REQUIRE(*decoded == 200);
+        REQUIRE(read_all(decode) == read_all(text));
+
+        auto* garbage = std::tmpfile();
+        std::fputs("not a log", garbage);
+        std::rewind(garbage);
+        REQUIRE(!logger::binary::decode(garbage, decode).has_value());
+
+        std::fclose(garbage);
+        std::fclose(decode);
+        std::fclose(binary);
+        std::fclose(text);
+    }
+    SECTION("History keeps only the newest entries that fit") {
+        auto sink = logger::Sink();
+        auto log  = LoggerBuilder().with_identifier("TEST").with_history(8, 64).build(sink);
+        for (int i = 0; i < 100; i++) {
+            log.info("{}", i);
+        }
+        sink.flush();
+        {
+            auto entries = log.last_entries(100);
+            REQUIRE(entries.size() == 8);
+            REQUIRE(entries.front().message == "92");
+            REQUIRE(entries.back().message == "99");
+            auto expected = 92;
+            for (const auto& entry : entries) {
+                REQUIRE(entry.message == std::to_string(expected++));
+            }
+        }
+
+        // Long messages push out as many short ones as they need room from, and are cut to the arena's size
+        log.info("{}", std::string(40, 'a'));
+        log.info("{}", std::string(100, 'b'));
+        sink.flush();
+        auto entries = log.last_entries(100);
+        REQUIRE(entries.size() == 1);
+        REQUIRE(entries.front().message == std::string(64, 'b'));
+    }
+    SECTION("Empty messages never keep text that is about to be overwritten from being evicted") {
+        auto sink    = logger::Sink();
+        auto log     = LoggerBuilder().with_identifier("TEST").with_history(64, 100).build(sink);
+        auto logged  = std::vector<std::string>();
+        auto lengths = std::vector<std::size_t>{60, 0, 30, 60, 20, 0, 0, 45, 99, 0, 10, 70, 0, 0, 33, 50, 0, 100, 0, 1};
+        auto fill    = 'a';
+        for (int round = 0; round < 3; round++) {
+            for (auto length : lengths) {
+                logged.emplace_back(length, fill);
+                fill = fill == 'z' ? 'a' : static_cast<char>(fill + 1);
+                log.info("{}", logged.back());
+                sink.flush();
+
+                auto entries = log.last_entries(logged.size());
+                REQUIRE(!entries.empty());
+                REQUIRE(entries.back().index == logged.size() - 1);
+                for (const auto& entry : entries) {
+                    REQUIRE(entry.message == logged[entry.index]);
+                }
+            }
+        }
+    }
+    SECTION("Filtered views only walk matching entries") {
+        auto sink = logger::Sink();
+        auto log  = LoggerBuilder().with_identifier("TEST").build(sink);
+        for (int i = 0; i < 10; i++) {
+            log.error("error {}", i);
+            log.debug("debug {}", i);
+        }
+        sink.flush();
+        auto errors = log.last_entries_of(3, logger::Level::ERROR);
+        REQUIRE(errors.size() == 3);
+        auto expected = 7;
+        for (const auto& entry : errors) {
+            REQUIRE(entry.level == logger::Level::ERROR);
+            REQUIRE(entry.message == fmt::format("error {}", expected++));
+        }
+        REQUIRE(expected == 10);
+        REQUIRE(log.last_entries(0).empty());
+    }
+    SECTION("Entries more verbose than the logger's level are dropped before they are recorded") {
+        auto* file = std::tmpfile();
+        {
+            auto sink = logger::Sink();
+            auto log  = LoggerBuilder()
+                           .with_identifier("TEST")
+                           .with_stream({file, logger::Level::WARNING})
+                           .with_stream({file, logger::Level::INFO})
+                           .build(sink);
+            REQUIRE(log.enabled(logger::Level::WARNING));
+            REQUIRE(!log.enabled(logger::Level::ERROR));
+            REQUIRE(!log.enabled(logger::Level::DEBUG));
+
+            log.debug("debug");
+            log.error("error");
+            log.info("info");
+            log.set_level(logger::Level::DEBUG);
+            log.debug("debug");
+            sink.flush();
+            REQUIRE(log.last_entries(4).size() == 2);
+            REQUIRE(log.last_entries(4).back().message == "debug");
+        }
+        std::fclose(file);
+    }
+    SECTION("Following a history only sees each entry once") {
+        auto sink = logger::Sink();
+        auto log  = LoggerBuilder().with_identifier("TEST").with_history(4, 256).build(sink);
+        log.info("first");
+        log.info("second");
+        sink.flush();
+
+        auto seen = std::uint64_t{0};
+        {
+            auto view = log.entries_since(seen);
+            REQUIRE(view.size() == 2);
+            REQUIRE(view.front().message == "first");
+            seen = view.end_sequence();
+            REQUIRE(view.at(view.begin().sequence())->message == "first");
+        }
+        for (int i = 0; i < 5; i++) {
+            log.info("later {}", i);
+        }
+        sink.flush();
+
+        auto view = log.entries_since(seen);
+        // Only four entries fit, so the first later one is already gone
+        REQUIRE(view.size() == 4);
+        REQUIRE(view.front().message == "later 1");
+        REQUIRE(view.back().message == "later 4");
+        REQUIRE(!view.at(0).has_value());
+        REQUIRE(!view.at(view.end_sequence()).has_value());
+    }
+}
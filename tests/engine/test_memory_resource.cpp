@@ -0,0 +1,125 @@
+#include <engine/pool/memory_resource.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+TEST_CASE("NodeResource::allocate", "[NodeResource]") {
+    SECTION("Single") {
+        auto resource = pool::NodeResource<32>();
+        auto* ptr     = resource.allocate(16, 8);
+
+        REQUIRE(ptr != nullptr);
+        REQUIRE(resource.statistics().allocations == 1);
+        REQUIRE(resource.statistics().upstream_allocations == 0);
+        REQUIRE(resource.statistics().bytes_in_use == 16);
+        REQUIRE(resource.capacity() == 512);
+
+        resource.deallocate(ptr, 16, 8);
+        REQUIRE(resource.statistics().deallocations == 1);
+        REQUIRE(resource.statistics().bytes_in_use == 0);
+        REQUIRE(resource.statistics().peak_bytes_in_use == 16);
+    }
+    SECTION("Alignment") {
+        auto resource = pool::NodeResource<24, 64>();
+        for (auto i = 0; i < 16; i++) {
+            auto* ptr = resource.allocate(24, 64);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % 64 == 0);
+        }
+    }
+    SECTION("Reuse") {
+        auto resource = pool::NodeResource<32>();
+        auto* first   = resource.allocate(32, 8);
+        resource.deallocate(first, 32, 8);
+        auto* second = resource.allocate(32, 8);
+
+        REQUIRE(first == second);
+        REQUIRE(resource.capacity() == 512);
+    }
+    SECTION("Grow") {
+        auto resource = pool::NodeResource<8, 8, 4>();
+        auto pointers = std::vector<void*>();
+        for (auto i = 0; i < 4; i++) {
+            pointers.push_back(resource.allocate(8, 8));
+        }
+        REQUIRE(resource.capacity() == 4);
+
+        pointers.push_back(resource.allocate(8, 8));
+        REQUIRE(resource.capacity() == 12);
+        REQUIRE(resource.statistics().bytes_reserved == 12 * sizeof(pool::NodeResource<8, 8, 4>::NodeType));
+
+        // Growing must not move the earlier nodes
+        for (auto i = 0; i < 5; i++) {
+            *static_cast<std::uint64_t*>(pointers[i]) = i;
+        }
+        for (auto i = 0; i < 5; i++) {
+            REQUIRE(*static_cast<std::uint64_t*>(pointers[i]) == static_cast<std::uint64_t>(i));
+        }
+        for (auto* ptr : pointers) {
+            resource.deallocate(ptr, 8, 8);
+        }
+        REQUIRE(resource.statistics().bytes_in_use == 0);
+    }
+    SECTION("Upstream") {
+        auto resource = pool::NodeResource<16>();
+        auto* big     = resource.allocate(1024, 8);
+        auto* aligned = resource.allocate(16, 256);
+
+        REQUIRE(resource.statistics().upstream_allocations == 2);
+        REQUIRE(resource.statistics().bytes_in_use == 0);
+        REQUIRE(resource.capacity() == 0);
+
+        resource.deallocate(big, 1024, 8);
+        resource.deallocate(aligned, 16, 256);
+        REQUIRE(resource.statistics().upstream_deallocations == 2);
+    }
+}
+
+TEST_CASE("NodeResource::is_equal", "[NodeResource]") {
+    auto a = pool::NodeResource<16>();
+    auto b = pool::NodeResource<16>();
+
+    REQUIRE(a.is_equal(a));
+    REQUIRE_FALSE(a.is_equal(b));
+}
+
+TEST_CASE("NodeResource::containers", "[NodeResource]") {
+    SECTION("pmr::list") {
+        auto resource = pool::NodeResource<64>();
+        auto list     = std::pmr::list<int>(&resource);
+        for (auto i = 0; i < 1000; i++) {
+            list.push_back(i);
+        }
+
+        REQUIRE(list.size() == 1000);
+        REQUIRE(resource.statistics().upstream_allocations == 0);
+        REQUIRE(resource.statistics().allocations == 1000);
+
+        auto expected = 0;
+        for (auto value : list) {
+            REQUIRE(value == expected++);
+        }
+
+        list.clear();
+        REQUIRE(resource.statistics().bytes_in_use == 0);
+    }
+}
+
+TEST_CASE("PoolResource::allocate", "[PoolResource]") {
+    SECTION("Typed") {
+        auto resource  = pool::PoolResource<std::uint64_t>();
+        auto allocator = std::pmr::polymorphic_allocator<std::uint64_t>(&resource);
+        auto* value    = allocator.allocate(1);
+        *value         = 42;
+
+        REQUIRE(*value == 42);
+        REQUIRE(resource.node_size() == sizeof(std::uint64_t));
+        allocator.deallocate(value, 1);
+        REQUIRE(resource.statistics().deallocations == 1);
+    }
+}
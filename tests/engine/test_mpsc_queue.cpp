@@ -0,0 +1,87 @@
+#include <engine/mpsc_queue.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+TEST_CASE("MpscQueue", "[MpscQueue]") {
+    SECTION("Items come out in push order") {
+        auto queue = MpscQueue<int>(4);
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(queue.try_push(int(i)));
+        }
+        REQUIRE(queue.size() == 4);
+        for (int i = 0; i < 4; i++) {
+            auto value = queue.try_pop();
+            REQUIRE(value.has_value());
+            REQUIRE(*value == i);
+        }
+        REQUIRE(!queue.try_pop().has_value());
+        REQUIRE(queue.size() == 0);
+    }
+    SECTION("Full queue rejects pushes without consuming the value") {
+        auto queue = MpscQueue<std::unique_ptr<int>>(3);
+        REQUIRE(queue.capacity() == 4);
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(queue.try_push(std::make_unique<int>(i)));
+        }
+        auto rejected = std::make_unique<int>(4);
+        REQUIRE(!queue.try_push(std::move(rejected)));
+        REQUIRE(rejected);
+
+        REQUIRE(*queue.try_pop().value() == 0);
+        REQUIRE(queue.try_push(std::move(rejected)));
+        for (int i = 1; i <= 4; i++) {
+            REQUIRE(*queue.try_pop().value() == i);
+        }
+    }
+    SECTION("Items left in the queue are destroyed with it") {
+        auto tracked = std::make_shared<int>(0);
+        {
+            auto queue = MpscQueue<std::shared_ptr<int>>(8);
+            queue.push(std::shared_ptr<int>(tracked));
+            queue.push(std::shared_ptr<int>(tracked));
+            REQUIRE(tracked.use_count() == 3);
+        }
+        REQUIRE(tracked.use_count() == 1);
+    }
+    SECTION("Every item from every producer arrives once") {
+        constexpr int PRODUCERS = 4;
+        constexpr int PER       = 50'000;
+        auto queue              = MpscQueue<int>(64);
+        auto seen               = std::vector<int>(PRODUCERS * PER);
+        auto last               = std::vector<int>(PRODUCERS, -1);
+        auto ordered            = true;
+
+        auto producers = std::vector<std::thread>();
+        for (int p = 0; p < PRODUCERS; p++) {
+            producers.emplace_back([&queue, p] {
+                for (int i = 0; i < PER; i++) {
+                    queue.push(p * PER + i);
+                }
+            });
+        }
+        for (int received = 0; received < PRODUCERS * PER;) {
+            if (auto value = queue.try_pop()) {
+                auto producer = static_cast<std::size_t>(*value / PER);
+                auto index    = *value % PER;
+                // Each producer's items keep their relative order
+                ordered        = ordered && index > last[producer];
+                last[producer] = index;
+                seen[static_cast<std::size_t>(*value)]++;
+                received++;
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        REQUIRE(ordered);
+        REQUIRE(std::all_of(seen.begin(), seen.end(), [](int count) { return count == 1; }));
+        REQUIRE(!queue.try_pop().has_value());
+    }
+}
@@ -163,3 +163,37 @@ TEST_CASE("Pool::free", "[Pool]") {
         }
     }
 }
+
+TEST_CASE("Pool::pin", "[Pool]") {
+    SECTION("single") {
+        auto pool   = Pool<int>();
+        auto obj    = pool.allocate(66);
+        auto pinned = pool.pin(obj);
+
+        REQUIRE(pinned.has_value());
+        REQUIRE(*pinned.value() == 66);
+    }
+    SECTION("from borrow") {
+        auto pool   = Pool<int>();
+        auto obj    = pool.allocate(66);
+        auto pinned = obj.pin();
+
+        REQUIRE(pinned.has_value());
+        REQUIRE(pinned->get() == obj.get().value());
+    }
+    SECTION("writes through") {
+        auto pool   = Pool<int>();
+        auto obj    = pool.allocate(66);
+        auto pinned = obj.pin().value();
+        *pinned     = 67;
+
+        REQUIRE(static_cast<int>(obj) == 67);
+    }
+    SECTION("freed") {
+        auto pool = Pool<int>();
+        auto obj  = pool.allocate(66);
+        pool.free(obj);
+
+        REQUIRE_FALSE(pool.pin(obj).has_value());
+    }
+}
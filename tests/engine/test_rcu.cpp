@@ -0,0 +1,85 @@
+#include <engine/rcu.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+namespace {
+    struct Tracked {
+            Tracked(std::atomic<int>& alive) : alive(&alive) {
+                alive.fetch_add(1);
+            }
+            Tracked(const Tracked& other) : alive(other.alive), value(other.value) {
+                alive->fetch_add(1);
+            }
+            ~Tracked() {
+                alive->fetch_sub(1);
+            }
+
+            std::atomic<int>* alive;
+            int value = 0;
+    };
+} // namespace
+
+TEST_CASE("Rcu", "[Rcu]") {
+    SECTION("Snapshots are isolated from updates") {
+        auto rcu    = Rcu<std::vector<int>>();
+        auto before = rcu.read();
+        rcu.update([](std::vector<int>& values) { values.push_back(1); });
+        auto after = rcu.read();
+
+        REQUIRE(before->empty());
+        REQUIRE(after->size() == 1);
+        REQUIRE(after->front() == 1);
+
+        rcu.publish({2, 3});
+        REQUIRE(after->size() == 1);
+        REQUIRE(rcu.read()->size() == 2);
+    }
+    SECTION("Old versions are reclaimed with their last snapshot") {
+        auto alive = std::atomic<int>(0);
+        {
+            auto rcu      = Rcu<Tracked>(Tracked(alive));
+            auto snapshot = rcu.read();
+            rcu.update([](Tracked& tracked) { tracked.value = 1; });
+            REQUIRE(alive.load() == 2);
+            REQUIRE(snapshot->value == 0);
+
+            snapshot.reset();
+            REQUIRE(alive.load() == 1);
+            REQUIRE(rcu.read()->value == 1);
+        }
+        REQUIRE(alive.load() == 0);
+    }
+    SECTION("Readers see whole versions while a writer publishes") {
+        auto rcu     = Rcu<std::vector<int>>();
+        auto running = std::atomic<bool>(true);
+        auto torn    = std::atomic<int>(0);
+
+        auto readers = std::vector<std::thread>();
+        for (int i = 0; i < 4; i++) {
+            readers.emplace_back([&] {
+                while (running.load()) {
+                    auto snapshot = rcu.read();
+                    for (std::size_t idx = 0; idx < snapshot->size(); idx++) {
+                        if ((*snapshot)[idx] != static_cast<int>(snapshot->size())) {
+                            torn.fetch_add(1);
+                        }
+                    }
+                }
+            });
+        }
+        for (int version = 1; version <= 2'000; version++) {
+            rcu.update([version](std::vector<int>& values) { values.assign(static_cast<std::size_t>(version % 64), version % 64); });
+        }
+        running.store(false);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        REQUIRE(torn.load() == 0);
+    }
+}
@@ -436,6 +436,35 @@ TEST_CASE("Pool::Region::free", "[Pool][Region]") {
         region.free(Index(2));
         REQUIRE(region.do_axioms_hold_());
     }
+    SECTION("Join two runs") {
+        auto region = Region<TestType>(10);
+        region.emplace(Index(0));
+        region.emplace(Index(1));
+        region.emplace(Index(2));
+        region.emplace(Index(3));
+        region.emplace(Index(4));
+
+        region.free(Index(0));
+        region.free(Index(1));
+        region.free(Index(2));
+        region.free(Index(3));
+        region.free(Index(4));
+        REQUIRE(region.do_axioms_hold_());
+        REQUIRE(region.get_free_index() == Index(0));
+    }
+    SECTION("Join two single runs") {
+        auto region = Region<TestType>(10);
+        region.emplace(Index(0));
+        region.emplace(Index(1));
+        region.emplace(Index(2));
+        region.emplace(Index(3));
+
+        region.free(Index(1));
+        region.free(Index(3));
+        region.free(Index(2));
+        REQUIRE(region.do_axioms_hold_());
+        REQUIRE(region.get(Index(0)) != nullptr);
+    }
 }
 
 TEST_CASE("Pool::Region::reserve", "[Pool][Region]") {
@@ -0,0 +1,136 @@
+#include <engine/rwlock.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace ::ENGINE_NS;
+
+TEST_CASE("RwMutex", "[RwLock]") {
+    SECTION("Exclusive lock blocks everything") {
+        auto mutex = RwMutex();
+        mutex.lock();
+        REQUIRE(!mutex.try_lock());
+        REQUIRE(!mutex.try_lock_shared());
+        mutex.unlock();
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+    SECTION("Shared locks coexist") {
+        auto mutex = RwMutex();
+        mutex.lock_shared();
+        REQUIRE(mutex.try_lock_shared());
+        REQUIRE(!mutex.try_lock());
+        mutex.unlock_shared();
+        REQUIRE(!mutex.try_lock());
+        mutex.unlock_shared();
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+    SECTION("Waiting writer blocks new readers") {
+        auto mutex = RwMutex();
+        mutex.lock_shared();
+
+        auto writer_done = std::atomic<bool>(false);
+        auto writer      = std::thread([&] {
+            mutex.lock();
+            writer_done.store(true);
+            mutex.unlock();
+        });
+
+        // Wait for the writer to queue up behind our shared hold
+        while (mutex.try_lock_shared()) {
+            mutex.unlock_shared();
+            std::this_thread::yield();
+        }
+        REQUIRE(!writer_done.load());
+
+        mutex.unlock_shared();
+        writer.join();
+        REQUIRE(writer_done.load());
+        REQUIRE(mutex.try_lock_shared());
+        mutex.unlock_shared();
+    }
+}
+
+TEST_CASE("RwLock guards", "[RwLock]") {
+    SECTION("Default constructed guards are safe to drop") {
+        auto read  = RwData<int>();
+        auto write = RwDataMut<int>();
+        read.drop();
+        write.drop();
+    }
+    SECTION("Write guard releases on drop") {
+        auto lock = RwLock<int>(1);
+        {
+            auto guard  = lock.write();
+            guard.get() = 2;
+            guard.drop();
+            guard.drop();
+        }
+        REQUIRE(lock.read().get() == 2);
+    }
+    SECTION("Moved guards release once") {
+        auto lock  = RwLock<int>(1);
+        auto guard = lock.write();
+        auto moved = std::move(guard);
+        guard.drop();
+        moved.get() = 3;
+
+        auto assigned = RwDataMut<int>();
+        assigned      = std::move(moved);
+        assigned.drop();
+        REQUIRE(lock.read().get() == 3);
+    }
+    SECTION("Copied read guards hold their own share") {
+        auto lock = RwLock<int>(4);
+        auto copy = RwData<int>();
+        {
+            auto guard = lock.read();
+            copy       = guard;
+        }
+        REQUIRE(copy.get() == 4);
+        copy.drop();
+        auto write  = lock.write();
+        write.get() = 5;
+    }
+}
+
+TEST_CASE("RwLock contention", "[RwLock]") {
+    constexpr int THREADS    = 8;
+    constexpr int ITERATIONS = 20'000;
+
+    struct Pair {
+            std::uint64_t a = 0;
+            std::uint64_t b = 0;
+    };
+    auto lock       = RwLock<Pair>();
+    auto torn_reads = std::atomic<int>(0);
+    auto threads    = std::vector<std::thread>();
+    for (int thread = 0; thread < THREADS; thread++) {
+        threads.emplace_back([&, thread] {
+            for (int i = 0; i < ITERATIONS; i++) {
+                if ((i + thread) % 4 == 0) {
+                    auto guard = lock.write();
+                    guard.get().a += 1;
+                    guard.get().b += 1;
+                } else {
+                    auto guard = lock.read();
+                    if (guard.get().a != guard.get().b) {
+                        torn_reads.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(torn_reads.load() == 0);
+    REQUIRE(lock.read().get().a == THREADS * ITERATIONS / 4);
+    REQUIRE(lock.read().get().b == THREADS * ITERATIONS / 4);
+}
@@ -0,0 +1,42 @@
+#include <engine/fileio/archive.h>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <string_view>
+
+// usage: asset_packer [--compress] <output archive> <directory or file>...
+// Inputs are stored under the paths they are given by, so run it from the directory the game runs from, e.g.
+//     asset_packer --compress assets.pak assets
+int main(int argc, char** argv) {
+    auto compression = ENGINE_NS::fileio::archive::Compression::NONE;
+    int output       = 1;
+    if (argc > 1 && std::string_view(argv[1]) == "--compress") {
+        compression = ENGINE_NS::fileio::archive::Compression::LZ;
+        output++;
+    }
+    if (argc - output < 2) {
+        fmt::print(stderr, "usage: {} [--compress] <output archive> <directory or file>...\n", argc > 0 ? argv[0] : "asset_packer");
+        return 1;
+    }
+
+    auto writer = ENGINE_NS::fileio::ArchiveWriter(compression);
+    for (int i = output + 1; i < argc; i++) {
+        auto input = std::filesystem::path(argv[i]);
+        if (std::filesystem::is_directory(input)) {
+            if (auto err = writer.add_directory(input); !err) {
+                fmt::print(stderr, "Cannot read {}: {}\n", argv[i], err.error().reason);
+                return 1;
+            }
+        } else {
+            writer.add_file(input, input);
+        }
+    }
+
+    if (auto err = writer.write(argv[output]); !err) {
+        fmt::print(stderr, "Cannot write {}: {}\n", argv[output], err.error().reason);
+        return 1;
+    }
+    fmt::print(stderr, "Packed {} files into {}\n", writer.size(), argv[output]);
+    return 0;
+}
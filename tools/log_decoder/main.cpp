@@ -0,0 +1,38 @@
+#include <engine/log_format.h>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+
+// usage: log_decoder <binary log> [output file]
+// Writes to stdout when no output file is given
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fmt::print(stderr, "usage: {} <binary log> [output file]\n", argc > 0 ? argv[0] : "log_decoder");
+        return 1;
+    }
+
+    auto* input = std::fopen(argv[1], "rb");
+    if (input == nullptr) {
+        fmt::print(stderr, "Cannot open {}\n", argv[1]);
+        return 1;
+    }
+    auto* output = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+    if (output == nullptr) {
+        fmt::print(stderr, "Cannot open {}\n", argv[2]);
+        std::fclose(input);
+        return 1;
+    }
+
+    auto decoded = ENGINE_NS::logger::binary::decode(input, output);
+    std::fclose(input);
+    if (output != stdout) {
+        std::fclose(output);
+    }
+    if (!decoded) {
+        fmt::print(stderr, "{}\n", decoded.error());
+        return 1;
+    }
+    fmt::print(stderr, "Decoded {} entries\n", *decoded);
+    return 0;
+}